@@ -0,0 +1,350 @@
+///////////////////////////////////////////////////////////////////////////////
+// allocationcheck.cpp
+// ============
+// count the heap allocations made while the scene is rendered, which a warm
+// frame should not make at all
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "AllocationCheck.h"
+#include "SceneManager.h"
+#include "ViewManager.h"
+#include "RenderState.h"
+
+#include <GL/glew.h>
+
+#include <glm/gtx/transform.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+
+#if defined(_WIN32)
+#include <malloc.h>
+#endif
+
+// declare the global variables
+namespace
+{
+	// frames of one turn around the scene, the first turn
+	// warms up and the second one is counted
+	const int g_OrbitFrames = 120;
+
+	// set while the allocations are counted, and the count -
+	// both are constant initialized, so they are ready before
+	// the first allocation of the program
+	std::atomic<bool> g_bCounting(false);
+	std::atomic<int> g_AllocationCount(0);
+
+#ifdef __cpp_aligned_new
+	/***********************************************************
+	 *  AllocateAligned()
+	 *
+	 *  A block with the passed in alignment from the C runtime,
+	 *  which has its own aligned allocator on Windows.
+	 ***********************************************************/
+	void* AllocateAligned(std::size_t size, std::size_t alignment)
+	{
+#if defined(_WIN32)
+		return(_aligned_malloc(size, alignment));
+#else
+		// aligned_alloc() takes whole multiples of the alignment
+		return(std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment));
+#endif
+	}
+
+	/***********************************************************
+	 *  FreeAligned()
+	 *
+	 *  Frees a block from AllocateAligned().
+	 ***********************************************************/
+	void FreeAligned(void* pMemory)
+	{
+#if defined(_WIN32)
+		_aligned_free(pMemory);
+#else
+		std::free(pMemory);
+#endif
+	}
+#endif
+
+	/***********************************************************
+	 *  CountedAllocate()
+	 *
+	 *  Counts an allocation while a check is running and takes
+	 *  the memory, with the default alignment when the passed
+	 *  in one is 0.  As long as there is no memory the
+	 *  new_handler is called to free some, NULL is returned
+	 *  when there is no handler.
+	 ***********************************************************/
+	void* CountedAllocate(std::size_t size, std::size_t alignment)
+	{
+		if (g_bCounting.load(std::memory_order_relaxed) == true)
+		{
+			g_AllocationCount.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		size = (size > 0) ? size : 1;
+		for (;;)
+		{
+#ifdef __cpp_aligned_new
+			void* pMemory = (alignment == 0) ? std::malloc(size) : AllocateAligned(size, alignment);
+#else
+			void* pMemory = std::malloc(size);
+#endif
+			if (pMemory != NULL)
+			{
+				return(pMemory);
+			}
+
+			std::new_handler handler = std::get_new_handler();
+			if (handler == NULL)
+			{
+				return(NULL);
+			}
+			handler();
+		}
+	}
+
+	// what the counted frames of one mode did
+	struct MODE_RESULT
+	{
+		int allocations = 0;
+		int allocatingFrames = 0;
+		int mostPerFrame = 0;
+		size_t arenaBytes = 0;
+	};
+
+	/***********************************************************
+	 *  MeasureMode()
+	 *
+	 *  Turns the camera around the scene twice, with or without
+	 *  the pre-pass, and counts the heap allocations of every
+	 *  frame of the second turn.
+	 ***********************************************************/
+	MODE_RESULT MeasureMode(SceneManager* pSceneManager, ViewManager* pViewManager, RenderState* pRenderState, bool bPrepass)
+	{
+		MODE_RESULT result;
+
+		pSceneManager->SetDepthPrepass(bPrepass);
+		pViewManager->PrepareSceneView();
+		const glm::mat4 startView = pViewManager->GetViewMatrix();
+		const glm::mat4 projection = pViewManager->GetProjectionMatrix();
+
+		for (int frame = 0; frame < 2 * g_OrbitFrames; frame++)
+		{
+			const bool bCounted = (frame >= g_OrbitFrames);
+			const float angle = glm::radians(360.0f) * (float)(frame % g_OrbitFrames) / (float)g_OrbitFrames;
+			const glm::mat4 view = startView * glm::rotate(angle, glm::vec3(0.0f, 1.0f, 0.0f));
+			const glm::vec3 viewPosition = glm::vec3(glm::inverse(view)[3]);
+
+			pRenderState->SetDepthTest(true);
+			pRenderState->SetClearColor(glm::vec4(0.0f, 0.0f, 0.0f, 1.0f));
+			glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+			g_AllocationCount.store(0);
+			g_bCounting.store(bCounted);
+			pViewManager->SetViewUniforms(view, projection, viewPosition);
+			pSceneManager->SetViewProjection(view, projection);
+			pSceneManager->RenderScene();
+			g_bCounting.store(false);
+
+			if (bCounted == true)
+			{
+				const int allocations = g_AllocationCount.load();
+				result.allocations += allocations;
+				result.allocatingFrames += (allocations > 0) ? 1 : 0;
+				result.mostPerFrame = std::max(result.mostPerFrame, allocations);
+				result.arenaBytes = std::max(result.arenaBytes, pSceneManager->GetFrameArena().GetUsedBytes());
+			}
+		}
+
+		pSceneManager->SetDepthPrepass(false);
+
+		return(result);
+	}
+}
+
+/***********************************************************
+ *  operator new / operator delete
+ *
+ *  The global allocation functions of the program, which
+ *  count the allocations while a check is running.  The
+ *  whole set is replaced, the plain, array, nothrow and
+ *  over-aligned forms, so no allocation goes around the
+ *  count.  The over-aligned forms only exist when the
+ *  compiler has aligned new, without it over-aligned types
+ *  take the plain forms.  Nothing else changes - the memory
+ *  comes from malloc(), or the aligned allocator of the C
+ *  runtime, and the new_handler is called before an
+ *  allocation fails, as without them.
+ ***********************************************************/
+void* operator new(std::size_t size)
+{
+	void* pMemory = CountedAllocate(size, 0);
+	if (pMemory == NULL)
+	{
+		throw std::bad_alloc();
+	}
+
+	return(pMemory);
+}
+
+void* operator new[](std::size_t size)
+{
+	return(operator new(size));
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+	try
+	{
+		return(CountedAllocate(size, 0));
+	}
+	catch (...)
+	{
+		return(NULL);
+	}
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t& tag) noexcept
+{
+	return(operator new(size, tag));
+}
+
+#ifdef __cpp_aligned_new
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+	void* pMemory = CountedAllocate(size, (std::size_t)alignment);
+	if (pMemory == NULL)
+	{
+		throw std::bad_alloc();
+	}
+
+	return(pMemory);
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment)
+{
+	return(operator new(size, alignment));
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+	try
+	{
+		return(CountedAllocate(size, (std::size_t)alignment));
+	}
+	catch (...)
+	{
+		return(NULL);
+	}
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t& tag) noexcept
+{
+	return(operator new(size, alignment, tag));
+}
+#endif
+
+void operator delete(void* pMemory) noexcept
+{
+	std::free(pMemory);
+}
+
+void operator delete[](void* pMemory) noexcept
+{
+	std::free(pMemory);
+}
+
+void operator delete(void* pMemory, std::size_t) noexcept
+{
+	std::free(pMemory);
+}
+
+void operator delete[](void* pMemory, std::size_t) noexcept
+{
+	std::free(pMemory);
+}
+
+void operator delete(void* pMemory, const std::nothrow_t&) noexcept
+{
+	std::free(pMemory);
+}
+
+void operator delete[](void* pMemory, const std::nothrow_t&) noexcept
+{
+	std::free(pMemory);
+}
+
+#ifdef __cpp_aligned_new
+void operator delete(void* pMemory, std::align_val_t) noexcept
+{
+	FreeAligned(pMemory);
+}
+
+void operator delete[](void* pMemory, std::align_val_t) noexcept
+{
+	FreeAligned(pMemory);
+}
+
+void operator delete(void* pMemory, std::size_t, std::align_val_t) noexcept
+{
+	FreeAligned(pMemory);
+}
+
+void operator delete[](void* pMemory, std::size_t, std::align_val_t) noexcept
+{
+	FreeAligned(pMemory);
+}
+
+void operator delete(void* pMemory, std::align_val_t, const std::nothrow_t&) noexcept
+{
+	FreeAligned(pMemory);
+}
+
+void operator delete[](void* pMemory, std::align_val_t, const std::nothrow_t&) noexcept
+{
+	FreeAligned(pMemory);
+}
+#endif
+
+/***********************************************************
+ *  RunAllocationCheck()
+ *
+ *  Renders the prepared scene while the camera turns around
+ *  it, without and with the depth pre-pass, and counts the
+ *  heap allocations made on any thread during the frames of
+ *  the second turn.  By then the frame arena and the lists
+ *  kept between frames have seen every view, so a frame
+ *  that still allocates has transient data on the heap.
+ ***********************************************************/
+bool RunAllocationCheck(SceneManager* pSceneManager, ViewManager* pViewManager, RenderState* pRenderState)
+{
+	const int startGrowCount = pSceneManager->GetFrameArena().GetGrowCount();
+
+	std::cout << "mode          frames  allocations  allocating frames  most per frame  arena bytes" << std::endl;
+
+	bool bPassed = true;
+	const char* names[] = { "no pre-pass", "pre-pass" };
+	for (int mode = 0; mode < 2; mode++)
+	{
+		const MODE_RESULT result = MeasureMode(pSceneManager, pViewManager, pRenderState, mode == 1);
+		bPassed = bPassed && (result.allocations == 0);
+
+		std::cout << std::left << std::setw(12) << names[mode] << std::right << "  "
+			<< std::setw(6) << g_OrbitFrames << "  "
+			<< std::setw(11) << result.allocations << "  "
+			<< std::setw(17) << result.allocatingFrames << "  "
+			<< std::setw(14) << result.mostPerFrame << "  "
+			<< std::setw(11) << result.arenaBytes << std::endl;
+	}
+
+	std::cout << "frame arena grew " << pSceneManager->GetFrameArena().GetGrowCount() - startGrowCount << " times" << std::endl;
+	std::cout << ((bPassed == true) ? "Steady-state frames made no heap allocations" : "Steady-state frames made heap allocations") << std::endl;
+
+	return(bPassed);
+}
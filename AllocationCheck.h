@@ -0,0 +1,19 @@
+///////////////////////////////////////////////////////////////////////////////
+// allocationcheck.h
+// ============
+// count the heap allocations made while the scene is rendered, which a warm
+// frame should not make at all
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+class SceneManager;
+class ViewManager;
+class RenderState;
+
+// render the prepared scene around an orbit and print the
+// heap allocations of the frames once every view was seen,
+// started with the --allocation-check command line argument -
+// returns false when a frame allocated
+bool RunAllocationCheck(SceneManager* pSceneManager, ViewManager* pViewManager, RenderState* pRenderState);
@@ -0,0 +1,233 @@
+///////////////////////////////////////////////////////////////////////////////
+// bvhbenchmark.cpp
+// ============
+// compare the cost of brute-force and BVH scene queries as the object
+// count grows
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "BVHBenchmark.h"
+#include "FrustumCuller.h"
+#include "SceneBVH.h"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <cfloat>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+// declare the global variables
+namespace
+{
+	// scene sizes the queries are timed at
+	const int g_ObjectCounts[] = { 256, 1024, 4096, 16384, 65536 };
+	// queries of each kind timed per scene size
+	const int g_FrustumQueries = 64;
+	const int g_PointQueries = 1024;
+	// every object occupies about this much room, so the
+	// scenes grow in size and not in density
+	const float g_RoomPerObject = 8.0f;
+
+	typedef std::chrono::high_resolution_clock BENCH_CLOCK;
+
+	/***********************************************************
+	 *  MicrosecondsSince()
+	 *
+	 *  Microseconds passed since the passed in time.
+	 ***********************************************************/
+	double MicrosecondsSince(const BENCH_CLOCK::time_point& start)
+	{
+		return(std::chrono::duration<double, std::micro>(BENCH_CLOCK::now() - start).count());
+	}
+
+	/***********************************************************
+	 *  RandomDirection()
+	 *
+	 *  A random unit vector.
+	 ***********************************************************/
+	glm::vec3 RandomDirection(std::mt19937& random)
+	{
+		std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+		glm::vec3 direction;
+		do
+		{
+			direction = glm::vec3(unit(random), unit(random), unit(random));
+		} while ((glm::length(direction) < 0.1f) || (glm::length(direction) > 1.0f));
+
+		return(glm::normalize(direction));
+	}
+}
+
+/***********************************************************
+ *  RunBVHBenchmark()
+ *
+ *  Builds random scenes of growing size and times frustum
+ *  culling, ray and nearest-object queries done by testing
+ *  every object and by walking the BVH.  The brute-force
+ *  frustum test is the SIMD FrustumCuller.  Both sides of
+ *  every query are checked to agree.
+ ***********************************************************/
+void RunBVHBenchmark()
+{
+	std::mt19937 random(330);
+
+	std::cout << "objects  build(us)  nodes  | frustum brute/bvh (us)  | ray brute/bvh (us)  | nearest brute/bvh (us)  | mismatches" << std::endl;
+
+	for (int objectCount : g_ObjectCounts)
+	{
+		const float halfSize = 0.5f * std::cbrt(objectCount * g_RoomPerObject);
+		std::uniform_real_distribution<float> position(-halfSize, halfSize);
+		std::uniform_real_distribution<float> size(0.1f, 1.5f);
+
+		std::vector<glm::vec3> boundsMin(objectCount);
+		std::vector<glm::vec3> boundsMax(objectCount);
+		std::vector<int> primitives(objectCount);
+		FrustumCuller culler;
+		SceneBVH hierarchy;
+		culler.Resize(objectCount);
+		hierarchy.Resize(objectCount);
+
+		for (int i = 0; i < objectCount; i++)
+		{
+			glm::vec3 center(position(random), position(random), position(random));
+			glm::vec3 extents(size(random), size(random), size(random));
+			boundsMin[i] = center - extents;
+			boundsMax[i] = center + extents;
+			primitives[i] = i;
+			culler.SetBounds(i, center, extents);
+			hierarchy.SetBounds(i, boundsMin[i], boundsMax[i]);
+		}
+
+		BENCH_CLOCK::time_point start = BENCH_CLOCK::now();
+		hierarchy.Build(primitives);
+		double buildTime = MicrosecondsSince(start);
+
+		// cameras inside the scene looking in random directions
+		std::vector<glm::mat4> cameras;
+		const glm::mat4 projection = glm::perspective(glm::radians(45.0f), 16.0f / 9.0f, 0.1f, 100.0f);
+		for (int i = 0; i < g_FrustumQueries; i++)
+		{
+			glm::vec3 eye(position(random), position(random), position(random));
+			cameras.push_back(projection * glm::lookAt(eye, eye + RandomDirection(random), glm::vec3(0.0f, 1.0f, 0.0f)));
+		}
+
+		int mismatches = 0;
+		std::vector<uint8_t> bruteVisible(objectCount);
+
+		start = BENCH_CLOCK::now();
+		for (const glm::mat4& camera : cameras)
+		{
+			culler.Cull(camera);
+		}
+		double bruteFrustumTime = MicrosecondsSince(start) / g_FrustumQueries;
+
+		for (const glm::mat4& camera : cameras)
+		{
+			culler.Cull(camera);
+			for (int i = 0; i < objectCount; i++)
+			{
+				bruteVisible[i] = culler.IsVisible(i) ? 1 : 0;
+			}
+			culler.Cull(camera, hierarchy, objectCount);
+			for (int i = 0; i < objectCount; i++)
+			{
+				mismatches += (bruteVisible[i] != (culler.IsVisible(i) ? 1 : 0)) ? 1 : 0;
+			}
+		}
+
+		start = BENCH_CLOCK::now();
+		for (const glm::mat4& camera : cameras)
+		{
+			culler.Cull(camera, hierarchy, objectCount);
+		}
+		double bvhFrustumTime = MicrosecondsSince(start) / g_FrustumQueries;
+
+		// rays and points spread over the scene
+		std::vector<glm::vec3> origins;
+		std::vector<glm::vec3> directions;
+		for (int i = 0; i < g_PointQueries; i++)
+		{
+			origins.push_back(glm::vec3(position(random), position(random), position(random)));
+			directions.push_back(RandomDirection(random));
+		}
+
+		std::vector<int> bruteHits(g_PointQueries);
+		std::vector<float> bruteHitDistance(g_PointQueries);
+		start = BENCH_CLOCK::now();
+		for (int q = 0; q < g_PointQueries; q++)
+		{
+			const glm::vec3 inverseDirection(1.0f / directions[q].x, 1.0f / directions[q].y, 1.0f / directions[q].z);
+			float hitDistance = FLT_MAX;
+			bruteHits[q] = -1;
+			for (int i = 0; i < objectCount; i++)
+			{
+				float distance = SceneBVH::IntersectRay(origins[q], inverseDirection, boundsMin[i], boundsMax[i], hitDistance);
+				if ((distance >= 0.0f) && ((bruteHits[q] < 0) || (distance < hitDistance)))
+				{
+					hitDistance = distance;
+					bruteHits[q] = i;
+				}
+			}
+			bruteHitDistance[q] = hitDistance;
+		}
+		double bruteRayTime = MicrosecondsSince(start) / g_PointQueries;
+
+		std::vector<int> bvhHits(g_PointQueries);
+		std::vector<float> bvhHitDistance(g_PointQueries);
+		start = BENCH_CLOCK::now();
+		for (int q = 0; q < g_PointQueries; q++)
+		{
+			bvhHits[q] = hierarchy.Raycast(origins[q], directions[q], FLT_MAX, bvhHitDistance[q]);
+		}
+		double bvhRayTime = MicrosecondsSince(start) / g_PointQueries;
+
+		std::vector<int> bruteNearest(g_PointQueries);
+		std::vector<float> bruteNearestDistance(g_PointQueries);
+		start = BENCH_CLOCK::now();
+		for (int q = 0; q < g_PointQueries; q++)
+		{
+			float nearestSquared = FLT_MAX;
+			bruteNearest[q] = -1;
+			for (int i = 0; i < objectCount; i++)
+			{
+				float distanceSquared = SceneBVH::DistanceSquared(origins[q], boundsMin[i], boundsMax[i]);
+				if (distanceSquared < nearestSquared)
+				{
+					nearestSquared = distanceSquared;
+					bruteNearest[q] = i;
+				}
+			}
+			bruteNearestDistance[q] = std::sqrt(nearestSquared);
+		}
+		double bruteNearestTime = MicrosecondsSince(start) / g_PointQueries;
+
+		std::vector<float> bvhNearestDistance(g_PointQueries);
+		start = BENCH_CLOCK::now();
+		for (int q = 0; q < g_PointQueries; q++)
+		{
+			hierarchy.FindNearest(origins[q], FLT_MAX, bvhNearestDistance[q]);
+		}
+		double bvhNearestTime = MicrosecondsSince(start) / g_PointQueries;
+
+		// ties between overlapping boxes may pick different
+		// objects, so the results compare distances
+		for (int q = 0; q < g_PointQueries; q++)
+		{
+			mismatches += ((bruteHits[q] < 0) != (bvhHits[q] < 0)) ? 1 : 0;
+			mismatches += ((bruteHits[q] >= 0) && (std::fabs(bruteHitDistance[q] - bvhHitDistance[q]) > 1e-4f)) ? 1 : 0;
+			mismatches += (std::fabs(bruteNearestDistance[q] - bvhNearestDistance[q]) > 1e-4f) ? 1 : 0;
+		}
+
+		std::cout << std::fixed << std::setprecision(2)
+			<< std::setw(7) << objectCount << "  "
+			<< std::setw(9) << buildTime << "  "
+			<< std::setw(5) << hierarchy.GetNodeCount() << "  | "
+			<< std::setw(10) << bruteFrustumTime << " / " << std::setw(8) << bvhFrustumTime << "  | "
+			<< std::setw(8) << bruteRayTime << " / " << std::setw(7) << bvhRayTime << "  | "
+			<< std::setw(9) << bruteNearestTime << " / " << std::setw(8) << bvhNearestTime << "  | "
+			<< mismatches << std::endl;
+	}
+}
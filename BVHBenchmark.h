@@ -0,0 +1,13 @@
+///////////////////////////////////////////////////////////////////////////////
+// bvhbenchmark.h
+// ============
+// compare the cost of brute-force and BVH scene queries as the object
+// count grows
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+// run the benchmark and print the timings to the console,
+// started with the --bvh-benchmark command line argument
+void RunBVHBenchmark();
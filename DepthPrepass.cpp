@@ -0,0 +1,161 @@
+///////////////////////////////////////////////////////////////////////////////
+// depthprepass.cpp
+// ============
+// depth-only shader program that lays down the scene depth before shading
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "DepthPrepass.h"
+
+#include <glm/gtc/type_ptr.hpp>
+
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/***********************************************************
+ *  DepthPrepass()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+DepthPrepass::DepthPrepass()
+{
+	m_programID = 0;
+	m_viewLocation = -1;
+	m_projectionLocation = -1;
+	m_useInstancingLocation = -1;
+	m_previousProgramID = 0;
+}
+
+/***********************************************************
+ *  ~DepthPrepass()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+DepthPrepass::~DepthPrepass()
+{
+	if (m_programID != 0)
+	{
+		glDeleteProgram(m_programID);
+		m_programID = 0;
+	}
+}
+
+/***********************************************************
+ *  CompileShader()
+ *
+ *  This method is used for reading a shader source file and
+ *  compiling it, the compile log is printed on failure.
+ ***********************************************************/
+GLuint DepthPrepass::CompileShader(GLenum shaderType, const char* path)
+{
+	std::ifstream file(path);
+	if (file.is_open() == false)
+	{
+		std::cout << "Could not open depth shader:" << path << std::endl;
+		return(0);
+	}
+	std::stringstream source;
+	source << file.rdbuf();
+	const std::string sourceText = source.str();
+	const GLchar* sourcePointer = sourceText.c_str();
+
+	GLuint shaderID = glCreateShader(shaderType);
+	glShaderSource(shaderID, 1, &sourcePointer, NULL);
+	glCompileShader(shaderID);
+
+	GLint bCompiled = GL_FALSE;
+	glGetShaderiv(shaderID, GL_COMPILE_STATUS, &bCompiled);
+	if (bCompiled == GL_FALSE)
+	{
+		GLint logLength = 0;
+		glGetShaderiv(shaderID, GL_INFO_LOG_LENGTH, &logLength);
+		std::vector<GLchar> log(logLength + 1, 0);
+		glGetShaderInfoLog(shaderID, logLength, NULL, log.data());
+		std::cout << "Could not compile depth shader:" << path << std::endl << log.data() << std::endl;
+		glDeleteShader(shaderID);
+		return(0);
+	}
+
+	return(shaderID);
+}
+
+/***********************************************************
+ *  Load()
+ *
+ *  This method is used for building the depth-only program
+ *  from its vertex and fragment shader files.
+ ***********************************************************/
+bool DepthPrepass::Load(const char* vertexShaderPath, const char* fragmentShaderPath)
+{
+	GLuint vertexShaderID = CompileShader(GL_VERTEX_SHADER, vertexShaderPath);
+	GLuint fragmentShaderID = CompileShader(GL_FRAGMENT_SHADER, fragmentShaderPath);
+	if ((vertexShaderID == 0) || (fragmentShaderID == 0))
+	{
+		glDeleteShader(vertexShaderID);
+		glDeleteShader(fragmentShaderID);
+		return(false);
+	}
+
+	GLuint programID = glCreateProgram();
+	glAttachShader(programID, vertexShaderID);
+	glAttachShader(programID, fragmentShaderID);
+	glLinkProgram(programID);
+	glDeleteShader(vertexShaderID);
+	glDeleteShader(fragmentShaderID);
+
+	GLint bLinked = GL_FALSE;
+	glGetProgramiv(programID, GL_LINK_STATUS, &bLinked);
+	if (bLinked == GL_FALSE)
+	{
+		GLint logLength = 0;
+		glGetProgramiv(programID, GL_INFO_LOG_LENGTH, &logLength);
+		std::vector<GLchar> log(logLength + 1, 0);
+		glGetProgramInfoLog(programID, logLength, NULL, log.data());
+		std::cout << "Could not link depth program:" << std::endl << log.data() << std::endl;
+		glDeleteProgram(programID);
+		return(false);
+	}
+
+	if (m_programID != 0)
+	{
+		glDeleteProgram(m_programID);
+	}
+	m_programID = programID;
+	m_viewLocation = glGetUniformLocation(m_programID, "view");
+	m_projectionLocation = glGetUniformLocation(m_programID, "projection");
+	m_useInstancingLocation = glGetUniformLocation(m_programID, "bUseInstancing");
+
+	return(true);
+}
+
+/***********************************************************
+ *  Begin()
+ *
+ *  This method is used for switching to the depth program
+ *  for the pre-pass draws.  The matrices are the ones the
+ *  shading program is drawn with, and the model matrix comes
+ *  from the per-draw data as in the shading program, so both
+ *  passes compute the same depth.
+ ***********************************************************/
+void DepthPrepass::Begin(const glm::mat4& view, const glm::mat4& projection)
+{
+	glGetIntegerv(GL_CURRENT_PROGRAM, &m_previousProgramID);
+	glUseProgram(m_programID);
+	glUniformMatrix4fv(m_viewLocation, 1, GL_FALSE, glm::value_ptr(view));
+	glUniformMatrix4fv(m_projectionLocation, 1, GL_FALSE, glm::value_ptr(projection));
+	glUniform1i(m_useInstancingLocation, GL_TRUE);
+}
+
+/***********************************************************
+ *  End()
+ *
+ *  This method is used for switching back to the program
+ *  that was in use before the pre-pass.
+ ***********************************************************/
+void DepthPrepass::End()
+{
+	glUseProgram((GLuint)m_previousProgramID);
+}
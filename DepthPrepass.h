@@ -0,0 +1,57 @@
+///////////////////////////////////////////////////////////////////////////////
+// depthprepass.h
+// ============
+// depth-only shader program that lays down the scene depth before shading
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+/***********************************************************
+ *  DepthPrepass
+ *
+ *  This class owns the shader program of the depth pre-pass.
+ *  The program only transforms the positions and writes no
+ *  color, so the opaque objects can be drawn once to fill
+ *  the depth buffer and then shaded with an equal depth
+ *  test, which runs the lighting once per pixel instead of
+ *  once per overlapping fragment.
+ *
+ *  The program reads the position-only vertex stream and
+ *  the per-draw model matrix of the mesh arena.  It selects
+ *  the model matrix through the same bUseInstancing switch
+ *  as the shading program, so both compute the position
+ *  through the same statements and the equal depth test
+ *  can rely on invariant gl_Position.
+ ***********************************************************/
+class DepthPrepass
+{
+public:
+	// constructor
+	DepthPrepass();
+	// destructor
+	~DepthPrepass();
+
+	// compile and link the depth-only shader program
+	bool Load(const char* vertexShaderPath, const char* fragmentShaderPath);
+	bool IsLoaded() const { return m_programID != 0; }
+
+	// switch to the depth program with the camera matrices,
+	// and back to the program that was in use before
+	void Begin(const glm::mat4& view, const glm::mat4& projection);
+	void End();
+
+private:
+	GLuint m_programID;
+	GLint m_viewLocation;
+	GLint m_projectionLocation;
+	GLint m_useInstancingLocation;
+	// program in use before Begin()
+	GLint m_previousProgramID;
+
+	// compile one stage from a source file, 0 on failure
+	static GLuint CompileShader(GLenum shaderType, const char* path);
+};
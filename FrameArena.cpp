@@ -0,0 +1,160 @@
+///////////////////////////////////////////////////////////////////////////////
+// framearena.cpp
+// ============
+// bump allocator for the transient data of a frame, with a sub-arena per
+// thread, reset at the start of every frame
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "FrameArena.h"
+
+#include <algorithm>
+
+// declare the global variables
+namespace
+{
+	/***********************************************************
+	 *  AlignOffset()
+	 *
+	 *  The first offset at or after the passed in one whose
+	 *  address in the block has the alignment, a power of two.
+	 ***********************************************************/
+	size_t AlignOffset(const uint8_t* pBlock, size_t offset, size_t alignment)
+	{
+		const uintptr_t address = (uintptr_t)(pBlock + offset);
+		const uintptr_t aligned = (address + alignment - 1) & ~(uintptr_t)(alignment - 1);
+
+		return(offset + (size_t)(aligned - address));
+	}
+}
+
+/***********************************************************
+ *  FrameArena()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+FrameArena::FrameArena()
+{
+	m_growCount.store(0);
+}
+
+/***********************************************************
+ *  Initialize()
+ *
+ *  This method is used for creating a sub-arena with a
+ *  block of the passed in size for every thread, dropping
+ *  the sub-arenas there were before.
+ ***********************************************************/
+void FrameArena::Initialize(int threadCount, size_t blockSize)
+{
+	m_threads.clear();
+	m_threads.resize(std::max(1, threadCount));
+	for (SUB_ARENA& arena : m_threads)
+	{
+		arena.block.reset(new uint8_t[blockSize]);
+		arena.blockSize = blockSize;
+	}
+}
+
+/***********************************************************
+ *  Reset()
+ *
+ *  This method is used for starting a new frame.  A sub-
+ *  arena that took heap blocks in the last frame gets one
+ *  block that holds all it used, with some room to spare.
+ ***********************************************************/
+void FrameArena::Reset()
+{
+	for (SUB_ARENA& arena : m_threads)
+	{
+		if (arena.overflow.empty() == false)
+		{
+			const size_t used = arena.offset + arena.overflowUsed;
+			arena.blockSize = std::max(arena.blockSize * 2, used + used / 2);
+			arena.block.reset(new uint8_t[arena.blockSize]);
+			arena.overflow.clear();
+			arena.overflowOffset = 0;
+			arena.overflowSize = 0;
+			arena.overflowUsed = 0;
+			m_growCount.fetch_add(1, std::memory_order_relaxed);
+		}
+		arena.offset = 0;
+	}
+}
+
+/***********************************************************
+ *  Allocate()
+ *
+ *  This method is used for handing out bytes from the sub-
+ *  arena of a thread, aligned to a power of two.  Only the
+ *  thread itself may allocate from its sub-arena.
+ ***********************************************************/
+void* FrameArena::Allocate(int thread, size_t size, size_t alignment)
+{
+	SUB_ARENA& arena = m_threads[thread];
+
+	if (arena.overflow.empty() == true)
+	{
+		const size_t offset = AlignOffset(arena.block.get(), arena.offset, alignment);
+		if (offset + size <= arena.blockSize)
+		{
+			arena.offset = offset + size;
+			return(arena.block.get() + offset);
+		}
+	}
+
+	return(AllocateOverflow(arena, size, alignment));
+}
+
+/***********************************************************
+ *  AllocateOverflow()
+ *
+ *  This method is used for handing out bytes once the block
+ *  of a sub-arena is full.  They come from the newest heap
+ *  block, and a new one is taken when it is full too.
+ ***********************************************************/
+void* FrameArena::AllocateOverflow(SUB_ARENA& arena, size_t size, size_t alignment)
+{
+	if (arena.overflow.empty() == false)
+	{
+		uint8_t* pBlock = arena.overflow.back().get();
+		const size_t offset = AlignOffset(pBlock, arena.overflowOffset, alignment);
+		if (offset + size <= arena.overflowSize)
+		{
+			arena.overflowUsed += offset + size - arena.overflowOffset;
+			arena.overflowOffset = offset + size;
+			return(pBlock + offset);
+		}
+	}
+
+	// the blocks double, so a frame far larger than the block
+	// only takes a few of them
+	arena.overflowSize = std::max(2 * std::max(arena.blockSize, arena.overflowSize), size + alignment);
+	arena.overflow.emplace_back(new uint8_t[arena.overflowSize]);
+	m_growCount.fetch_add(1, std::memory_order_relaxed);
+
+	uint8_t* pBlock = arena.overflow.back().get();
+	const size_t offset = AlignOffset(pBlock, 0, alignment);
+	arena.overflowUsed += offset + size;
+	arena.overflowOffset = offset + size;
+
+	return(pBlock + offset);
+}
+
+/***********************************************************
+ *  GetUsedBytes()
+ *
+ *  This method is used for getting the bytes handed out by
+ *  all the sub-arenas since the last Reset().
+ ***********************************************************/
+size_t FrameArena::GetUsedBytes() const
+{
+	size_t used = 0;
+
+	for (const SUB_ARENA& arena : m_threads)
+	{
+		used += arena.offset + arena.overflowUsed;
+	}
+
+	return(used);
+}
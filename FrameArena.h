@@ -0,0 +1,87 @@
+///////////////////////////////////////////////////////////////////////////////
+// framearena.h
+// ============
+// bump allocator for the transient data of a frame, with a sub-arena per
+// thread, reset at the start of every frame
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+/***********************************************************
+ *  FrameArena
+ *
+ *  This class hands out memory that only lives until the
+ *  next frame starts.  Every thread allocates from a sub-
+ *  arena of its own by moving an offset along a block, so
+ *  an allocation takes no lock and nothing is freed one by
+ *  one - Reset() drops all of it at once.
+ *
+ *  A frame that needs more than a block holds takes extra
+ *  blocks from the heap.  The next Reset() replaces them
+ *  with one block big enough for the whole frame, so the
+ *  arena stops touching the heap once it has seen the
+ *  largest frame.
+ *
+ *  Nothing allocated here is destroyed by the arena, the
+ *  caller destroys what needs it before the next Reset().
+ ***********************************************************/
+class FrameArena
+{
+public:
+	// constructor
+	FrameArena();
+
+	// create a sub-arena for every thread, each starting
+	// with a block of the passed in size
+	void Initialize(int threadCount, size_t blockSize);
+	int GetThreadCount() const { return (int)m_threads.size(); }
+
+	// start a new frame, everything allocated before is gone
+	void Reset();
+
+	// allocate bytes from the sub-arena of a thread
+	void* Allocate(int thread, size_t size, size_t alignment);
+	// room for count items, not constructed
+	template<typename T>
+	T* AllocateArray(int thread, int count)
+	{
+		return static_cast<T*>(Allocate(thread, sizeof(T) * (size_t)count, alignof(T)));
+	}
+
+	// bytes handed out since the last Reset()
+	size_t GetUsedBytes() const;
+	// heap blocks taken since the start, stays the same once
+	// the arena is warm
+	int GetGrowCount() const { return m_growCount.load(std::memory_order_relaxed); }
+
+private:
+	struct SUB_ARENA
+	{
+		std::unique_ptr<uint8_t[]> block;
+		size_t blockSize = 0;
+		size_t offset = 0;
+		// blocks taken when the frame did not fit, the offset
+		// into and size of the newest one, and the bytes used
+		// from all of them
+		std::vector<std::unique_ptr<uint8_t[]>> overflow;
+		size_t overflowOffset = 0;
+		size_t overflowSize = 0;
+		size_t overflowUsed = 0;
+		// keeps the offsets of two threads off one cache line
+		uint8_t padding[64];
+	};
+
+	std::vector<SUB_ARENA> m_threads;
+	std::atomic<int> m_growCount;
+
+	// take a heap block with room for an allocation
+	void* AllocateOverflow(SUB_ARENA& arena, size_t size, size_t alignment);
+};
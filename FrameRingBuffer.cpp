@@ -0,0 +1,214 @@
+///////////////////////////////////////////////////////////////////////////////
+// frameringbuffer.cpp
+// ============
+// persistently mapped buffer split into per-frame regions guarded by fences
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "FrameRingBuffer.h"
+
+#include <cstring>
+
+// declare the global variables
+namespace
+{
+	// how long a single wait for a region fence may block,
+	// in nanoseconds, before it is retried
+	const GLuint64 g_FenceTimeout = 1000000000;
+
+	const GLbitfield g_MapFlags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+}
+
+/***********************************************************
+ *  FrameRingBuffer()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+FrameRingBuffer::FrameRingBuffer()
+{
+	m_bufferID = 0;
+	m_target = GL_ARRAY_BUFFER;
+	m_regionSize = 0;
+	m_region = 0;
+	m_pMapped = nullptr;
+	for (int i = 0; i < FRAME_COUNT; i++)
+	{
+		m_fences[i] = 0;
+	}
+	m_stallCount = 0;
+}
+
+/***********************************************************
+ *  ~FrameRingBuffer()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+FrameRingBuffer::~FrameRingBuffer()
+{
+	Destroy();
+}
+
+/***********************************************************
+ *  IsPersistentSupported()
+ *
+ *  This method is used for checking that the context can
+ *  create immutable buffer storage that stays mapped.
+ ***********************************************************/
+bool FrameRingBuffer::IsPersistentSupported()
+{
+	return((GLEW_VERSION_4_4 == GL_TRUE) || (GLEW_ARB_buffer_storage == GL_TRUE));
+}
+
+/***********************************************************
+ *  Create()
+ *
+ *  This method is used for creating the buffer that holds
+ *  all the regions.  The buffer is left bound to its target.
+ ***********************************************************/
+void FrameRingBuffer::Create(GLenum target, GLsizeiptr regionSize)
+{
+	Destroy();
+
+	m_target = target;
+	m_regionSize = regionSize;
+	m_region = 0;
+
+	glGenBuffers(1, &m_bufferID);
+	glBindBuffer(m_target, m_bufferID);
+
+	if (IsPersistentSupported() == true)
+	{
+		glBufferStorage(m_target, m_regionSize * FRAME_COUNT, nullptr, g_MapFlags);
+		m_pMapped = (unsigned char*)glMapBufferRange(m_target, 0, m_regionSize * FRAME_COUNT, g_MapFlags);
+	}
+	else
+	{
+		glBufferData(m_target, m_regionSize * FRAME_COUNT, nullptr, GL_DYNAMIC_DRAW);
+	}
+}
+
+/***********************************************************
+ *  Destroy()
+ *
+ *  This method is used for deleting the buffer and the
+ *  fences of the frames still in flight.  GL keeps the
+ *  storage alive until those frames are done with it.
+ ***********************************************************/
+void FrameRingBuffer::Destroy()
+{
+	for (int i = 0; i < FRAME_COUNT; i++)
+	{
+		if (m_fences[i] != 0)
+		{
+			glDeleteSync(m_fences[i]);
+			m_fences[i] = 0;
+		}
+	}
+
+	if (m_bufferID != 0)
+	{
+		if (m_pMapped != nullptr)
+		{
+			glBindBuffer(m_target, m_bufferID);
+			glUnmapBuffer(m_target);
+			glBindBuffer(m_target, 0);
+			m_pMapped = nullptr;
+		}
+		glDeleteBuffers(1, &m_bufferID);
+		m_bufferID = 0;
+	}
+}
+
+/***********************************************************
+ *  BeginFrame()
+ *
+ *  This method is used for making the next region current.
+ *  The frame that wrote it FRAME_COUNT frames ago has to be
+ *  finished on the GPU first, which is usually already the
+ *  case, so the wait only costs something when the CPU runs
+ *  too far ahead.
+ ***********************************************************/
+void FrameRingBuffer::BeginFrame()
+{
+	m_region = (m_region + 1) % FRAME_COUNT;
+
+	GLsync fence = m_fences[m_region];
+	if (fence == 0)
+	{
+		return;
+	}
+
+	GLbitfield waitFlags = 0;
+	GLuint64 timeout = 0;
+	while (true)
+	{
+		GLenum result = glClientWaitSync(fence, waitFlags, timeout);
+		if ((result == GL_ALREADY_SIGNALED) || (result == GL_CONDITION_SATISFIED))
+		{
+			break;
+		}
+		if (result == GL_WAIT_FAILED)
+		{
+			break;
+		}
+
+		// the region is still in use, make sure the fence
+		// gets to the GPU and block until it is signaled
+		if (waitFlags == 0)
+		{
+			m_stallCount++;
+		}
+		waitFlags = GL_SYNC_FLUSH_COMMANDS_BIT;
+		timeout = g_FenceTimeout;
+	}
+
+	glDeleteSync(fence);
+	m_fences[m_region] = 0;
+}
+
+/***********************************************************
+ *  Write()
+ *
+ *  This method is used for writing data into the current
+ *  region at a byte offset from the start of the region.
+ ***********************************************************/
+bool FrameRingBuffer::Write(GLintptr offset, const void* data, GLsizeiptr size)
+{
+	if ((m_bufferID == 0) || (offset < 0) || (offset + size > m_regionSize))
+	{
+		return(false);
+	}
+
+	if (m_pMapped != nullptr)
+	{
+		memcpy(m_pMapped + GetRegionOffset() + offset, data, size);
+	}
+	else
+	{
+		glBindBuffer(m_target, m_bufferID);
+		glBufferSubData(m_target, GetRegionOffset() + offset, size, data);
+		glBindBuffer(m_target, 0);
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *  EndFrame()
+ *
+ *  This method is used for placing a fence after the last
+ *  command that reads the current region.
+ ***********************************************************/
+void FrameRingBuffer::EndFrame()
+{
+	if (m_bufferID == 0)
+	{
+		return;
+	}
+
+	if (m_fences[m_region] != 0)
+	{
+		glDeleteSync(m_fences[m_region]);
+	}
+	m_fences[m_region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
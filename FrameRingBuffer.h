@@ -0,0 +1,71 @@
+///////////////////////////////////////////////////////////////////////////////
+// frameringbuffer.h
+// ============
+// persistently mapped buffer split into per-frame regions guarded by fences
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <GL/glew.h>
+
+/***********************************************************
+ *  FrameRingBuffer
+ *
+ *  This class owns one buffer object split into FRAME_COUNT
+ *  regions of the same size.  Every frame writes into the
+ *  next region while the GPU may still read the regions of
+ *  the frames before it, and a fence placed at the end of a
+ *  frame tells when its region can be written again.
+ *
+ *  With buffer storage (OpenGL 4.4) the buffer is mapped
+ *  once, persistent and coherent, and a write is a plain
+ *  memcpy.  Without it the same regions are written with
+ *  glBufferSubData.
+ ***********************************************************/
+class FrameRingBuffer
+{
+public:
+	// constructor
+	FrameRingBuffer();
+	// destructor
+	~FrameRingBuffer();
+
+	// number of frames that can be in flight
+	static const int FRAME_COUNT = 3;
+
+	// check that the context can map the buffer persistently
+	static bool IsPersistentSupported();
+
+	// create the buffer for a target with a region size in
+	// bytes, replacing the current buffer
+	void Create(GLenum target, GLsizeiptr regionSize);
+	// delete the buffer and its fences
+	void Destroy();
+
+	// move on to the next region, waiting for the GPU to be
+	// done with it
+	void BeginFrame();
+	// write into the current region at a byte offset
+	bool Write(GLintptr offset, const void* data, GLsizeiptr size);
+	// fence the commands that read the current region
+	void EndFrame();
+
+	GLuint GetBuffer() const { return m_bufferID; }
+	GLsizeiptr GetRegionSize() const { return m_regionSize; }
+	// byte offset of the current region in the buffer
+	GLintptr GetRegionOffset() const { return m_regionSize * m_region; }
+	// frames that had to wait for the GPU to free a region
+	int GetStallCount() const { return m_stallCount; }
+
+private:
+	GLuint m_bufferID;
+	GLenum m_target;
+	GLsizeiptr m_regionSize;
+	int m_region;
+	// persistent mapping of the whole buffer, null when the
+	// regions are written with glBufferSubData
+	unsigned char* m_pMapped;
+	GLsync m_fences[FRAME_COUNT];
+	int m_stallCount;
+};
@@ -0,0 +1,262 @@
+///////////////////////////////////////////////////////////////////////////////
+// frustumculler.cpp
+// ============
+// test world-space bounding boxes against the view frustum in batches
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "FrustumCuller.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define FRUSTUM_CULLER_SSE2
+#include <emmintrin.h>
+#endif
+
+// declare the global variables
+namespace
+{
+	// boxes tested together, the width of an SSE register
+	const int g_GroupSize = 4;
+}
+
+/***********************************************************
+ *  FrustumCuller()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+FrustumCuller::FrustumCuller()
+{
+	m_count = 0;
+	for (int i = 0; i < 6; i++)
+	{
+		m_planes[i] = glm::vec4(0.0f);
+	}
+}
+
+/***********************************************************
+ *  Resize()
+ *
+ *  This method is used for setting the number of boxes.  The
+ *  arrays are padded to a whole group, the padding boxes are
+ *  tested but never reported.
+ ***********************************************************/
+void FrustumCuller::Resize(int count)
+{
+	const size_t padded = (size_t)((count + g_GroupSize - 1) / g_GroupSize) * g_GroupSize;
+
+	m_count = count;
+	m_centerX.resize(padded, 0.0f);
+	m_centerY.resize(padded, 0.0f);
+	m_centerZ.resize(padded, 0.0f);
+	m_extentX.resize(padded, 0.0f);
+	m_extentY.resize(padded, 0.0f);
+	m_extentZ.resize(padded, 0.0f);
+	m_visible.resize(padded, 1);
+}
+
+/***********************************************************
+ *  SetBounds()
+ *
+ *  This method is used for setting the world-space box of a
+ *  drawable as its center and half extents.
+ ***********************************************************/
+void FrustumCuller::SetBounds(int index, const glm::vec3& center, const glm::vec3& extents)
+{
+	m_centerX[index] = center.x;
+	m_centerY[index] = center.y;
+	m_centerZ[index] = center.z;
+	m_extentX[index] = extents.x;
+	m_extentY[index] = extents.y;
+	m_extentZ[index] = extents.z;
+}
+
+/***********************************************************
+ *  GetBounds()
+ *
+ *  This method is used for getting the world-space box of a
+ *  drawable back, for the tests done after the frustum.
+ ***********************************************************/
+void FrustumCuller::GetBounds(int index, glm::vec3& center, glm::vec3& extents) const
+{
+	center = glm::vec3(m_centerX[index], m_centerY[index], m_centerZ[index]);
+	extents = glm::vec3(m_extentX[index], m_extentY[index], m_extentZ[index]);
+}
+
+/***********************************************************
+ *  TransformBounds()
+ *
+ *  This method is used for moving a local box into world
+ *  space.  The center is transformed as a point, and every
+ *  world extent is the sum of the local extents weighted by
+ *  the absolute values of the matrix row.
+ ***********************************************************/
+void FrustumCuller::TransformBounds(
+	const glm::mat4& model,
+	const glm::vec3& localMin,
+	const glm::vec3& localMax,
+	glm::vec3& center,
+	glm::vec3& extents)
+{
+	const glm::vec3 localCenter = (localMin + localMax) * 0.5f;
+	const glm::vec3 localExtents = (localMax - localMin) * 0.5f;
+
+	center = glm::vec3(model * glm::vec4(localCenter, 1.0f));
+	for (int row = 0; row < 3; row++)
+	{
+		extents[row] =
+			std::fabs(model[0][row]) * localExtents.x +
+			std::fabs(model[1][row]) * localExtents.y +
+			std::fabs(model[2][row]) * localExtents.z;
+	}
+}
+
+/***********************************************************
+ *  ExtractPlanes()
+ *
+ *  This method is used for extracting the six frustum planes
+ *  from the rows of the projection * view matrix.  Each
+ *  plane is normalized, so a box can be tested with its
+ *  distances to the planes.
+ ***********************************************************/
+void FrustumCuller::ExtractPlanes(const glm::mat4& viewProjection)
+{
+	// glm matrices are column major, m[column][row]
+	const glm::vec4 row0(viewProjection[0][0], viewProjection[1][0], viewProjection[2][0], viewProjection[3][0]);
+	const glm::vec4 row1(viewProjection[0][1], viewProjection[1][1], viewProjection[2][1], viewProjection[3][1]);
+	const glm::vec4 row2(viewProjection[0][2], viewProjection[1][2], viewProjection[2][2], viewProjection[3][2]);
+	const glm::vec4 row3(viewProjection[0][3], viewProjection[1][3], viewProjection[2][3], viewProjection[3][3]);
+
+	m_planes[0] = row3 + row0;	// left
+	m_planes[1] = row3 - row0;	// right
+	m_planes[2] = row3 + row1;	// bottom
+	m_planes[3] = row3 - row1;	// top
+	m_planes[4] = row3 + row2;	// near
+	m_planes[5] = row3 - row2;	// far
+
+	for (int i = 0; i < 6; i++)
+	{
+		float length = glm::length(glm::vec3(m_planes[i]));
+		if (length > 0.0f)
+		{
+			m_planes[i] /= length;
+		}
+	}
+}
+
+/***********************************************************
+ *  Cull()
+ *
+ *  This method is used for testing every box against the
+ *  frustum and counting the visible ones.
+ ***********************************************************/
+int FrustumCuller::Cull(const glm::mat4& viewProjection)
+{
+	ExtractPlanes(viewProjection);
+	CullGroups(0, (int)m_visible.size());
+
+	int visibleCount = 0;
+	for (int i = 0; i < m_count; i++)
+	{
+		visibleCount += m_visible[i];
+	}
+
+	return(visibleCount);
+}
+
+/***********************************************************
+ *  Cull()
+ *
+ *  This method is used for testing the boxes against the
+ *  frustum with the help of a hierarchy over the boxes
+ *  below hierarchyCount.  The boxes after them are tested
+ *  one group at a time.
+ ***********************************************************/
+int FrustumCuller::Cull(const glm::mat4& viewProjection, const SceneBVH& hierarchy, int hierarchyCount)
+{
+	ExtractPlanes(viewProjection);
+
+	// the group holding the first box past the hierarchy is
+	// tested whole, the test gives the same result for the
+	// hierarchy boxes in it
+	const int firstGroup = (hierarchyCount / g_GroupSize) * g_GroupSize;
+	std::fill(m_visible.begin(), m_visible.begin() + firstGroup, (uint8_t)0);
+	hierarchy.QueryFrustum(m_planes, m_visible.data());
+	CullGroups(firstGroup, (int)m_visible.size() - firstGroup);
+
+	int visibleCount = 0;
+	for (int i = 0; i < m_count; i++)
+	{
+		visibleCount += m_visible[i];
+	}
+
+	return(visibleCount);
+}
+
+/***********************************************************
+ *  CullGroups()
+ *
+ *  This method is used for testing a range of boxes, that
+ *  starts and ends on a group boundary.  The distance of a
+ *  box to a plane is the distance of its center plus its
+ *  extents projected on the absolute plane normal, and the
+ *  box is outside when that is negative for any plane.
+ ***********************************************************/
+void FrustumCuller::CullGroups(int first, int count)
+{
+#ifdef FRUSTUM_CULLER_SSE2
+	const __m128 zero = _mm_setzero_ps();
+
+	for (int i = first; i < first + count; i += g_GroupSize)
+	{
+		const __m128 centerX = _mm_loadu_ps(&m_centerX[i]);
+		const __m128 centerY = _mm_loadu_ps(&m_centerY[i]);
+		const __m128 centerZ = _mm_loadu_ps(&m_centerZ[i]);
+		const __m128 extentX = _mm_loadu_ps(&m_extentX[i]);
+		const __m128 extentY = _mm_loadu_ps(&m_extentY[i]);
+		const __m128 extentZ = _mm_loadu_ps(&m_extentZ[i]);
+		__m128 outside = _mm_setzero_ps();
+
+		for (int p = 0; p < 6; p++)
+		{
+			const glm::vec4& plane = m_planes[p];
+			const __m128 normalX = _mm_set1_ps(plane.x);
+			const __m128 normalY = _mm_set1_ps(plane.y);
+			const __m128 normalZ = _mm_set1_ps(plane.z);
+
+			__m128 distance = _mm_add_ps(_mm_mul_ps(normalX, centerX), _mm_set1_ps(plane.w));
+			distance = _mm_add_ps(distance, _mm_mul_ps(normalY, centerY));
+			distance = _mm_add_ps(distance, _mm_mul_ps(normalZ, centerZ));
+			distance = _mm_add_ps(distance, _mm_mul_ps(_mm_set1_ps(std::fabs(plane.x)), extentX));
+			distance = _mm_add_ps(distance, _mm_mul_ps(_mm_set1_ps(std::fabs(plane.y)), extentY));
+			distance = _mm_add_ps(distance, _mm_mul_ps(_mm_set1_ps(std::fabs(plane.z)), extentZ));
+
+			outside = _mm_or_ps(outside, _mm_cmplt_ps(distance, zero));
+		}
+
+		const int outsideMask = _mm_movemask_ps(outside);
+		for (int lane = 0; lane < g_GroupSize; lane++)
+		{
+			m_visible[i + lane] = ((outsideMask >> lane) & 1) ? 0 : 1;
+		}
+	}
+#else
+	for (int i = first; i < first + count; i++)
+	{
+		bool bOutside = false;
+		for (int p = 0; (p < 6) && (bOutside == false); p++)
+		{
+			const glm::vec4& plane = m_planes[p];
+			float distance =
+				plane.x * m_centerX[i] + plane.y * m_centerY[i] + plane.z * m_centerZ[i] + plane.w +
+				std::fabs(plane.x) * m_extentX[i] +
+				std::fabs(plane.y) * m_extentY[i] +
+				std::fabs(plane.z) * m_extentZ[i];
+			bOutside = (distance < 0.0f);
+		}
+		m_visible[i] = (bOutside == true) ? 0 : 1;
+	}
+#endif
+}
@@ -0,0 +1,80 @@
+///////////////////////////////////////////////////////////////////////////////
+// frustumculler.h
+// ============
+// test world-space bounding boxes against the view frustum in batches
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "SceneBVH.h"
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <vector>
+
+/***********************************************************
+ *  FrustumCuller
+ *
+ *  This class keeps the world-space bounding boxes of the
+ *  scene drawables as centers and half extents, one array
+ *  per component, and tests them against the six planes of
+ *  the view frustum.  The arrays are padded to groups of
+ *  four, so with SSE2 four boxes are tested per plane with
+ *  a handful of instructions.  A box is culled when it lies
+ *  completely behind any one plane.
+ *
+ *  Large scenes walk a SceneBVH over the first boxes instead
+ *  of testing them one by one.
+ ***********************************************************/
+class FrustumCuller
+{
+public:
+	// constructor
+	FrustumCuller();
+
+	// set the number of boxes, keeping the existing ones
+	void Resize(int count);
+	int GetCount() const { return m_count; }
+
+	// set the world-space box of a drawable
+	void SetBounds(int index, const glm::vec3& center, const glm::vec3& extents);
+	void GetBounds(int index, glm::vec3& center, glm::vec3& extents) const;
+	// move a local box by a model matrix, the result is the
+	// world-space box that encloses the transformed box
+	static void TransformBounds(
+		const glm::mat4& model,
+		const glm::vec3& localMin,
+		const glm::vec3& localMax,
+		glm::vec3& center,
+		glm::vec3& extents);
+
+	// test every box against the frustum of the passed in
+	// projection * view matrix, returns the visible count
+	int Cull(const glm::mat4& viewProjection);
+	// same test, the boxes below hierarchyCount are found by
+	// walking the passed in hierarchy over them
+	int Cull(const glm::mat4& viewProjection, const SceneBVH& hierarchy, int hierarchyCount);
+	// result of the last Cull() for a box
+	bool IsVisible(int index) const { return m_visible[index] != 0; }
+
+private:
+	int m_count;
+	// frustum planes, xyz normal pointing inside and w distance
+	glm::vec4 m_planes[6];
+	// box centers and half extents, padded to groups of four
+	std::vector<float> m_centerX;
+	std::vector<float> m_centerY;
+	std::vector<float> m_centerZ;
+	std::vector<float> m_extentX;
+	std::vector<float> m_extentY;
+	std::vector<float> m_extentZ;
+	// 1 for the boxes inside or crossing the frustum
+	std::vector<uint8_t> m_visible;
+
+	// extract the normalized frustum planes
+	void ExtractPlanes(const glm::mat4& viewProjection);
+	// test the boxes from first on, four at a time
+	void CullGroups(int first, int count);
+};
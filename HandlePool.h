@@ -0,0 +1,211 @@
+///////////////////////////////////////////////////////////////////////////////
+// handlepool.h
+// ============
+// generational handles to items kept packed in dense arrays, so items can
+// be added and removed at any time and stale handles are caught
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+/***********************************************************
+ *  HandlePool
+ *
+ *  This class hands out handles to items that are stored
+ *  one after the other, with no gaps, in dense arrays.  A
+ *  handle names a slot of an indirection table, and the
+ *  slot holds the dense index of the item and a generation
+ *  that is bumped when the item is removed.  A handle kept
+ *  after its item was removed no longer matches the slot,
+ *  so it is detected instead of finding another item.
+ *
+ *  The pool only keeps the indirection - the owner keeps
+ *  the items in as many dense arrays as it needs, all with
+ *  the same index.  Removing an item moves the last item
+ *  into its place, and the owner moves the last entry of
+ *  each of its arrays the same way.  The item type only
+ *  keeps the handles of different pools apart.
+ ***********************************************************/
+template<typename T>
+class HandlePool
+{
+public:
+	// slot of a handle that names no item
+	static const uint32_t INVALID_SLOT = 0xFFFFFFFF;
+
+	struct HANDLE
+	{
+		uint32_t slot = INVALID_SLOT;
+		uint32_t generation = 0;
+
+		bool operator==(const HANDLE& other) const { return (slot == other.slot) && (generation == other.generation); }
+		bool operator!=(const HANDLE& other) const { return (slot != other.slot) || (generation != other.generation); }
+	};
+
+	// constructor
+	HandlePool() { m_firstFree = INVALID_SLOT; }
+
+	// add an item after the last one in the dense arrays
+	HANDLE Add();
+	// remove the item of a handle and return the dense index
+	// it had, -1 for a stale handle - when the index is still
+	// below GetCount(), the last item was moved there
+	int Remove(HANDLE handle);
+	// remove every item, all the handles become stale
+	void Clear();
+
+	// dense index of the item of a handle, -1 when stale
+	int GetIndex(HANDLE handle) const;
+	bool IsValid(HANDLE handle) const { return GetIndex(handle) >= 0; }
+	// handle of the item at a dense index
+	HANDLE GetHandle(int index) const;
+	int GetCount() const { return (int)m_denseSlots.size(); }
+
+private:
+	struct SLOT
+	{
+		// dense index of the item, or the next free slot
+		uint32_t index;
+		uint32_t generation;
+	};
+
+	std::vector<SLOT> m_slots;
+	// slot of every item, in dense order
+	std::vector<uint32_t> m_denseSlots;
+	// free slots are chained through their index
+	uint32_t m_firstFree;
+};
+
+/***********************************************************
+ *  Add()
+ *
+ *  This method is used for adding an item at the end of the
+ *  dense arrays.  A slot freed by a removed item is used
+ *  again, with its newer generation.
+ ***********************************************************/
+template<typename T>
+typename HandlePool<T>::HANDLE HandlePool<T>::Add()
+{
+	HANDLE handle;
+
+	if (m_firstFree != INVALID_SLOT)
+	{
+		handle.slot = m_firstFree;
+		m_firstFree = m_slots[handle.slot].index;
+	}
+	else
+	{
+		handle.slot = (uint32_t)m_slots.size();
+		m_slots.push_back(SLOT());
+		m_slots.back().generation = 0;
+	}
+
+	m_slots[handle.slot].index = (uint32_t)m_denseSlots.size();
+	handle.generation = m_slots[handle.slot].generation;
+	m_denseSlots.push_back(handle.slot);
+
+	return(handle);
+}
+
+/***********************************************************
+ *  Remove()
+ *
+ *  This method is used for removing the item of a handle.
+ *  The last item takes its dense index, so the arrays stay
+ *  packed, and the slot of the removed item goes on the
+ *  free list with a new generation.
+ ***********************************************************/
+template<typename T>
+int HandlePool<T>::Remove(HANDLE handle)
+{
+	const int index = GetIndex(handle);
+	if (index < 0)
+	{
+		return(-1);
+	}
+
+	const uint32_t lastSlot = m_denseSlots.back();
+	m_denseSlots[index] = lastSlot;
+	m_slots[lastSlot].index = (uint32_t)index;
+	m_denseSlots.pop_back();
+
+	SLOT& slot = m_slots[handle.slot];
+	slot.generation++;
+	slot.index = m_firstFree;
+	m_firstFree = handle.slot;
+
+	return(index);
+}
+
+/***********************************************************
+ *  Clear()
+ *
+ *  This method is used for removing every item.  The slots
+ *  in use get a new generation, so none of the handles
+ *  handed out before resolve.
+ ***********************************************************/
+template<typename T>
+void HandlePool<T>::Clear()
+{
+	for (uint32_t slot : m_denseSlots)
+	{
+		m_slots[slot].generation++;
+	}
+	m_denseSlots.clear();
+
+	m_firstFree = INVALID_SLOT;
+	for (int slot = (int)m_slots.size() - 1; slot >= 0; slot--)
+	{
+		m_slots[slot].index = m_firstFree;
+		m_firstFree = (uint32_t)slot;
+	}
+}
+
+/***********************************************************
+ *  GetIndex()
+ *
+ *  This method is used for getting the dense index of the
+ *  item of a handle, which takes one look into the slots.
+ ***********************************************************/
+template<typename T>
+int HandlePool<T>::GetIndex(HANDLE handle) const
+{
+	if ((handle.slot >= (uint32_t)m_slots.size()) ||
+		(m_slots[handle.slot].generation != handle.generation))
+	{
+		return(-1);
+	}
+
+	// a free slot keeps the generation its next item gets
+	const uint32_t index = m_slots[handle.slot].index;
+	if ((index >= (uint32_t)m_denseSlots.size()) || (m_denseSlots[index] != handle.slot))
+	{
+		return(-1);
+	}
+
+	return((int)index);
+}
+
+/***********************************************************
+ *  GetHandle()
+ *
+ *  This method is used for getting the handle of the item
+ *  at a dense index, or a handle that names no item when
+ *  the index is past the last item.
+ ***********************************************************/
+template<typename T>
+typename HandlePool<T>::HANDLE HandlePool<T>::GetHandle(int index) const
+{
+	HANDLE handle;
+
+	if ((index >= 0) && (index < (int)m_denseSlots.size()))
+	{
+		handle.slot = m_denseSlots[index];
+		handle.generation = m_slots[handle.slot].generation;
+	}
+
+	return(handle);
+}
@@ -0,0 +1,255 @@
+///////////////////////////////////////////////////////////////////////////////
+// instancedmeshes.cpp
+// ============
+// draw many copies of a basic shape mesh with a single instanced draw call
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "InstancedMeshes.h"
+
+#include <cstddef>
+
+// declare the global variables
+namespace
+{
+	// vertex layout of the meshes, same as the basic shape meshes
+	const GLuint g_FloatsPerVertex = 3;
+	const GLuint g_FloatsPerNormal = 3;
+	const GLuint g_FloatsPerUV = 2;
+	const GLuint g_VertexStride = g_FloatsPerVertex + g_FloatsPerNormal + g_FloatsPerUV;
+
+	// first attribute location of the per-instance data
+	const GLuint g_InstanceModelLocation = 3;
+	const GLuint g_InstanceColorLocation = 7;
+}
+
+/***********************************************************
+ *  InstancedMeshes()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+InstancedMeshes::InstancedMeshes()
+{
+	m_BoxMesh = GLMesh();
+	m_PlaneMesh = GLMesh();
+}
+
+/***********************************************************
+ *  ~InstancedMeshes()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+InstancedMeshes::~InstancedMeshes()
+{
+	for (GLInstances& instances : m_instances)
+	{
+		glDeleteVertexArrays(1, &instances.vao);
+		glDeleteBuffers(1, &instances.vbo);
+	}
+	m_instances.clear();
+
+	glDeleteBuffers(2, m_BoxMesh.vbos);
+	glDeleteBuffers(2, m_PlaneMesh.vbos);
+}
+
+/***********************************************************
+ *  LoadBoxMesh()
+ *
+ *  This method is used for creating the unit box mesh,
+ *  centered on the origin, with one normal per face.
+ ***********************************************************/
+void InstancedMeshes::LoadBoxMesh()
+{
+	GLfloat verts[] = {
+		// back face
+		-0.5f, -0.5f, -0.5f,  0.0f,  0.0f, -1.0f,  0.0f, 0.0f,
+		 0.5f, -0.5f, -0.5f,  0.0f,  0.0f, -1.0f,  1.0f, 0.0f,
+		 0.5f,  0.5f, -0.5f,  0.0f,  0.0f, -1.0f,  1.0f, 1.0f,
+		-0.5f,  0.5f, -0.5f,  0.0f,  0.0f, -1.0f,  0.0f, 1.0f,
+		// front face
+		-0.5f, -0.5f,  0.5f,  0.0f,  0.0f,  1.0f,  0.0f, 0.0f,
+		 0.5f, -0.5f,  0.5f,  0.0f,  0.0f,  1.0f,  1.0f, 0.0f,
+		 0.5f,  0.5f,  0.5f,  0.0f,  0.0f,  1.0f,  1.0f, 1.0f,
+		-0.5f,  0.5f,  0.5f,  0.0f,  0.0f,  1.0f,  0.0f, 1.0f,
+		// left face
+		-0.5f,  0.5f,  0.5f, -1.0f,  0.0f,  0.0f,  1.0f, 1.0f,
+		-0.5f,  0.5f, -0.5f, -1.0f,  0.0f,  0.0f,  0.0f, 1.0f,
+		-0.5f, -0.5f, -0.5f, -1.0f,  0.0f,  0.0f,  0.0f, 0.0f,
+		-0.5f, -0.5f,  0.5f, -1.0f,  0.0f,  0.0f,  1.0f, 0.0f,
+		// right face
+		 0.5f,  0.5f,  0.5f,  1.0f,  0.0f,  0.0f,  0.0f, 1.0f,
+		 0.5f,  0.5f, -0.5f,  1.0f,  0.0f,  0.0f,  1.0f, 1.0f,
+		 0.5f, -0.5f, -0.5f,  1.0f,  0.0f,  0.0f,  1.0f, 0.0f,
+		 0.5f, -0.5f,  0.5f,  1.0f,  0.0f,  0.0f,  0.0f, 0.0f,
+		// bottom face
+		-0.5f, -0.5f, -0.5f,  0.0f, -1.0f,  0.0f,  0.0f, 1.0f,
+		 0.5f, -0.5f, -0.5f,  0.0f, -1.0f,  0.0f,  1.0f, 1.0f,
+		 0.5f, -0.5f,  0.5f,  0.0f, -1.0f,  0.0f,  1.0f, 0.0f,
+		-0.5f, -0.5f,  0.5f,  0.0f, -1.0f,  0.0f,  0.0f, 0.0f,
+		// top face
+		-0.5f,  0.5f, -0.5f,  0.0f,  1.0f,  0.0f,  0.0f, 1.0f,
+		 0.5f,  0.5f, -0.5f,  0.0f,  1.0f,  0.0f,  1.0f, 1.0f,
+		 0.5f,  0.5f,  0.5f,  0.0f,  1.0f,  0.0f,  1.0f, 0.0f,
+		-0.5f,  0.5f,  0.5f,  0.0f,  1.0f,  0.0f,  0.0f, 0.0f
+	};
+
+	GLushort indices[] = {
+		0, 2, 1, 0, 3, 2,
+		4, 5, 6, 4, 6, 7,
+		8, 9, 10, 8, 10, 11,
+		12, 14, 13, 12, 15, 14,
+		16, 17, 18, 16, 18, 19,
+		20, 22, 21, 20, 23, 22
+	};
+
+	CreateMesh(m_BoxMesh, verts, sizeof(verts) / sizeof(verts[0]), indices, sizeof(indices) / sizeof(indices[0]));
+}
+
+/***********************************************************
+ *  LoadPlaneMesh()
+ *
+ *  This method is used for creating the plane mesh, lying
+ *  on the XZ plane from -1 to 1 and facing up.
+ ***********************************************************/
+void InstancedMeshes::LoadPlaneMesh()
+{
+	GLfloat verts[] = {
+		-1.0f, 0.0f,  1.0f,  0.0f, 1.0f, 0.0f,  0.0f, 0.0f,
+		 1.0f, 0.0f,  1.0f,  0.0f, 1.0f, 0.0f,  1.0f, 0.0f,
+		 1.0f, 0.0f, -1.0f,  0.0f, 1.0f, 0.0f,  1.0f, 1.0f,
+		-1.0f, 0.0f, -1.0f,  0.0f, 1.0f, 0.0f,  0.0f, 1.0f
+	};
+
+	GLushort indices[] = {
+		0, 1, 2, 0, 2, 3
+	};
+
+	CreateMesh(m_PlaneMesh, verts, sizeof(verts) / sizeof(verts[0]), indices, sizeof(indices) / sizeof(indices[0]));
+}
+
+/***********************************************************
+ *  CreateMesh()
+ *
+ *  This method is used for uploading the vertex and index
+ *  data of a mesh into OpenGL buffers.
+ ***********************************************************/
+void InstancedMeshes::CreateMesh(GLMesh& mesh, const GLfloat* verts, int nVerts, const GLushort* indices, int nIndices)
+{
+	glGenBuffers(2, mesh.vbos);
+
+	glBindBuffer(GL_ARRAY_BUFFER, mesh.vbos[0]);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(GLfloat) * nVerts, verts, GL_STATIC_DRAW);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh.vbos[1]);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(GLushort) * nIndices, indices, GL_STATIC_DRAW);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+	mesh.nIndices = nIndices;
+}
+
+/***********************************************************
+ *  CreateBoxInstances()
+ *
+ *  This method is used for creating an instance buffer
+ *  that draws copies of the box mesh.
+ ***********************************************************/
+int InstancedMeshes::CreateBoxInstances(int instanceCount)
+{
+	return(CreateInstances(m_BoxMesh, instanceCount));
+}
+
+/***********************************************************
+ *  CreatePlaneInstances()
+ *
+ *  This method is used for creating an instance buffer
+ *  that draws copies of the plane mesh.
+ ***********************************************************/
+int InstancedMeshes::CreatePlaneInstances(int instanceCount)
+{
+	return(CreateInstances(m_PlaneMesh, instanceCount));
+}
+
+/***********************************************************
+ *  CreateInstances()
+ *
+ *  This method is used for creating the vertex array that
+ *  combines the vertex data of a mesh with a new buffer of
+ *  per-instance data.
+ ***********************************************************/
+int InstancedMeshes::CreateInstances(const GLMesh& mesh, int instanceCount)
+{
+	GLInstances instances;
+	const GLsizei stride = sizeof(GLfloat) * g_VertexStride;
+	const GLsizei instanceStride = sizeof(INSTANCE_DATA);
+
+	instances.nIndices = mesh.nIndices;
+	instances.nInstances = 0;
+
+	glGenVertexArrays(1, &instances.vao);
+	glBindVertexArray(instances.vao);
+
+	// per-vertex attributes from the shared mesh buffers
+	glBindBuffer(GL_ARRAY_BUFFER, mesh.vbos[0]);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh.vbos[1]);
+	glVertexAttribPointer(0, g_FloatsPerVertex, GL_FLOAT, GL_FALSE, stride, (void*)0);
+	glEnableVertexAttribArray(0);
+	glVertexAttribPointer(1, g_FloatsPerNormal, GL_FLOAT, GL_FALSE, stride, (void*)(sizeof(GLfloat) * g_FloatsPerVertex));
+	glEnableVertexAttribArray(1);
+	glVertexAttribPointer(2, g_FloatsPerUV, GL_FLOAT, GL_FALSE, stride, (void*)(sizeof(GLfloat) * (g_FloatsPerVertex + g_FloatsPerNormal)));
+	glEnableVertexAttribArray(2);
+
+	// per-instance attributes, the model matrix takes one
+	// attribute location for each of its columns
+	glGenBuffers(1, &instances.vbo);
+	glBindBuffer(GL_ARRAY_BUFFER, instances.vbo);
+	glBufferData(GL_ARRAY_BUFFER, instanceStride * instanceCount, nullptr, GL_DYNAMIC_DRAW);
+	for (GLuint column = 0; column < 4; column++)
+	{
+		GLuint location = g_InstanceModelLocation + column;
+		glVertexAttribPointer(location, 4, GL_FLOAT, GL_FALSE, instanceStride, (void*)(offsetof(INSTANCE_DATA, model) + sizeof(glm::vec4) * column));
+		glEnableVertexAttribArray(location);
+		glVertexAttribDivisor(location, 1);
+	}
+	glVertexAttribPointer(g_InstanceColorLocation, 4, GL_FLOAT, GL_FALSE, instanceStride, (void*)offsetof(INSTANCE_DATA, color));
+	glEnableVertexAttribArray(g_InstanceColorLocation);
+	glVertexAttribDivisor(g_InstanceColorLocation, 1);
+
+	glBindVertexArray(0);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	m_instances.push_back(instances);
+	return((int)m_instances.size() - 1);
+}
+
+/***********************************************************
+ *  UpdateInstances()
+ *
+ *  This method is used for uploading the per-instance data
+ *  into an instance buffer.
+ ***********************************************************/
+void InstancedMeshes::UpdateInstances(int instancesID, const INSTANCE_DATA* instances, int instanceCount)
+{
+	GLInstances& buffer = m_instances[instancesID];
+
+	glBindBuffer(GL_ARRAY_BUFFER, buffer.vbo);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(INSTANCE_DATA) * instanceCount, instances, GL_DYNAMIC_DRAW);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	buffer.nInstances = instanceCount;
+}
+
+/***********************************************************
+ *  DrawMeshInstanced()
+ *
+ *  This method is used for drawing every instance in an
+ *  instance buffer with one draw call.
+ ***********************************************************/
+void InstancedMeshes::DrawMeshInstanced(int instancesID)
+{
+	const GLInstances& instances = m_instances[instancesID];
+
+	glBindVertexArray(instances.vao);
+	glDrawElementsInstanced(GL_TRIANGLES, instances.nIndices, GL_UNSIGNED_SHORT, nullptr, instances.nInstances);
+	glBindVertexArray(0);
+}
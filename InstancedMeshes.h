@@ -0,0 +1,74 @@
+///////////////////////////////////////////////////////////////////////////////
+// instancedmeshes.h
+// ============
+// draw many copies of a basic shape mesh with a single instanced draw call
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include <vector>
+
+/***********************************************************
+ *  InstancedMeshes
+ *
+ *  This class contains the box and plane meshes together
+ *  with instance buffers that hold a model matrix and a
+ *  color for every drawn copy of the mesh.
+ ***********************************************************/
+class InstancedMeshes
+{
+public:
+	// constructor
+	InstancedMeshes();
+	// destructor
+	~InstancedMeshes();
+
+	// per-instance data, matches the vertex shader inputs
+	// at attribute locations 3 to 7
+	struct INSTANCE_DATA
+	{
+		glm::mat4 model;
+		glm::vec4 color;
+	};
+
+	// load the meshes that can be drawn instanced
+	void LoadBoxMesh();
+	void LoadPlaneMesh();
+
+	// create an instance buffer for the box or plane mesh,
+	// returns the ID used to update and draw it
+	int CreateBoxInstances(int instanceCount);
+	int CreatePlaneInstances(int instanceCount);
+	// upload the per-instance data into an instance buffer
+	void UpdateInstances(int instancesID, const INSTANCE_DATA* instances, int instanceCount);
+	// draw every instance in an instance buffer
+	void DrawMeshInstanced(int instancesID);
+
+private:
+	struct GLMesh
+	{
+		GLuint vbos[2];
+		GLuint nIndices;
+	};
+
+	struct GLInstances
+	{
+		GLuint vao;
+		GLuint vbo;
+		GLuint nIndices;
+		GLsizei nInstances;
+	};
+
+	GLMesh m_BoxMesh;
+	GLMesh m_PlaneMesh;
+	std::vector<GLInstances> m_instances;
+
+	// upload the vertex and index data of a mesh
+	void CreateMesh(GLMesh& mesh, const GLfloat* verts, int nVerts, const GLushort* indices, int nIndices);
+	// create the vertex array for an instance buffer of a mesh
+	int CreateInstances(const GLMesh& mesh, int instanceCount);
+};
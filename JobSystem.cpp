@@ -0,0 +1,558 @@
+///////////////////////////////////////////////////////////////////////////////
+// jobsystem.cpp
+// ============
+// run the per-frame work as jobs on worker threads that steal from each
+// other
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "JobSystem.h"
+
+#include <algorithm>
+#include <new>
+
+// declare the global variables
+namespace
+{
+	// jobs a deque holds, a power of two
+	const int64_t g_DequeCapacity = 4096;
+	const int64_t g_DequeMask = g_DequeCapacity - 1;
+	// times an idle worker looks for a job before it sleeps
+	const int g_IdleSpins = 64;
+
+	// worker the calling thread runs as, every thread that is
+	// not a worker thread submits as worker 0
+	thread_local int t_workerIndex = 0;
+
+	typedef std::chrono::steady_clock JOB_CLOCK;
+}
+
+/***********************************************************
+ *  JobSystem()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+JobSystem::JobSystem()
+{
+	m_queuedJobs.store(0);
+	m_sleepingWorkers.store(0);
+	m_bStopping.store(false);
+	m_stageStartTime = JOB_CLOCK::now();
+	m_pFrameArena = nullptr;
+}
+
+/***********************************************************
+ *  ~JobSystem()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+JobSystem::~JobSystem()
+{
+	Stop();
+}
+
+/***********************************************************
+ *  Start()
+ *
+ *  This method is used for creating the deques and starting
+ *  the worker threads.  The first deque belongs to the
+ *  submitting thread, which has no thread of its own here.
+ ***********************************************************/
+void JobSystem::Start(int workerThreads)
+{
+	if (m_workers.empty() == false)
+	{
+		return;
+	}
+
+	if (workerThreads <= 0)
+	{
+		workerThreads = std::max(0, (int)std::thread::hardware_concurrency() - 1);
+	}
+
+	m_bStopping.store(false);
+	for (int i = 0; i <= workerThreads; i++)
+	{
+		std::unique_ptr<WORKER> worker(new WORKER());
+		worker->jobs.reset(new std::atomic<JOB*>[g_DequeCapacity]);
+		worker->top.store(0);
+		worker->bottom.store(0);
+		worker->jobsRun.store(0);
+		worker->steals.store(0);
+		worker->busyNanoseconds.store(0);
+		m_workers.push_back(std::move(worker));
+	}
+	for (int i = 1; i <= workerThreads; i++)
+	{
+		m_workers[i]->thread = std::thread(&JobSystem::WorkerLoop, this, i);
+	}
+}
+
+/***********************************************************
+ *  Stop()
+ *
+ *  This method is used for stopping the worker threads once
+ *  they are done with their jobs.
+ ***********************************************************/
+void JobSystem::Stop()
+{
+	if (m_workers.empty() == true)
+	{
+		return;
+	}
+
+	m_bStopping.store(true);
+	{
+		std::lock_guard<std::mutex> lock(m_wakeMutex);
+	}
+	m_wake.notify_all();
+
+	for (std::unique_ptr<WORKER>& worker : m_workers)
+	{
+		if (worker->thread.joinable() == true)
+		{
+			worker->thread.join();
+		}
+	}
+	m_workers.clear();
+}
+
+/***********************************************************
+ *  Run()
+ *
+ *  This method is used for queueing a job on the calling
+ *  thread's deque.  A job whose dependency is not done yet
+ *  is kept with the dependency, and queued by the job that
+ *  counts it down to zero.
+ ***********************************************************/
+void JobSystem::Run(JOB& job)
+{
+	if (job.pCounter != nullptr)
+	{
+		job.pCounter->pending.fetch_add(1);
+	}
+
+	if (job.pDependency != nullptr)
+	{
+		std::lock_guard<std::mutex> lock(job.pDependency->mutex);
+		if (job.pDependency->pending.load() > 0)
+		{
+			job.pNextWaiting = job.pDependency->pWaiting;
+			job.pDependency->pWaiting = &job;
+			return;
+		}
+	}
+
+	Queue(t_workerIndex, &job);
+	WakeWorkers();
+}
+
+/***********************************************************
+ *  Wait()
+ *
+ *  This method is used for running jobs, of any counter,
+ *  until the passed in counter reaches zero.  The counter
+ *  lock is taken once at the end, so the job that counted
+ *  it down is done with it before it can be destroyed.
+ ***********************************************************/
+void JobSystem::Wait(JOB_COUNTER& counter)
+{
+	const int workerIndex = t_workerIndex;
+
+	while (counter.pending.load(std::memory_order_acquire) > 0)
+	{
+		JOB* pJob = (m_workers.empty() == false) ? FindJob(workerIndex) : nullptr;
+		if (pJob != nullptr)
+		{
+			Execute(workerIndex, pJob);
+		}
+		else
+		{
+			std::this_thread::yield();
+		}
+	}
+
+	std::lock_guard<std::mutex> lock(counter.mutex);
+}
+
+/***********************************************************
+ *  ParallelFor()
+ *
+ *  This method is used for calling a function for every
+ *  range of grain items.  The ranges after the first are
+ *  pushed last to first, so the submitting thread pops them
+ *  in order while the thieves take the far end, and the
+ *  submitting thread runs the first range itself.
+ ***********************************************************/
+void JobSystem::ParallelFor(int count, int grain, const std::function<void(int, int)>& function)
+{
+	if (count <= 0)
+	{
+		return;
+	}
+
+	grain = std::max(1, grain);
+	const int jobCount = (count + grain - 1) / grain;
+	JOB_COUNTER counter;
+
+	// the jobs are only needed until they are all done
+	std::vector<JOB> heapJobs;
+	JOB* jobs;
+	if (m_pFrameArena != nullptr)
+	{
+		jobs = m_pFrameArena->AllocateArray<JOB>(t_workerIndex, jobCount);
+		for (int i = 0; i < jobCount; i++)
+		{
+			new (&jobs[i]) JOB();
+		}
+	}
+	else
+	{
+		heapJobs.resize(jobCount);
+		jobs = heapJobs.data();
+	}
+
+	for (int i = 0; i < jobCount; i++)
+	{
+		const int first = i * grain;
+		const int last = std::min(count, first + grain);
+		jobs[i].function = [&function, first, last]() { function(first, last); };
+		jobs[i].pCounter = &counter;
+	}
+
+	if (m_workers.empty() == true)
+	{
+		// without workers every range runs here, in order
+		for (int i = 0; i < jobCount; i++)
+		{
+			jobs[i].function();
+		}
+	}
+	else
+	{
+		counter.pending.store(jobCount);
+		for (int i = jobCount - 1; i > 0; i--)
+		{
+			Queue(t_workerIndex, &jobs[i]);
+		}
+		if (jobCount > 1)
+		{
+			WakeWorkers();
+		}
+		Execute(t_workerIndex, &jobs[0]);
+		Wait(counter);
+	}
+
+	if (m_pFrameArena != nullptr)
+	{
+		for (int i = 0; i < jobCount; i++)
+		{
+			jobs[i].~JOB();
+		}
+	}
+}
+
+/***********************************************************
+ *  GetWorkerIndex()
+ *
+ *  This method is used for getting the worker the calling
+ *  thread runs as, which picks its sub-arena of a frame
+ *  arena.
+ ***********************************************************/
+int JobSystem::GetWorkerIndex()
+{
+	return(t_workerIndex);
+}
+
+/***********************************************************
+ *  BeginStage()
+ *
+ *  This method is used for keeping the totals of every
+ *  worker at the start of a stage.
+ ***********************************************************/
+void JobSystem::BeginStage()
+{
+	m_stageStart.resize(m_workers.size());
+	for (int i = 0; i < (int)m_workers.size(); i++)
+	{
+		m_stageStart[i] = GetTotals(i);
+	}
+	m_stageStartTime = JOB_CLOCK::now();
+}
+
+/***********************************************************
+ *  EndStage()
+ *
+ *  This method is used for getting what every worker did
+ *  since BeginStage(), and how long the stage took.  The
+ *  busy time over the stage time is the worker utilisation.
+ ***********************************************************/
+void JobSystem::EndStage(STAGE_STATS& stats) const
+{
+	stats.seconds = std::chrono::duration<double>(JOB_CLOCK::now() - m_stageStartTime).count();
+	stats.workers.resize(m_workers.size());
+	for (int i = 0; i < (int)m_workers.size(); i++)
+	{
+		const WORKER_STATS totals = GetTotals(i);
+		const WORKER_STATS start = (i < (int)m_stageStart.size()) ? m_stageStart[i] : WORKER_STATS();
+		stats.workers[i].jobs = totals.jobs - start.jobs;
+		stats.workers[i].steals = totals.steals - start.steals;
+		stats.workers[i].busySeconds = totals.busySeconds - start.busySeconds;
+	}
+}
+
+/***********************************************************
+ *  Push()
+ *
+ *  This method is used for pushing a job at the bottom of
+ *  the worker's own deque.  The release store of the bottom
+ *  publishes the job to the thieves.
+ ***********************************************************/
+bool JobSystem::Push(int workerIndex, JOB* pJob)
+{
+	WORKER& worker = *m_workers[workerIndex];
+	const int64_t bottom = worker.bottom.load(std::memory_order_relaxed);
+	const int64_t top = worker.top.load(std::memory_order_acquire);
+
+	if (bottom - top >= g_DequeCapacity)
+	{
+		return(false);
+	}
+
+	worker.jobs[bottom & g_DequeMask].store(pJob, std::memory_order_relaxed);
+	worker.bottom.store(bottom + 1, std::memory_order_release);
+
+	return(true);
+}
+
+/***********************************************************
+ *  Pop()
+ *
+ *  This method is used for taking the newest job from the
+ *  bottom of the worker's own deque.  The bottom is moved
+ *  first, so a thief sees the job gone, and the last job is
+ *  raced for with the thieves on the top.
+ ***********************************************************/
+JobSystem::JOB* JobSystem::Pop(int workerIndex)
+{
+	WORKER& worker = *m_workers[workerIndex];
+	const int64_t bottom = worker.bottom.load(std::memory_order_relaxed) - 1;
+
+	worker.bottom.store(bottom, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	int64_t top = worker.top.load(std::memory_order_relaxed);
+
+	if (top > bottom)
+	{
+		worker.bottom.store(bottom + 1, std::memory_order_relaxed);
+		return(nullptr);
+	}
+
+	JOB* pJob = worker.jobs[bottom & g_DequeMask].load(std::memory_order_relaxed);
+	if (top == bottom)
+	{
+		if (worker.top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed) == false)
+		{
+			pJob = nullptr;
+		}
+		worker.bottom.store(bottom + 1, std::memory_order_relaxed);
+	}
+
+	return(pJob);
+}
+
+/***********************************************************
+ *  Steal()
+ *
+ *  This method is used for taking the oldest job from the
+ *  top of another worker's deque, null when it is empty or
+ *  another thread took the job first.
+ ***********************************************************/
+JobSystem::JOB* JobSystem::Steal(int victimIndex)
+{
+	WORKER& victim = *m_workers[victimIndex];
+	int64_t top = victim.top.load(std::memory_order_acquire);
+
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	const int64_t bottom = victim.bottom.load(std::memory_order_acquire);
+	if (top >= bottom)
+	{
+		return(nullptr);
+	}
+
+	JOB* pJob = victim.jobs[top & g_DequeMask].load(std::memory_order_relaxed);
+	if (victim.top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed) == false)
+	{
+		return(nullptr);
+	}
+
+	return(pJob);
+}
+
+/***********************************************************
+ *  FindJob()
+ *
+ *  This method is used for finding the next job of a
+ *  worker, its own first and then from the others in turn.
+ ***********************************************************/
+JobSystem::JOB* JobSystem::FindJob(int workerIndex)
+{
+	JOB* pJob = Pop(workerIndex);
+
+	const int workerCount = (int)m_workers.size();
+	for (int i = 1; (pJob == nullptr) && (i < workerCount); i++)
+	{
+		pJob = Steal((workerIndex + i) % workerCount);
+		if (pJob != nullptr)
+		{
+			m_workers[workerIndex]->steals.fetch_add(1, std::memory_order_relaxed);
+		}
+	}
+
+	if (pJob != nullptr)
+	{
+		m_queuedJobs.fetch_sub(1);
+	}
+
+	return(pJob);
+}
+
+/***********************************************************
+ *  Queue()
+ *
+ *  This method is used for pushing a job that is ready to
+ *  run.  A full deque runs the job right away instead.
+ ***********************************************************/
+void JobSystem::Queue(int workerIndex, JOB* pJob)
+{
+	m_queuedJobs.fetch_add(1);
+	if (Push(workerIndex, pJob) == false)
+	{
+		m_queuedJobs.fetch_sub(1);
+		Execute(workerIndex, pJob);
+	}
+}
+
+/***********************************************************
+ *  Execute()
+ *
+ *  This method is used for running a job and counting down
+ *  its counter.  The counter is counted down under its lock,
+ *  so the job that reaches zero takes every job waiting for
+ *  it and queues them.  Nothing touches the job afterwards,
+ *  its owner may free it once the counter is zero.
+ ***********************************************************/
+void JobSystem::Execute(int workerIndex, JOB* pJob)
+{
+	WORKER& worker = *m_workers[workerIndex];
+	JOB_COUNTER* pCounter = pJob->pCounter;
+	const JOB_CLOCK::time_point start = JOB_CLOCK::now();
+
+	pJob->function();
+
+	worker.busyNanoseconds.fetch_add(
+		(uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(JOB_CLOCK::now() - start).count(),
+		std::memory_order_relaxed);
+	worker.jobsRun.fetch_add(1, std::memory_order_relaxed);
+
+	if (pCounter == nullptr)
+	{
+		return;
+	}
+
+	JOB* pWaiting = nullptr;
+	{
+		std::lock_guard<std::mutex> lock(pCounter->mutex);
+		if (pCounter->pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+		{
+			pWaiting = pCounter->pWaiting;
+			pCounter->pWaiting = nullptr;
+		}
+	}
+
+	if (pWaiting != nullptr)
+	{
+		while (pWaiting != nullptr)
+		{
+			JOB* pNext = pWaiting->pNextWaiting;
+			pWaiting->pNextWaiting = nullptr;
+			Queue(workerIndex, pWaiting);
+			pWaiting = pNext;
+		}
+		WakeWorkers();
+	}
+}
+
+/***********************************************************
+ *  WakeWorkers()
+ *
+ *  This method is used for waking the sleeping workers.  A
+ *  worker counts itself as sleeping before it checks for
+ *  queued jobs, so either it sees the new jobs or it is seen
+ *  here and woken.
+ ***********************************************************/
+void JobSystem::WakeWorkers()
+{
+	if (m_sleepingWorkers.load() == 0)
+	{
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_wakeMutex);
+	}
+	m_wake.notify_all();
+}
+
+/***********************************************************
+ *  WorkerLoop()
+ *
+ *  This method is used for running jobs on a worker thread
+ *  until the system is stopped, sleeping after a while
+ *  without finding any.
+ ***********************************************************/
+void JobSystem::WorkerLoop(int workerIndex)
+{
+	int idleCount = 0;
+
+	t_workerIndex = workerIndex;
+	while (m_bStopping.load() == false)
+	{
+		JOB* pJob = FindJob(workerIndex);
+		if (pJob != nullptr)
+		{
+			Execute(workerIndex, pJob);
+			idleCount = 0;
+			continue;
+		}
+
+		if (++idleCount < g_IdleSpins)
+		{
+			std::this_thread::yield();
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(m_wakeMutex);
+		m_sleepingWorkers.fetch_add(1);
+		m_wake.wait(lock, [this]() { return (m_queuedJobs.load() > 0) || (m_bStopping.load() == true); });
+		m_sleepingWorkers.fetch_sub(1);
+		idleCount = 0;
+	}
+}
+
+/***********************************************************
+ *  GetTotals()
+ *
+ *  This method is used for reading the totals of a worker.
+ ***********************************************************/
+JobSystem::WORKER_STATS JobSystem::GetTotals(int workerIndex) const
+{
+	const WORKER& worker = *m_workers[workerIndex];
+	WORKER_STATS totals;
+
+	totals.jobs = (int)worker.jobsRun.load(std::memory_order_relaxed);
+	totals.steals = (int)worker.steals.load(std::memory_order_relaxed);
+	totals.busySeconds = (double)worker.busyNanoseconds.load(std::memory_order_relaxed) / 1.0e9;
+
+	return(totals);
+}
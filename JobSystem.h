@@ -0,0 +1,164 @@
+///////////////////////////////////////////////////////////////////////////////
+// jobsystem.h
+// ============
+// run the per-frame work as jobs on worker threads that steal from each
+// other
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "FrameArena.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/***********************************************************
+ *  JobSystem
+ *
+ *  This class keeps a few worker threads running jobs.
+ *  Every worker, and the thread that submits the jobs, owns
+ *  a Chase-Lev deque: the owner pushes and pops jobs at the
+ *  bottom without locks, and a worker that runs out of jobs
+ *  steals from the top of another deque.  Idle workers
+ *  sleep until jobs are pushed.
+ *
+ *  Jobs count down a counter when they finish, and a job
+ *  can wait for another counter to reach zero before it is
+ *  started.  Waiting on a counter runs other jobs meanwhile.
+ *  ParallelFor() splits a range into jobs of a grain size.
+ *
+ *  Jobs are submitted from one thread at a time, which acts
+ *  as worker 0 while it waits.  Every worker counts the jobs
+ *  it ran, the ones it stole and the time it was busy, and
+ *  BeginStage() / EndStage() report them for a stage.
+ *
+ *  With a frame arena set, the jobs of a ParallelFor() live
+ *  in the sub-arena of the calling worker, not on the heap.
+ ***********************************************************/
+class JobSystem
+{
+public:
+	struct JOB_COUNTER;
+
+	struct JOB
+	{
+		std::function<void()> function;
+		// counted down when the job is done, may be null
+		JOB_COUNTER* pCounter = nullptr;
+		// the job is started once this reaches zero, may be null
+		JOB_COUNTER* pDependency = nullptr;
+		// next job waiting for the same dependency
+		JOB* pNextWaiting = nullptr;
+	};
+
+	// number of jobs still to finish, with the jobs waiting
+	// for it to reach zero
+	struct JOB_COUNTER
+	{
+		std::atomic<int> pending{ 0 };
+		std::mutex mutex;
+		JOB* pWaiting = nullptr;
+	};
+
+	struct WORKER_STATS
+	{
+		int jobs = 0;
+		int steals = 0;
+		double busySeconds = 0.0;
+	};
+
+	// what the workers did during a stage, worker 0 is the
+	// submitting thread
+	struct STAGE_STATS
+	{
+		double seconds = 0.0;
+		std::vector<WORKER_STATS> workers;
+	};
+
+	// constructor
+	JobSystem();
+	// destructor
+	~JobSystem();
+
+	// start the worker threads, one less than the hardware
+	// threads when 0 is passed in
+	void Start(int workerThreads = 0);
+	// stop and join the worker threads
+	void Stop();
+	// workers including the submitting thread
+	int GetWorkerCount() const { return (int)m_workers.size(); }
+	// worker the calling thread runs as, 0 when it is not a
+	// worker thread
+	static int GetWorkerIndex();
+	// take the jobs of ParallelFor() from a frame arena with
+	// a sub-arena per worker, null for the heap
+	void SetFrameArena(FrameArena* pArena) { m_pFrameArena = pArena; }
+
+	// queue a job, it must stay alive until its counter is
+	// waited on
+	void Run(JOB& job);
+	// run jobs until the counter reaches zero
+	void Wait(JOB_COUNTER& counter);
+	// call the function for ranges of at most grain items,
+	// in parallel, and return once all of them are done -
+	// a lambda that captures more than two pointers does not
+	// fit in a std::function and is copied to the heap
+	void ParallelFor(int count, int grain, const std::function<void(int, int)>& function);
+
+	// count what the workers do from here until EndStage()
+	void BeginStage();
+	void EndStage(STAGE_STATS& stats) const;
+
+private:
+	struct WORKER
+	{
+		// Chase-Lev deque, the owner works at the bottom and
+		// the thieves at the top
+		std::unique_ptr<std::atomic<JOB*>[]> jobs;
+		std::atomic<int64_t> top;
+		std::atomic<int64_t> bottom;
+		// totals since the start, only written by the worker
+		std::atomic<uint64_t> jobsRun;
+		std::atomic<uint64_t> steals;
+		std::atomic<uint64_t> busyNanoseconds;
+		std::thread thread;
+	};
+
+	std::vector<std::unique_ptr<WORKER>> m_workers;
+	// jobs in the deques, workers sleep while there are none
+	std::atomic<int> m_queuedJobs;
+	std::atomic<int> m_sleepingWorkers;
+	std::atomic<bool> m_bStopping;
+	std::mutex m_wakeMutex;
+	std::condition_variable m_wake;
+	FrameArena* m_pFrameArena;
+	// totals and time at the start of the stage
+	std::vector<WORKER_STATS> m_stageStart;
+	std::chrono::steady_clock::time_point m_stageStartTime;
+
+	// deque operations, false when the deque is full
+	bool Push(int workerIndex, JOB* pJob);
+	JOB* Pop(int workerIndex);
+	JOB* Steal(int victimIndex);
+	// pop a job of the worker's own, or steal one
+	JOB* FindJob(int workerIndex);
+	// queue a job whose dependency is done, running it here
+	// when the deque is full
+	void Queue(int workerIndex, JOB* pJob);
+	// run a job and count down its counter
+	void Execute(int workerIndex, JOB* pJob);
+	// wake the sleeping workers after jobs were queued
+	void WakeWorkers();
+	// the loop run by every worker thread
+	void WorkerLoop(int workerIndex);
+	// totals of a worker so far
+	WORKER_STATS GetTotals(int workerIndex) const;
+};
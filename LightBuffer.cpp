@@ -0,0 +1,142 @@
+///////////////////////////////////////////////////////////////////////////////
+// lightbuffer.cpp
+// ============
+// keep the scene light sources in a uniform buffer, uploading only the
+// lights that changed
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "LightBuffer.h"
+
+#include <algorithm>
+#include <iostream>
+
+// declare the global variables
+namespace
+{
+	// size of the ivec4 that holds the light count at the
+	// start of the light block
+	const GLintptr g_LightHeaderSize = 16;
+}
+
+/***********************************************************
+ *  LightBuffer()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+LightBuffer::LightBuffer()
+{
+	m_lightCount = 0;
+	m_bCountDirty = false;
+	m_firstDirtyLight = 0;
+	m_lastDirtyLight = -1;
+}
+
+/***********************************************************
+ *  Create()
+ *
+ *  This method is used for creating the light block for up
+ *  to the passed in number of lights, all set to black, and
+ *  binding it to its uniform block binding point.
+ ***********************************************************/
+void LightBuffer::Create(GLuint bindingPoint, int capacity)
+{
+	LIGHT_DATA emptyLight;
+	emptyLight.positionFocalStrength = glm::vec4(0.0f);
+	emptyLight.ambientColorIntensity = glm::vec4(0.0f);
+	emptyLight.diffuseColor = glm::vec4(0.0f);
+	emptyLight.specularColor = glm::vec4(0.0f);
+
+	m_lights.assign(capacity, emptyLight);
+	m_lightCount = 0;
+
+	m_buffer.Create(
+		bindingPoint,
+		g_LightHeaderSize + (GLsizeiptr)(m_lights.size() * sizeof(LIGHT_DATA)),
+		NULL);
+
+	// the whole block is uploaded the first time
+	m_bCountDirty = true;
+	m_firstDirtyLight = 0;
+	m_lastDirtyLight = capacity - 1;
+}
+
+/***********************************************************
+ *  SetLight()
+ *
+ *  This method is used for changing the light source at the
+ *  passed in index and adding it to the dirty range.
+ ***********************************************************/
+void LightBuffer::SetLight(int index, const LIGHT_SOURCE& light)
+{
+	if ((index < 0) || (index >= (int)m_lights.size()))
+	{
+		std::cout << "Light index is out of range:" << index << std::endl;
+		return;
+	}
+
+	LIGHT_DATA& data = m_lights[index];
+	data.positionFocalStrength = glm::vec4(light.position, light.focalStrength);
+	data.ambientColorIntensity = glm::vec4(light.ambientColor, light.specularIntensity);
+	data.diffuseColor = glm::vec4(light.diffuseColor, 0.0f);
+	data.specularColor = glm::vec4(light.specularColor, 0.0f);
+
+	if (m_firstDirtyLight > m_lastDirtyLight)
+	{
+		m_firstDirtyLight = index;
+		m_lastDirtyLight = index;
+	}
+	else
+	{
+		m_firstDirtyLight = std::min(m_firstDirtyLight, index);
+		m_lastDirtyLight = std::max(m_lastDirtyLight, index);
+	}
+}
+
+/***********************************************************
+ *  SetLightCount()
+ *
+ *  This method is used for changing how many lights, from
+ *  the start of the buffer, the shader adds up.
+ ***********************************************************/
+void LightBuffer::SetLightCount(int lightCount)
+{
+	if ((lightCount < 0) || (lightCount > (int)m_lights.size()))
+	{
+		std::cout << "Light count is out of range:" << lightCount << std::endl;
+		return;
+	}
+
+	if (lightCount != m_lightCount)
+	{
+		m_lightCount = lightCount;
+		m_bCountDirty = true;
+	}
+}
+
+/***********************************************************
+ *  Upload()
+ *
+ *  This method is used for uploading the light count when it
+ *  changed and the range of lights that changed since the
+ *  last upload.  Nothing is sent when nothing changed.
+ ***********************************************************/
+void LightBuffer::Upload()
+{
+	if (m_bCountDirty == true)
+	{
+		GLint header[4] = { m_lightCount, 0, 0, 0 };
+		m_buffer.Update(0, g_LightHeaderSize, header);
+		m_bCountDirty = false;
+	}
+
+	if (m_firstDirtyLight <= m_lastDirtyLight)
+	{
+		m_buffer.Update(
+			g_LightHeaderSize + (GLintptr)(m_firstDirtyLight * sizeof(LIGHT_DATA)),
+			(GLsizeiptr)((m_lastDirtyLight - m_firstDirtyLight + 1) * sizeof(LIGHT_DATA)),
+			&m_lights[m_firstDirtyLight]);
+		m_firstDirtyLight = 0;
+		m_lastDirtyLight = -1;
+	}
+}
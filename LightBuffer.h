@@ -0,0 +1,83 @@
+///////////////////////////////////////////////////////////////////////////////
+// lightbuffer.h
+// ============
+// keep the scene light sources in a uniform buffer, uploading only the
+// lights that changed
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "UniformBuffer.h"
+
+#include <glm/glm.hpp>
+
+#include <vector>
+
+/***********************************************************
+ *  LightBuffer
+ *
+ *  This class holds a CPU copy of the light block that is
+ *  read by the fragment shader.  Changing a light only marks
+ *  it dirty, and Upload() sends the one byte range that
+ *  covers all the dirty lights with glBufferSubData.  The
+ *  block layout is std140:
+ *
+ *    ivec4     light count in x
+ *    LightData lights[capacity], four vec4 rows each
+ ***********************************************************/
+class LightBuffer
+{
+public:
+	// constructor
+	LightBuffer();
+
+	struct LIGHT_SOURCE
+	{
+		glm::vec3 position;
+		glm::vec3 ambientColor;
+		glm::vec3 diffuseColor;
+		glm::vec3 specularColor;
+		float focalStrength;
+		float specularIntensity;
+	};
+
+	// create the buffer for up to the passed in number of lights
+	void Create(GLuint bindingPoint, int capacity);
+	// change a light source, it is uploaded with the next Upload()
+	void SetLight(int index, const LIGHT_SOURCE& light);
+	// change how many of the lights the shader uses
+	void SetLightCount(int lightCount);
+	// upload the changed part of the buffer
+	void Upload();
+
+	int GetLightCount() const { return m_lightCount; }
+	int GetCapacity() const { return (int)m_lights.size(); }
+
+private:
+	// std140 layout of a light in the light block
+	struct LIGHT_DATA
+	{
+		// xyz position, w focal strength
+		glm::vec4 positionFocalStrength;
+		// rgb ambient color, w specular intensity
+		glm::vec4 ambientColorIntensity;
+		// rgb diffuse color, w unused
+		glm::vec4 diffuseColor;
+		// rgb specular color, w unused
+		glm::vec4 specularColor;
+	};
+
+	// uniform buffer holding the light block
+	UniformBuffer m_buffer;
+	// CPU copy of the lights in the block
+	std::vector<LIGHT_DATA> m_lights;
+	// number of lights the shader uses
+	int m_lightCount;
+	// set when the light count needs to be uploaded
+	bool m_bCountDirty;
+	// range of lights that need to be uploaded, empty
+	// when the first dirty light is past the last one
+	int m_firstDirtyLight;
+	int m_lastDirtyLight;
+};
@@ -1,5 +1,12 @@
 #include <iostream>         // error handling and output
 #include <cstdlib>          // EXIT_FAILURE
+#include <sstream>          // frame statistics text
+#include <string>           // command line arguments
+#include <algorithm>        // update tick pacing
+#include <chrono>           // update tick pacing
+#include <iomanip>          // benchmark table
+#include <mutex>            // window title handed to the update thread
+#include <thread>           // update tick pacing
 
 #include <GL/glew.h>        // GLEW library
 #include "GLFW/glfw3.h"     // GLFW library
@@ -13,6 +20,14 @@
 #include "ViewManager.h"
 #include "ShapeMeshes.h"
 #include "ShaderManager.h"
+#include "ShaderUniforms.h"
+#include "RenderState.h"
+#include "BVHBenchmark.h"
+#include "TransformBenchmark.h"
+#include "PrepassBenchmark.h"
+#include "AllocationCheck.h"
+#include "SnapshotBuffer.h"
+#include "RenderThread.h"
 
 // Namespace for declaring global variables
 namespace
@@ -27,14 +42,67 @@ namespace
 	SceneManager* g_SceneManager = nullptr;
 	// shader manager object for dynamic interaction with the shader code
 	ShaderManager* g_ShaderManager = nullptr;
+	// reflected shader uniforms, set through handles while rendering
+	ShaderUniforms* g_ShaderUniforms = nullptr;
+	// shadowed GL state, drops the state calls that change nothing
+	RenderState g_RenderState;
 	// view manager object for managing the 3D view setup and projection to 2D
 	ViewManager* g_ViewManager = nullptr;
+
+	// time of the last frame statistics refresh, in seconds
+	double g_LastStatsTime = 0.0;
+	// frames rendered since the last statistics refresh
+	int g_StatsFrameCount = 0;
+	// title built by the rendering thread, set into the
+	// window by the update thread
+	std::mutex g_TitleMutex;
+	std::string g_PendingTitle;
+
+	// snapshots of the update thread drawn by the render
+	// thread, and the number of the next snapshot
+	SnapshotBuffer g_Snapshots;
+	RenderThread g_RenderThread;
+	uint64_t g_UpdateNumber = 0;
+	// update ticks per second while the render thread draws
+	const double g_UpdateRate = 240.0;
+
+	// viewport size last set by the rendering thread
+	int g_ViewportWidth = 0;
+	int g_ViewportHeight = 0;
+	// summed time between taking a snapshot and drawing it,
+	// read once the rendering has stopped
+	double g_SnapshotAgeTotal = 0.0;
+
+	// set when the job statistics of every stage are printed
+	// with the frame statistics
+	bool g_bPrintJobStats = false;
+
+	// seconds every loop runs for in the render thread benchmark
+	const double g_BenchmarkSeconds = 5.0;
+
+	// what a main loop got through while it ran
+	struct LOOP_STATS
+	{
+		int frames = 0;
+		int updates = 0;
+		double seconds = 0.0;
+		// mean time from taking a snapshot to drawing it
+		double snapshotAge = 0.0;
+	};
 }
 
 // Function declarations - all functions that are called manually
 // need to be pre-declared at the beginning of the source code.
 bool InitializeGLFW();
 bool InitializeGLEW();
+void ShowFrameStats();
+void PrintJobStats();
+void UpdateWindowTitle();
+void TakeSnapshot(SnapshotBuffer::FRAME_SNAPSHOT& snapshot);
+void RenderFrame(const SnapshotBuffer::FRAME_SNAPSHOT& snapshot);
+LOOP_STATS RunSingleThreadLoop(double duration);
+LOOP_STATS RunRenderThreadLoop(double duration);
+void RunRenderThreadBenchmark();
 
 
 /***********************************************************
@@ -45,6 +113,19 @@ bool InitializeGLEW();
  ***********************************************************/
 int main(int argc, char* argv[])
 {
+	// the BVH benchmark runs on the CPU only, without a window
+	if ((argc > 1) && (std::string(argv[1]) == "--bvh-benchmark"))
+	{
+		RunBVHBenchmark();
+		return(EXIT_SUCCESS);
+	}
+	// so does the benchmark of the local matrix kernels
+	if ((argc > 1) && (std::string(argv[1]) == "--transform-benchmark"))
+	{
+		RunTransformBenchmark();
+		return(EXIT_SUCCESS);
+	}
+
 	// if GLFW fails initialization, then terminate the application
 	if (InitializeGLFW() == false)
 	{
@@ -68,37 +149,58 @@ int main(int argc, char* argv[])
 
 	// load the shader code from the external GLSL files
 	g_ShaderManager->LoadShaders(
-		"../../Utilities/shaders/vertexShader.glsl",
-		"../../Utilities/shaders/fragmentShader.glsl");
+		"shaders/vertexShader.glsl",
+		"shaders/fragmentShader.glsl");
 	g_ShaderManager->use();
 
+	// look up the active shader uniforms once
+	g_ShaderUniforms = new ShaderUniforms();
+	g_ShaderUniforms->ReflectUniforms();
+	g_ViewManager->SetShaderUniforms(g_ShaderUniforms);
+
 	// try to create a new scene manager object and prepare the 3D scene
-	g_SceneManager = new SceneManager(g_ShaderManager);
+	g_SceneManager = new SceneManager(g_ShaderManager, g_ShaderUniforms, &g_RenderState);
 	g_SceneManager->PrepareScene();
 
-	// loop will keep running until the application is closed 
-	// or until an error has occurred
-	while (!glfwWindowShouldClose(g_Window))
+	// the pre-pass benchmark draws the prepared scene
+	// offscreen and exits
+	if ((argc > 1) && (std::string(argv[1]) == "--prepass-benchmark"))
 	{
-		// Enable z-depth
-		glEnable(GL_DEPTH_TEST);
-
-		// Clear the frame and z buffers
-		glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
-		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-
-		// convert from 3D object space to 2D view
-		g_ViewManager->PrepareSceneView();
+		RunPrepassBenchmark(g_SceneManager, g_ViewManager, &g_RenderState);
+		glfwSetWindowShouldClose(g_Window, GL_TRUE);
+	}
 
-		// refresh the 3D scene
-		g_SceneManager->RenderScene();
+	// the allocation check renders the prepared scene and
+	// exits, failing when a warm frame used the heap
+	bool bAllocationCheckFailed = false;
+	if ((argc > 1) && (std::string(argv[1]) == "--allocation-check"))
+	{
+		bAllocationCheckFailed = (RunAllocationCheck(g_SceneManager, g_ViewManager, &g_RenderState) == false);
+		glfwSetWindowShouldClose(g_Window, GL_TRUE);
+	}
 
+	// the job statistics of the stages go to the console
+	g_bPrintJobStats = (argc > 1) && (std::string(argv[1]) == "--job-stats");
 
-		// Flips the the back buffer with the front buffer every frame.
-		glfwSwapBuffers(g_Window);
+	// the render thread benchmark times both main loops and
+	// exits
+	if ((argc > 1) && (std::string(argv[1]) == "--render-thread-benchmark"))
+	{
+		RunRenderThreadBenchmark();
+		glfwSetWindowShouldClose(g_Window, GL_TRUE);
+	}
 
-		// query the latest GLFW events
-		glfwPollEvents();
+	// the loops keep running until the application is closed
+	// or until an error has occurred - the input is handled on
+	// this thread while a render thread draws, unless a single
+	// thread is asked for
+	if ((argc > 1) && (std::string(argv[1]) == "--single-thread"))
+	{
+		RunSingleThreadLoop(0.0);
+	}
+	else
+	{
+		RunRenderThreadLoop(0.0);
 	}
 
 	// clear the allocated manager objects from memory
@@ -112,14 +214,20 @@ int main(int argc, char* argv[])
 		delete g_ViewManager;
 		g_ViewManager = NULL;
 	}
+	if (NULL != g_ShaderUniforms)
+	{
+		delete g_ShaderUniforms;
+		g_ShaderUniforms = NULL;
+	}
 	if (NULL != g_ShaderManager)
 	{
 		delete g_ShaderManager;
 		g_ShaderManager = NULL;
 	}
 
-	// Terminates the program successfully
-	exit(EXIT_SUCCESS); 
+	// Terminates the program, unsuccessfully when the
+	// allocation check found heap allocations
+	exit((bAllocationCheckFailed == true) ? EXIT_FAILURE : EXIT_SUCCESS); 
 }
 
 /***********************************************************
@@ -174,4 +282,296 @@ bool InitializeGLEW()
 	std::cout << "INFO: OpenGL Version: " << glGetString(GL_VERSION) << "\n" << std::endl;
 
 	return(true);
-}
\ No newline at end of file
+}
+
+/***********************************************************
+ *	ShowFrameStats()
+ *
+ *  This function is used to show the frame rate and the
+ *  statistics of the last rendered frame in the window
+ *  title, refreshed once per second.  It runs on the thread
+ *  that renders, the title is set by UpdateWindowTitle().
+ ***********************************************************/
+void ShowFrameStats()
+{
+	g_StatsFrameCount++;
+
+	double currentTime = glfwGetTime();
+	double elapsedTime = currentTime - g_LastStatsTime;
+	if (elapsedTime < 1.0)
+	{
+		return;
+	}
+
+	const SceneManager::FRAME_STATS& stats = g_SceneManager->GetFrameStats();
+	const ShaderUniforms::UNIFORM_STATS& uniformStats = g_ShaderUniforms->GetStats();
+	const RenderState::STATE_STATS& stateStats = g_RenderState.GetStats();
+
+	// share of the stage time the workers were busy, and the
+	// jobs they stole, over all the per-frame stages
+	double stageSeconds = 0.0;
+	double busySeconds = 0.0;
+	int steals = 0;
+	int workerCount = 0;
+	for (int stage = 0; stage < SceneManager::STAGE_COUNT; stage++)
+	{
+		const JobSystem::STAGE_STATS& stageStats = g_SceneManager->GetStageStats(stage);
+		stageSeconds += stageStats.seconds;
+		workerCount = (int)stageStats.workers.size();
+		for (const JobSystem::WORKER_STATS& worker : stageStats.workers)
+		{
+			busySeconds += worker.busySeconds;
+			steals += worker.steals;
+		}
+	}
+	const int busyPercent = (stageSeconds > 0.0) ? (int)(100.0 * busySeconds / (stageSeconds * workerCount)) : 0;
+
+	std::ostringstream title;
+	title << WINDOW_TITLE
+		<< " - fps: " << (int)(g_StatsFrameCount / elapsedTime)
+		<< ", draw calls: " << stats.drawCalls
+		<< " (" << stats.drawCommands << " indirect)"
+		<< ", state changes: " << stats.stateChangesUnsorted << " -> " << stats.stateChanges
+		<< ", visible/culled: " << stats.objectsVisible << "/" << stats.objectsCulled
+		<< " (" << stats.objectsOccluded << " occluded)"
+		<< ", transparent: " << stats.transparentDraws
+		<< ", depth pre-pass: " << stats.prepassCommands
+		<< ", reduced LOD: " << stats.objectsReduced
+		<< ", indices: " << stats.indicesDrawn
+		<< ", matrices rebuilt: " << stats.matricesRecomputed
+		<< ", jobs: " << workerCount << " workers " << busyPercent << "% busy, " << steals << " steals"
+		<< ", uniforms set/elided: " << uniformStats.issued << "/" << uniformStats.elided
+		<< ", GL state set/elided: " << stateStats.issued << "/" << stateStats.elided;
+
+	if (g_bPrintJobStats == true)
+	{
+		PrintJobStats();
+	}
+
+	// only the main thread may set the title
+	std::lock_guard<std::mutex> lock(g_TitleMutex);
+	g_PendingTitle = title.str();
+
+	g_LastStatsTime = currentTime;
+	g_StatsFrameCount = 0;
+}
+/***********************************************************
+ *	PrintJobStats()
+ *
+ *  This function is used to print how long every per-frame
+ *  stage of the last frame took, and for every worker the
+ *  jobs it ran, the share of the stage it was busy and the
+ *  jobs it stole.  Worker 0 is the rendering thread.
+ ***********************************************************/
+void PrintJobStats()
+{
+	std::ostringstream table;
+
+	table << "stage          ms  | worker jobs/busy%/steals" << std::endl;
+	for (int stage = 0; stage < SceneManager::STAGE_COUNT; stage++)
+	{
+		const JobSystem::STAGE_STATS& stageStats = g_SceneManager->GetStageStats(stage);
+		table << std::fixed << std::setprecision(3)
+			<< std::left << std::setw(11) << SceneManager::GetStageName(stage) << std::right
+			<< std::setw(7) << stageStats.seconds * 1000.0 << "  |";
+		for (const JobSystem::WORKER_STATS& worker : stageStats.workers)
+		{
+			const int busyPercent = (stageStats.seconds > 0.0) ? (int)(100.0 * worker.busySeconds / stageStats.seconds) : 0;
+			table << " " << worker.jobs << "/" << busyPercent << "/" << worker.steals;
+		}
+		table << std::endl;
+	}
+
+	std::cout << table.str();
+}
+
+/***********************************************************
+ *	UpdateWindowTitle()
+ *
+ *  This function is used to set the frame statistics built
+ *  by the rendering thread into the window title, on the
+ *  main thread.
+ ***********************************************************/
+void UpdateWindowTitle()
+{
+	std::string title;
+	{
+		std::lock_guard<std::mutex> lock(g_TitleMutex);
+		title.swap(g_PendingTitle);
+	}
+
+	if (title.empty() == false)
+	{
+		glfwSetWindowTitle(g_Window, title.c_str());
+	}
+}
+
+/***********************************************************
+ *	TakeSnapshot()
+ *
+ *  This function is used to move the camera with the input
+ *  and fill a snapshot with everything the next frame is
+ *  drawn with.  It makes no GL calls.
+ ***********************************************************/
+void TakeSnapshot(SnapshotBuffer::FRAME_SNAPSHOT& snapshot)
+{
+	// convert from 3D object space to 2D view
+	g_ViewManager->UpdateSceneView();
+
+	snapshot.updateNumber = g_UpdateNumber++;
+	snapshot.updateTime = glfwGetTime();
+	snapshot.view = g_ViewManager->GetViewMatrix();
+	snapshot.projection = g_ViewManager->GetProjectionMatrix();
+	snapshot.viewPosition = g_ViewManager->GetViewPosition();
+	glfwGetFramebufferSize(g_Window, &snapshot.framebufferWidth, &snapshot.framebufferHeight);
+	snapshot.bDepthPrepass = g_ViewManager->IsDepthPrepassEnabled();
+}
+
+/***********************************************************
+ *	RenderFrame()
+ *
+ *  This function is used to draw a frame from a snapshot,
+ *  on the thread that owns the GL context.
+ ***********************************************************/
+void RenderFrame(const SnapshotBuffer::FRAME_SNAPSHOT& snapshot)
+{
+	// count the issued and elided calls of this frame only
+	g_RenderState.ResetStats();
+	g_ShaderUniforms->ResetStats();
+
+	if ((snapshot.framebufferWidth != g_ViewportWidth) || (snapshot.framebufferHeight != g_ViewportHeight))
+	{
+		glViewport(0, 0, snapshot.framebufferWidth, snapshot.framebufferHeight);
+		g_ViewportWidth = snapshot.framebufferWidth;
+		g_ViewportHeight = snapshot.framebufferHeight;
+	}
+
+	// Enable z-depth
+	g_RenderState.SetDepthTest(true);
+
+	// Clear the frame and z buffers
+	g_RenderState.SetClearColor(glm::vec4(0.0f, 0.0f, 0.0f, 1.0f));
+	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+	// refresh the 3D scene, culled to the camera view
+	g_ViewManager->SetViewUniforms(snapshot.view, snapshot.projection, snapshot.viewPosition);
+	g_SceneManager->SetViewProjection(snapshot.view, snapshot.projection);
+	g_SceneManager->SetDepthPrepass(snapshot.bDepthPrepass);
+	g_SceneManager->RenderScene();
+
+	// refresh the frame statistics in the window title
+	ShowFrameStats();
+
+	g_SnapshotAgeTotal += glfwGetTime() - snapshot.updateTime;
+}
+
+/***********************************************************
+ *	RunSingleThreadLoop()
+ *
+ *  This function is used to handle the input and draw the
+ *  frames one after the other on the main thread, until
+ *  the window is closed or, when it is not 0, the passed in
+ *  number of seconds has passed.
+ ***********************************************************/
+LOOP_STATS RunSingleThreadLoop(double duration)
+{
+	LOOP_STATS loop;
+	SnapshotBuffer::FRAME_SNAPSHOT snapshot;
+	const double startTime = glfwGetTime();
+
+	g_SnapshotAgeTotal = 0.0;
+	while ((glfwWindowShouldClose(g_Window) == false) &&
+		((duration <= 0.0) || (glfwGetTime() - startTime < duration)))
+	{
+		TakeSnapshot(snapshot);
+		RenderFrame(snapshot);
+
+		// Flips the the back buffer with the front buffer every frame.
+		glfwSwapBuffers(g_Window);
+
+		// query the latest GLFW events
+		glfwPollEvents();
+		UpdateWindowTitle();
+		loop.frames++;
+	}
+
+	loop.updates = loop.frames;
+	loop.seconds = glfwGetTime() - startTime;
+	loop.snapshotAge = (loop.frames > 0) ? g_SnapshotAgeTotal / loop.frames : 0.0;
+
+	return(loop);
+}
+
+/***********************************************************
+ *	RunRenderThreadLoop()
+ *
+ *  This function is used to handle the input on the main
+ *  thread at a steady rate while the render thread draws the
+ *  newest snapshot as fast as it can, until the window is
+ *  closed or the passed in number of seconds has passed.  A
+ *  slow frame no longer holds up the input.
+ ***********************************************************/
+LOOP_STATS RunRenderThreadLoop(double duration)
+{
+	LOOP_STATS loop;
+	const double startTime = glfwGetTime();
+	double nextUpdateTime = startTime;
+
+	g_SnapshotAgeTotal = 0.0;
+	g_RenderThread.Start(g_Window, &g_Snapshots, RenderFrame);
+
+	while ((glfwWindowShouldClose(g_Window) == false) &&
+		((duration <= 0.0) || (glfwGetTime() - startTime < duration)))
+	{
+		// query the latest GLFW events
+		glfwPollEvents();
+
+		TakeSnapshot(g_Snapshots.GetWriteSnapshot());
+		g_Snapshots.Publish();
+		UpdateWindowTitle();
+		loop.updates++;
+
+		// a late tick starts the next one right away, without
+		// catching up on the missed ones
+		nextUpdateTime = std::max(nextUpdateTime + 1.0 / g_UpdateRate, glfwGetTime());
+		std::this_thread::sleep_for(std::chrono::duration<double>(nextUpdateTime - glfwGetTime()));
+	}
+
+	// the GL context is back on this thread after stopping
+	g_RenderThread.Stop();
+
+	loop.frames = g_RenderThread.GetFrameCount();
+	loop.seconds = glfwGetTime() - startTime;
+	loop.snapshotAge = (loop.frames > 0) ? g_SnapshotAgeTotal / loop.frames : 0.0;
+
+	return(loop);
+}
+
+/***********************************************************
+ *	RunRenderThreadBenchmark()
+ *
+ *  This function is used to run both main loops for a few
+ *  seconds without waiting for the vertical sync, and print
+ *  the frames drawn and the update ticks per second, and
+ *  how old a snapshot was when its frame was drawn.
+ ***********************************************************/
+void RunRenderThreadBenchmark()
+{
+	glfwSwapInterval(0);
+
+	LOOP_STATS singleThread = RunSingleThreadLoop(g_BenchmarkSeconds);
+	LOOP_STATS renderThread = RunRenderThreadLoop(g_BenchmarkSeconds);
+
+	std::cout << "loop            frames/s  updates/s  snapshot age (ms)" << std::endl;
+	const char* names[] = { "single thread", "render thread" };
+	const LOOP_STATS* loops[] = { &singleThread, &renderThread };
+	for (int i = 0; i < 2; i++)
+	{
+		const LOOP_STATS& loop = *loops[i];
+		std::cout << std::fixed << std::setprecision(2)
+			<< std::left << std::setw(14) << names[i] << std::right << "  "
+			<< std::setw(8) << loop.frames / loop.seconds << "  "
+			<< std::setw(9) << loop.updates / loop.seconds << "  "
+			<< std::setw(17) << loop.snapshotAge * 1000.0 << std::endl;
+	}
+}
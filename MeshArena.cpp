@@ -0,0 +1,832 @@
+///////////////////////////////////////////////////////////////////////////////
+// mesharena.cpp
+// ============
+// keep every basic shape mesh in one shared vertex and index buffer and
+// draw them with multi-draw indirect calls
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "MeshArena.h"
+#include "SceneFile.h"
+
+#include <cmath>
+#include <cstddef>
+#include <iostream>
+
+// declare the global variables
+namespace
+{
+	// vertex layout of the meshes, same as the basic shape meshes
+	const GLuint g_FloatsPerVertex = 3;
+	const GLuint g_FloatsPerNormal = 3;
+	const GLuint g_FloatsPerUV = 2;
+	const GLuint g_VertexStride = g_FloatsPerVertex + g_FloatsPerNormal + g_FloatsPerUV;
+
+	// attribute locations of the per-draw data
+	const GLuint g_DrawModelLocation = 3;
+	const GLuint g_DrawColorLocation = 7;
+	const GLuint g_DrawUVScaleLocation = 8;
+	const GLuint g_DrawMaterialLocation = 9;
+	const GLuint g_DrawTextureLayerLocation = 10;
+
+	// draws and commands a frame region starts out with, the
+	// rings grow when a frame needs more
+	const int g_InitialDrawCapacity = 1024;
+	const int g_InitialCommandCapacity = 256;
+
+	// tessellation of the round shapes at every level, the
+	// finest level is the one the ShapeMeshes shapes use
+	const int g_RoundSlices[MeshArena::LOD_COUNT] = { 36, 16, 8 };
+	const int g_SphereStacks[MeshArena::LOD_COUNT] = { 18, 8, 4 };
+	const int g_TorusSides[MeshArena::LOD_COUNT] = { 18, 8, 4 };
+
+	// size of the torus ring and its tube
+	const float g_TorusMainRadius = 1.0f;
+	const float g_TorusTubeRadius = 0.1f;
+
+	const float g_Pi = 3.14159265358979f;
+}
+
+/***********************************************************
+ *  MeshArena()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+MeshArena::MeshArena()
+{
+	m_vao = 0;
+	m_depthVao = 0;
+	m_vertexBuffer = 0;
+	m_positionBuffer = 0;
+	m_indexBuffer = 0;
+	m_drawCapacity = 0;
+	m_commandCapacity = 0;
+	m_meshFirstVertex = 0;
+	m_meshFirstIndex = 0;
+}
+
+/***********************************************************
+ *  ~MeshArena()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+MeshArena::~MeshArena()
+{
+	if (m_vao != 0)
+	{
+		glDeleteVertexArrays(1, &m_vao);
+		glDeleteVertexArrays(1, &m_depthVao);
+		glDeleteBuffers(1, &m_vertexBuffer);
+		glDeleteBuffers(1, &m_positionBuffer);
+		glDeleteBuffers(1, &m_indexBuffer);
+		m_vao = 0;
+		m_depthVao = 0;
+	}
+}
+
+/***********************************************************
+ *  IsSupported()
+ *
+ *  This method is used for checking that the current
+ *  context can source draw commands from a buffer, with
+ *  a base instance per command.
+ ***********************************************************/
+bool MeshArena::IsSupported()
+{
+	return((GLEW_VERSION_4_3 == GL_TRUE) ||
+		((GLEW_ARB_multi_draw_indirect == GL_TRUE) && (GLEW_ARB_base_instance == GL_TRUE)));
+}
+
+/***********************************************************
+ *  LoadMeshes()
+ *
+ *  This method is used for building every basic shape mesh
+ *  into the arena, in SCENE_MESH order, followed by the
+ *  coarser levels of the round shapes.
+ ***********************************************************/
+void MeshArena::LoadMeshes()
+{
+	m_vertices.clear();
+	m_indices.clear();
+	m_meshes.assign(MESH_COUNT, MESH_RANGE());
+	m_lodMeshes.assign(MESH_COUNT * LOD_COUNT, 0);
+
+	for (int meshID = 0; meshID < MESH_COUNT; meshID++)
+	{
+		BeginMesh();
+		BuildShape(meshID, 0);
+		EndMesh(meshID);
+		for (int lodLevel = 0; lodLevel < LOD_COUNT; lodLevel++)
+		{
+			m_lodMeshes[meshID * LOD_COUNT + lodLevel] = meshID;
+		}
+	}
+
+	for (int meshID = 0; meshID < MESH_COUNT; meshID++)
+	{
+		const bool bRound =
+			(meshID == MESH_CYLINDER) || (meshID == MESH_CONE) || (meshID == MESH_SPHERE) ||
+			(meshID == MESH_TAPERED_CYLINDER) || (meshID == MESH_TORUS);
+		if (bRound == false)
+		{
+			continue;
+		}
+
+		for (int lodLevel = 1; lodLevel < LOD_COUNT; lodLevel++)
+		{
+			int lodMeshID = (int)m_meshes.size();
+			m_meshes.push_back(MESH_RANGE());
+			BeginMesh();
+			BuildShape(meshID, lodLevel);
+			EndMesh(lodMeshID);
+			m_lodMeshes[meshID * LOD_COUNT + lodLevel] = lodMeshID;
+		}
+	}
+}
+
+/***********************************************************
+ *  BuildShape()
+ *
+ *  This method is used for building the basic shape for a
+ *  SCENE_MESH at a tessellation level, only the round
+ *  shapes differ between the levels.
+ ***********************************************************/
+void MeshArena::BuildShape(int meshID, int lodLevel)
+{
+	switch (meshID)
+	{
+	case MESH_BOX:
+		BuildBox();
+		break;
+	case MESH_PLANE:
+		BuildPlane();
+		break;
+	case MESH_CYLINDER:
+		BuildFrustum(1.0f, 1.0f, true, g_RoundSlices[lodLevel]);
+		break;
+	case MESH_CONE:
+		BuildFrustum(1.0f, 0.0f, false, g_RoundSlices[lodLevel]);
+		break;
+	case MESH_PRISM:
+		BuildPrism();
+		break;
+	case MESH_PYRAMID4:
+		BuildPyramid4();
+		break;
+	case MESH_SPHERE:
+		BuildSphere(g_RoundSlices[lodLevel], g_SphereStacks[lodLevel]);
+		break;
+	case MESH_TAPERED_CYLINDER:
+		BuildFrustum(1.0f, 0.5f, true, g_RoundSlices[lodLevel]);
+		break;
+	case MESH_TORUS:
+		BuildTorus(g_RoundSlices[lodLevel], g_TorusSides[lodLevel]);
+		break;
+	}
+}
+
+/***********************************************************
+ *  GetLodMesh()
+ *
+ *  This method is used for getting the mesh ID that draws
+ *  a basic shape at a tessellation level.  Meshes that are
+ *  not basic shapes only have the one level.
+ ***********************************************************/
+int MeshArena::GetLodMesh(int meshID, int lodLevel) const
+{
+	if ((meshID < 0) || (meshID >= MESH_COUNT) || (m_lodMeshes.empty() == true))
+	{
+		return(meshID);
+	}
+
+	return(m_lodMeshes[meshID * LOD_COUNT + lodLevel]);
+}
+
+/***********************************************************
+ *  AddMesh()
+ *
+ *  This method is used for adding a mesh to the arena after
+ *  the basic shapes.  The indices count from the first
+ *  vertex of the mesh.
+ ***********************************************************/
+int MeshArena::AddMesh(const std::vector<GLfloat>& vertices, const std::vector<GLuint>& indices)
+{
+	int meshID = (int)m_meshes.size();
+
+	m_meshes.push_back(MESH_RANGE());
+	BeginMesh();
+	m_vertices.insert(m_vertices.end(), vertices.begin(), vertices.end());
+	m_indices.insert(m_indices.end(), indices.begin(), indices.end());
+	EndMesh(meshID);
+
+	return(meshID);
+}
+
+/***********************************************************
+ *  GetMeshGeometry()
+ *
+ *  This method is used for copying the vertices and the
+ *  indices of a mesh, with the indices counting from the
+ *  first vertex of the mesh.  The data is only on the CPU
+ *  until the arena is uploaded.
+ ***********************************************************/
+void MeshArena::GetMeshGeometry(int meshID, std::vector<GLfloat>& vertices, std::vector<GLuint>& indices) const
+{
+	const MESH_RANGE& mesh = m_meshes[meshID];
+
+	vertices.clear();
+	indices.assign(
+		m_indices.begin() + mesh.firstIndex,
+		m_indices.begin() + mesh.firstIndex + mesh.indexCount);
+
+	// the vertices of a mesh run up to the next mesh
+	size_t firstFloat = (size_t)mesh.baseVertex * g_VertexStride;
+	size_t lastFloat = m_vertices.size();
+	if (meshID + 1 < (int)m_meshes.size())
+	{
+		lastFloat = (size_t)m_meshes[meshID + 1].baseVertex * g_VertexStride;
+	}
+	vertices.assign(m_vertices.begin() + firstFloat, m_vertices.begin() + lastFloat);
+}
+
+/***********************************************************
+ *  Upload()
+ *
+ *  This method is used for uploading every mesh into the
+ *  shared buffers and creating the vertex array that reads
+ *  them together with the per-draw data.  The positions are
+ *  also uploaded on their own, packed, for the vertex array
+ *  of the depth pre-pass.
+ ***********************************************************/
+void MeshArena::Upload()
+{
+	const GLsizei stride = sizeof(GLfloat) * g_VertexStride;
+
+	glGenVertexArrays(1, &m_vao);
+	glGenVertexArrays(1, &m_depthVao);
+	glGenBuffers(1, &m_vertexBuffer);
+	glGenBuffers(1, &m_positionBuffer);
+	glGenBuffers(1, &m_indexBuffer);
+
+	glBindVertexArray(m_vao);
+
+	// per-vertex attributes of every mesh in the arena
+	glBindBuffer(GL_ARRAY_BUFFER, m_vertexBuffer);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(GLfloat) * m_vertices.size(), m_vertices.data(), GL_STATIC_DRAW);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_indexBuffer);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(GLuint) * m_indices.size(), m_indices.data(), GL_STATIC_DRAW);
+	glVertexAttribPointer(0, g_FloatsPerVertex, GL_FLOAT, GL_FALSE, stride, (void*)0);
+	glEnableVertexAttribArray(0);
+	glVertexAttribPointer(1, g_FloatsPerNormal, GL_FLOAT, GL_FALSE, stride, (void*)(sizeof(GLfloat) * g_FloatsPerVertex));
+	glEnableVertexAttribArray(1);
+	glVertexAttribPointer(2, g_FloatsPerUV, GL_FLOAT, GL_FALSE, stride, (void*)(sizeof(GLfloat) * (g_FloatsPerVertex + g_FloatsPerNormal)));
+	glEnableVertexAttribArray(2);
+
+	// the depth pre-pass fetches a third of the vertex data
+	std::vector<GLfloat> positions;
+	positions.reserve((m_vertices.size() / g_VertexStride) * g_FloatsPerVertex);
+	for (size_t v = 0; v + g_VertexStride <= m_vertices.size(); v += g_VertexStride)
+	{
+		positions.insert(positions.end(), m_vertices.begin() + v, m_vertices.begin() + v + g_FloatsPerVertex);
+	}
+	glBindVertexArray(m_depthVao);
+	glBindBuffer(GL_ARRAY_BUFFER, m_positionBuffer);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(GLfloat) * positions.size(), positions.data(), GL_STATIC_DRAW);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_indexBuffer);
+	glVertexAttribPointer(0, g_FloatsPerVertex, GL_FLOAT, GL_FALSE, sizeof(GLfloat) * g_FloatsPerVertex, (void*)0);
+	glEnableVertexAttribArray(0);
+
+	glBindVertexArray(0);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	m_drawCapacity = g_InitialDrawCapacity;
+	m_drawDataRing.Create(GL_ARRAY_BUFFER, sizeof(DRAW_DATA) * m_drawCapacity);
+	SetDrawDataAttributes();
+	m_commandCapacity = g_InitialCommandCapacity;
+	m_commandRing.Create(GL_DRAW_INDIRECT_BUFFER, sizeof(DRAW_COMMAND) * m_commandCapacity);
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+
+	// the geometry only lives on the GPU from now on
+	m_vertices.clear();
+	m_vertices.shrink_to_fit();
+	m_indices.clear();
+	m_indices.shrink_to_fit();
+}
+
+/***********************************************************
+ *  SetDrawDataAttributes()
+ *
+ *  This method is used for pointing the per-draw attributes
+ *  of the vertex array at the draw data ring.  Every command
+ *  reads them from its baseInstance on, the model matrix
+ *  takes one attribute location for each of its columns.
+ *  The depth vertex array only reads the model matrix.
+ ***********************************************************/
+void MeshArena::SetDrawDataAttributes()
+{
+	const GLsizei drawStride = sizeof(DRAW_DATA);
+
+	glBindVertexArray(m_depthVao);
+	glBindBuffer(GL_ARRAY_BUFFER, m_drawDataRing.GetBuffer());
+	for (GLuint column = 0; column < 4; column++)
+	{
+		GLuint location = g_DrawModelLocation + column;
+		glVertexAttribPointer(location, 4, GL_FLOAT, GL_FALSE, drawStride, (void*)(offsetof(DRAW_DATA, model) + sizeof(glm::vec4) * column));
+		glEnableVertexAttribArray(location);
+		glVertexAttribDivisor(location, 1);
+	}
+
+	glBindVertexArray(m_vao);
+	glBindBuffer(GL_ARRAY_BUFFER, m_drawDataRing.GetBuffer());
+	for (GLuint column = 0; column < 4; column++)
+	{
+		GLuint location = g_DrawModelLocation + column;
+		glVertexAttribPointer(location, 4, GL_FLOAT, GL_FALSE, drawStride, (void*)(offsetof(DRAW_DATA, model) + sizeof(glm::vec4) * column));
+		glEnableVertexAttribArray(location);
+		glVertexAttribDivisor(location, 1);
+	}
+	glVertexAttribPointer(g_DrawColorLocation, 4, GL_FLOAT, GL_FALSE, drawStride, (void*)offsetof(DRAW_DATA, color));
+	glEnableVertexAttribArray(g_DrawColorLocation);
+	glVertexAttribDivisor(g_DrawColorLocation, 1);
+	glVertexAttribPointer(g_DrawUVScaleLocation, 2, GL_FLOAT, GL_FALSE, drawStride, (void*)offsetof(DRAW_DATA, uvScale));
+	glEnableVertexAttribArray(g_DrawUVScaleLocation);
+	glVertexAttribDivisor(g_DrawUVScaleLocation, 1);
+	glVertexAttribIPointer(g_DrawMaterialLocation, 1, GL_INT, drawStride, (void*)offsetof(DRAW_DATA, materialIndex));
+	glEnableVertexAttribArray(g_DrawMaterialLocation);
+	glVertexAttribDivisor(g_DrawMaterialLocation, 1);
+	glVertexAttribIPointer(g_DrawTextureLayerLocation, 1, GL_INT, drawStride, (void*)offsetof(DRAW_DATA, textureLayer));
+	glEnableVertexAttribArray(g_DrawTextureLayerLocation);
+	glVertexAttribDivisor(g_DrawTextureLayerLocation, 1);
+
+	glBindVertexArray(0);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+/***********************************************************
+ *  BeginFrame()
+ *
+ *  This method is used for starting a frame in the next
+ *  region of the rings.  A ring that is too small for the
+ *  frame is created again with at least twice the size.
+ ***********************************************************/
+void MeshArena::BeginFrame(int maxDrawCount, int maxCommandCount)
+{
+	if (maxDrawCount > m_drawCapacity)
+	{
+		while (m_drawCapacity < maxDrawCount)
+		{
+			m_drawCapacity *= 2;
+		}
+		m_drawDataRing.Create(GL_ARRAY_BUFFER, sizeof(DRAW_DATA) * m_drawCapacity);
+		SetDrawDataAttributes();
+	}
+	if (maxCommandCount > m_commandCapacity)
+	{
+		while (m_commandCapacity < maxCommandCount)
+		{
+			m_commandCapacity *= 2;
+		}
+		m_commandRing.Create(GL_DRAW_INDIRECT_BUFFER, sizeof(DRAW_COMMAND) * m_commandCapacity);
+		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+	}
+
+	m_drawDataRing.BeginFrame();
+	m_commandRing.BeginFrame();
+}
+
+/***********************************************************
+ *  GetDrawDataBase()
+ *
+ *  This method is used for getting the index of the first
+ *  per-draw data in the current ring region.  The per-draw
+ *  attributes point at the start of the ring, so a command
+ *  reaches its data through its baseInstance.
+ ***********************************************************/
+GLuint MeshArena::GetDrawDataBase() const
+{
+	return((GLuint)(m_drawDataRing.GetRegionOffset() / sizeof(DRAW_DATA)));
+}
+
+/***********************************************************
+ *  UpdateDrawData()
+ *
+ *  This method is used for writing the per-draw data of the
+ *  frame into its ring region.  A frame may be written in
+ *  several pieces, each from its first draw on.
+ ***********************************************************/
+void MeshArena::UpdateDrawData(const DRAW_DATA* drawData, int drawCount, int firstDraw)
+{
+	if (m_drawDataRing.Write(sizeof(DRAW_DATA) * firstDraw, drawData, sizeof(DRAW_DATA) * drawCount) == false)
+	{
+		std::cout << "Draw data does not fit the ring region:" << drawCount << std::endl;
+	}
+}
+
+/***********************************************************
+ *  UpdateCommands()
+ *
+ *  This method is used for writing the indirect draw
+ *  commands of the frame into its ring region, from the
+ *  passed in command of the frame on.
+ ***********************************************************/
+void MeshArena::UpdateCommands(const DRAW_COMMAND* commands, int commandCount, int firstCommand)
+{
+	if (m_commandRing.Write(sizeof(DRAW_COMMAND) * firstCommand, commands, sizeof(DRAW_COMMAND) * commandCount) == false)
+	{
+		std::cout << "Draw commands do not fit the ring region:" << commandCount << std::endl;
+	}
+}
+
+/***********************************************************
+ *  MultiDraw()
+ *
+ *  This method is used for drawing a run of consecutive
+ *  commands from the indirect buffer with one call, with
+ *  every vertex attribute or with only the positions and
+ *  the model matrix for the depth pre-pass.
+ ***********************************************************/
+void MeshArena::MultiDraw(int firstCommand, int commandCount, bool bPositionsOnly)
+{
+	glBindVertexArray((bPositionsOnly == true) ? m_depthVao : m_vao);
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_commandRing.GetBuffer());
+	glMultiDrawElementsIndirect(
+		GL_TRIANGLES,
+		GL_UNSIGNED_INT,
+		(void*)(m_commandRing.GetRegionOffset() + sizeof(DRAW_COMMAND) * firstCommand),
+		commandCount,
+		0);
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+	glBindVertexArray(0);
+}
+
+/***********************************************************
+ *  EndFrame()
+ *
+ *  This method is used for fencing the ring regions of the
+ *  frame, so they are not written again before the GPU has
+ *  drawn every command that reads them.
+ ***********************************************************/
+void MeshArena::EndFrame()
+{
+	m_drawDataRing.EndFrame();
+	m_commandRing.EndFrame();
+}
+
+/***********************************************************
+ *  BeginMesh()
+ *
+ *  This method is used for starting a new mesh at the end
+ *  of the vertex and index data.
+ ***********************************************************/
+void MeshArena::BeginMesh()
+{
+	m_meshFirstVertex = (GLuint)(m_vertices.size() / g_VertexStride);
+	m_meshFirstIndex = (GLuint)m_indices.size();
+}
+
+/***********************************************************
+ *  EndMesh()
+ *
+ *  This method is used for recording where the mesh that
+ *  was just built lives in the shared buffers.
+ ***********************************************************/
+void MeshArena::EndMesh(int meshID)
+{
+	MESH_RANGE& mesh = m_meshes[meshID];
+
+	mesh.firstIndex = m_meshFirstIndex;
+	mesh.indexCount = (GLuint)m_indices.size() - m_meshFirstIndex;
+	mesh.baseVertex = (GLint)m_meshFirstVertex;
+}
+
+/***********************************************************
+ *  GetMeshVertexCount()
+ *
+ *  This method is used for getting the number of vertices
+ *  added to the mesh being built so far.
+ ***********************************************************/
+GLuint MeshArena::GetMeshVertexCount() const
+{
+	return((GLuint)(m_vertices.size() / g_VertexStride) - m_meshFirstVertex);
+}
+
+/***********************************************************
+ *  AddVertex()
+ *
+ *  This method is used for adding a vertex to the mesh
+ *  being built.
+ ***********************************************************/
+void MeshArena::AddVertex(const glm::vec3& position, const glm::vec3& normal, const glm::vec2& uv)
+{
+	m_vertices.push_back(position.x);
+	m_vertices.push_back(position.y);
+	m_vertices.push_back(position.z);
+	m_vertices.push_back(normal.x);
+	m_vertices.push_back(normal.y);
+	m_vertices.push_back(normal.z);
+	m_vertices.push_back(uv.x);
+	m_vertices.push_back(uv.y);
+}
+
+/***********************************************************
+ *  AddTriangle()
+ *
+ *  This method is used for adding a counter-clockwise
+ *  triangle to the mesh being built.
+ ***********************************************************/
+void MeshArena::AddTriangle(GLuint a, GLuint b, GLuint c)
+{
+	m_indices.push_back(a);
+	m_indices.push_back(b);
+	m_indices.push_back(c);
+}
+
+/***********************************************************
+ *  BuildBox()
+ *
+ *  This method is used for building the unit box, centered
+ *  on the origin, with one normal per face.
+ ***********************************************************/
+void MeshArena::BuildBox()
+{
+	// normal, and the two face axes with U x V = normal
+	const glm::vec3 faces[6][3] = {
+		{ glm::vec3( 0.0f,  0.0f, -1.0f), glm::vec3(-1.0f, 0.0f,  0.0f), glm::vec3(0.0f, 1.0f,  0.0f) },
+		{ glm::vec3( 0.0f,  0.0f,  1.0f), glm::vec3( 1.0f, 0.0f,  0.0f), glm::vec3(0.0f, 1.0f,  0.0f) },
+		{ glm::vec3(-1.0f,  0.0f,  0.0f), glm::vec3( 0.0f, 0.0f,  1.0f), glm::vec3(0.0f, 1.0f,  0.0f) },
+		{ glm::vec3( 1.0f,  0.0f,  0.0f), glm::vec3( 0.0f, 0.0f, -1.0f), glm::vec3(0.0f, 1.0f,  0.0f) },
+		{ glm::vec3( 0.0f, -1.0f,  0.0f), glm::vec3( 1.0f, 0.0f,  0.0f), glm::vec3(0.0f, 0.0f,  1.0f) },
+		{ glm::vec3( 0.0f,  1.0f,  0.0f), glm::vec3( 1.0f, 0.0f,  0.0f), glm::vec3(0.0f, 0.0f, -1.0f) }
+	};
+
+	for (int face = 0; face < 6; face++)
+	{
+		const glm::vec3& normal = faces[face][0];
+		const glm::vec3& axisU = faces[face][1];
+		const glm::vec3& axisV = faces[face][2];
+		GLuint first = GetMeshVertexCount();
+
+		AddVertex(0.5f * (normal - axisU - axisV), normal, glm::vec2(0.0f, 0.0f));
+		AddVertex(0.5f * (normal + axisU - axisV), normal, glm::vec2(1.0f, 0.0f));
+		AddVertex(0.5f * (normal + axisU + axisV), normal, glm::vec2(1.0f, 1.0f));
+		AddVertex(0.5f * (normal - axisU + axisV), normal, glm::vec2(0.0f, 1.0f));
+		AddTriangle(first, first + 1, first + 2);
+		AddTriangle(first, first + 2, first + 3);
+	}
+}
+
+/***********************************************************
+ *  BuildPlane()
+ *
+ *  This method is used for building the plane, lying on the
+ *  XZ plane from -1 to 1 and facing up.
+ ***********************************************************/
+void MeshArena::BuildPlane()
+{
+	const glm::vec3 normal(0.0f, 1.0f, 0.0f);
+
+	AddVertex(glm::vec3(-1.0f, 0.0f,  1.0f), normal, glm::vec2(0.0f, 0.0f));
+	AddVertex(glm::vec3( 1.0f, 0.0f,  1.0f), normal, glm::vec2(1.0f, 0.0f));
+	AddVertex(glm::vec3( 1.0f, 0.0f, -1.0f), normal, glm::vec2(1.0f, 1.0f));
+	AddVertex(glm::vec3(-1.0f, 0.0f, -1.0f), normal, glm::vec2(0.0f, 1.0f));
+	AddTriangle(0, 1, 2);
+	AddTriangle(0, 2, 3);
+}
+
+/***********************************************************
+ *  BuildFrustum()
+ *
+ *  This method is used for building a cylinder, cone or
+ *  tapered cylinder standing on the XZ plane from 0 to 1
+ *  in Y, with the passed in bottom and top radius and the
+ *  passed in number of slices around.
+ ***********************************************************/
+void MeshArena::BuildFrustum(float bottomRadius, float topRadius, bool bTopCap, int slices)
+{
+	GLuint first = GetMeshVertexCount();
+
+	// the side normals lean up as the shape narrows
+	for (int i = 0; i <= slices; i++)
+	{
+		float angle = 2.0f * g_Pi * (float)i / (float)slices;
+		float u = (float)i / (float)slices;
+		glm::vec3 direction(std::cos(angle), 0.0f, std::sin(angle));
+		glm::vec3 normal = glm::normalize(glm::vec3(direction.x, bottomRadius - topRadius, direction.z));
+
+		AddVertex(direction * bottomRadius, normal, glm::vec2(u, 0.0f));
+		AddVertex(direction * topRadius + glm::vec3(0.0f, 1.0f, 0.0f), normal, glm::vec2(u, 1.0f));
+	}
+	for (int i = 0; i < slices; i++)
+	{
+		GLuint bottom = first + 2 * i;
+		AddTriangle(bottom, bottom + 1, bottom + 2);
+		AddTriangle(bottom + 2, bottom + 1, bottom + 3);
+	}
+
+	BuildCap(bottomRadius, 0.0f, false, slices);
+	if (bTopCap == true)
+	{
+		BuildCap(topRadius, 1.0f, true, slices);
+	}
+}
+
+/***********************************************************
+ *  BuildCap()
+ *
+ *  This method is used for building a flat disc at the
+ *  passed in height, facing up or down.
+ ***********************************************************/
+void MeshArena::BuildCap(float radius, float height, bool bFacingUp, int slices)
+{
+	const glm::vec3 normal(0.0f, bFacingUp ? 1.0f : -1.0f, 0.0f);
+	GLuint center = GetMeshVertexCount();
+
+	AddVertex(glm::vec3(0.0f, height, 0.0f), normal, glm::vec2(0.5f, 0.5f));
+	for (int i = 0; i <= slices; i++)
+	{
+		float angle = 2.0f * g_Pi * (float)i / (float)slices;
+		float x = std::cos(angle);
+		float z = std::sin(angle);
+
+		AddVertex(glm::vec3(x * radius, height, z * radius), normal, glm::vec2(0.5f + 0.5f * x, 0.5f + 0.5f * z));
+	}
+	for (int i = 0; i < slices; i++)
+	{
+		GLuint edge = center + 1 + i;
+		if (bFacingUp == true)
+			AddTriangle(center, edge + 1, edge);
+		else
+			AddTriangle(center, edge, edge + 1);
+	}
+}
+
+/***********************************************************
+ *  BuildPrism()
+ *
+ *  This method is used for building the triangular prism,
+ *  with its triangle faces pointing along Z and the apex
+ *  of the triangles up, inside the unit box.
+ ***********************************************************/
+void MeshArena::BuildPrism()
+{
+	const glm::vec3 corners[3] = {
+		glm::vec3(-0.5f, -0.5f, 0.0f),
+		glm::vec3( 0.5f, -0.5f, 0.0f),
+		glm::vec3( 0.0f,  0.5f, 0.0f)
+	};
+	const glm::vec2 cornerUVs[3] = {
+		glm::vec2(0.0f, 0.0f),
+		glm::vec2(1.0f, 0.0f),
+		glm::vec2(0.5f, 1.0f)
+	};
+	const glm::vec3 front(0.0f, 0.0f, 0.5f);
+	GLuint first = GetMeshVertexCount();
+
+	// the front and back triangles
+	for (int i = 0; i < 3; i++)
+	{
+		AddVertex(corners[i] + front, glm::vec3(0.0f, 0.0f, 1.0f), cornerUVs[i]);
+	}
+	for (int i = 0; i < 3; i++)
+	{
+		AddVertex(corners[i] - front, glm::vec3(0.0f, 0.0f, -1.0f), cornerUVs[i]);
+	}
+	AddTriangle(first, first + 1, first + 2);
+	AddTriangle(first + 3, first + 5, first + 4);
+
+	// the three side quads
+	for (int i = 0; i < 3; i++)
+	{
+		const glm::vec3& a = corners[i];
+		const glm::vec3& b = corners[(i + 1) % 3];
+		glm::vec3 normal = glm::normalize(glm::cross(b - a, glm::vec3(0.0f, 0.0f, 1.0f)));
+		GLuint side = GetMeshVertexCount();
+
+		AddVertex(a + front, normal, glm::vec2(0.0f, 0.0f));
+		AddVertex(b + front, normal, glm::vec2(1.0f, 0.0f));
+		AddVertex(b - front, normal, glm::vec2(1.0f, 1.0f));
+		AddVertex(a - front, normal, glm::vec2(0.0f, 1.0f));
+		AddTriangle(side, side + 2, side + 1);
+		AddTriangle(side, side + 3, side + 2);
+	}
+}
+
+/***********************************************************
+ *  BuildPyramid4()
+ *
+ *  This method is used for building the square pyramid,
+ *  with its base on Y -0.5 and its apex on Y 0.5.
+ ***********************************************************/
+void MeshArena::BuildPyramid4()
+{
+	const glm::vec3 corners[4] = {
+		glm::vec3(-0.5f, -0.5f,  0.5f),
+		glm::vec3( 0.5f, -0.5f,  0.5f),
+		glm::vec3( 0.5f, -0.5f, -0.5f),
+		glm::vec3(-0.5f, -0.5f, -0.5f)
+	};
+	const glm::vec3 apex(0.0f, 0.5f, 0.0f);
+	GLuint first = GetMeshVertexCount();
+
+	// the base, facing down
+	for (int i = 0; i < 4; i++)
+	{
+		AddVertex(corners[i], glm::vec3(0.0f, -1.0f, 0.0f), glm::vec2(corners[i].x + 0.5f, corners[i].z + 0.5f));
+	}
+	AddTriangle(first, first + 2, first + 1);
+	AddTriangle(first, first + 3, first + 2);
+
+	// the four sides
+	for (int i = 0; i < 4; i++)
+	{
+		const glm::vec3& a = corners[i];
+		const glm::vec3& b = corners[(i + 1) % 4];
+		glm::vec3 normal = glm::normalize(glm::cross(b - a, apex - a));
+		GLuint side = GetMeshVertexCount();
+
+		AddVertex(a, normal, glm::vec2(0.0f, 0.0f));
+		AddVertex(b, normal, glm::vec2(1.0f, 0.0f));
+		AddVertex(apex, normal, glm::vec2(0.5f, 1.0f));
+		AddTriangle(side, side + 1, side + 2);
+	}
+}
+
+/***********************************************************
+ *  BuildSphere()
+ *
+ *  This method is used for building the unit radius sphere
+ *  centered on the origin, from the passed in number of
+ *  slices around and stacks from pole to pole.
+ ***********************************************************/
+void MeshArena::BuildSphere(int slices, int stacks)
+{
+	GLuint first = GetMeshVertexCount();
+	const GLuint rowLength = slices + 1;
+
+	for (int stack = 0; stack <= stacks; stack++)
+	{
+		float polar = g_Pi * (float)stack / (float)stacks;
+		float ringRadius = std::sin(polar);
+		float y = std::cos(polar);
+
+		for (int slice = 0; slice <= slices; slice++)
+		{
+			float angle = 2.0f * g_Pi * (float)slice / (float)slices;
+			glm::vec3 position(ringRadius * std::cos(angle), y, ringRadius * std::sin(angle));
+
+			AddVertex(position, position, glm::vec2((float)slice / (float)slices, 1.0f - (float)stack / (float)stacks));
+		}
+	}
+
+	for (int stack = 0; stack < stacks; stack++)
+	{
+		for (int slice = 0; slice < slices; slice++)
+		{
+			GLuint upper = first + stack * rowLength + slice;
+			GLuint lower = upper + rowLength;
+
+			AddTriangle(lower, upper, lower + 1);
+			AddTriangle(lower + 1, upper, upper + 1);
+		}
+	}
+}
+
+/***********************************************************
+ *  BuildTorus()
+ *
+ *  This method is used for building the torus, with its
+ *  ring on the XY plane around the origin, from the passed
+ *  in number of rings around and sides around the tube.
+ ***********************************************************/
+void MeshArena::BuildTorus(int rings, int sides)
+{
+	GLuint first = GetMeshVertexCount();
+	const GLuint rowLength = sides + 1;
+
+	for (int ring = 0; ring <= rings; ring++)
+	{
+		float ringAngle = 2.0f * g_Pi * (float)ring / (float)rings;
+		glm::vec3 ringDirection(std::cos(ringAngle), std::sin(ringAngle), 0.0f);
+
+		for (int side = 0; side <= sides; side++)
+		{
+			float sideAngle = 2.0f * g_Pi * (float)side / (float)sides;
+			glm::vec3 normal = ringDirection * std::cos(sideAngle) + glm::vec3(0.0f, 0.0f, std::sin(sideAngle));
+			glm::vec3 position = ringDirection * g_TorusMainRadius + normal * g_TorusTubeRadius;
+
+			AddVertex(position, normal, glm::vec2((float)ring / (float)rings, (float)side / (float)sides));
+		}
+	}
+
+	for (int ring = 0; ring < rings; ring++)
+	{
+		for (int side = 0; side < sides; side++)
+		{
+			GLuint current = first + ring * rowLength + side;
+			GLuint next = current + rowLength;
+
+			AddTriangle(current, next, current + 1);
+			AddTriangle(current + 1, next, next + 1);
+		}
+	}
+}
@@ -0,0 +1,176 @@
+///////////////////////////////////////////////////////////////////////////////
+// mesharena.h
+// ============
+// keep every basic shape mesh in one shared vertex and index buffer and
+// draw them with multi-draw indirect calls
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "FrameRingBuffer.h"
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include <vector>
+
+/***********************************************************
+ *  MeshArena
+ *
+ *  This class builds all the basic shape meshes into one
+ *  vertex buffer and one index buffer behind a single vertex
+ *  array, so drawing a different shape never rebinds any
+ *  buffer.  A frame is described by an array of indirect
+ *  draw commands, and each command reads its per-draw data
+ *  (model matrix, color, UV scale, material, texture layer)
+ *  as instanced vertex attributes starting at its
+ *  baseInstance.  The per-draw data and the commands live
+ *  in persistently mapped ring buffers, one region per
+ *  frame in flight, so writing a frame never waits for the
+ *  GPU to finish the frame before it.
+ *
+ *  The round shapes are also built at coarser tessellation
+ *  levels, picked per object by its size on the screen.
+ *  Extra meshes, like baked static geometry, can be added
+ *  after the basic shapes until the arena is uploaded.
+ *
+ *  The positions are also kept packed in a buffer of their
+ *  own, for the depth pre-pass.
+ *
+ *  Multi-draw indirect needs OpenGL 4.3, IsSupported() tells
+ *  whether the current context has it.
+ ***********************************************************/
+class MeshArena
+{
+public:
+	// constructor
+	MeshArena();
+	// destructor
+	~MeshArena();
+
+	// floats per vertex: position, normal and UV
+	static const int VERTEX_STRIDE = 8;
+	// tessellation levels of the round shapes, 0 is the finest
+	static const int LOD_COUNT = 3;
+
+	// location of a mesh inside the shared buffers
+	struct MESH_RANGE
+	{
+		GLuint firstIndex;
+		GLuint indexCount;
+		GLint baseVertex;
+	};
+
+	// layout of a command in the indirect draw buffer
+	struct DRAW_COMMAND
+	{
+		GLuint count;
+		GLuint instanceCount;
+		GLuint firstIndex;
+		GLint baseVertex;
+		GLuint baseInstance;
+	};
+
+	// per-draw data, matches the vertex shader inputs at
+	// attribute locations 3 to 10
+	struct DRAW_DATA
+	{
+		glm::mat4 model;
+		glm::vec4 color;
+		glm::vec2 uvScale;
+		GLint materialIndex;
+		GLint textureLayer;
+	};
+
+	// check that the context can draw multi-draw indirect
+	static bool IsSupported();
+
+	// build all the basic shape meshes into the shared buffers
+	void LoadMeshes();
+	// add a mesh after the basic shapes, returns its mesh ID
+	int AddMesh(const std::vector<GLfloat>& vertices, const std::vector<GLuint>& indices);
+	// copy the vertices and indices of a mesh, only until
+	// the arena is uploaded
+	void GetMeshGeometry(int meshID, std::vector<GLfloat>& vertices, std::vector<GLuint>& indices) const;
+	// upload all the meshes and create the vertex array
+	void Upload();
+	// get the location of a mesh in the shared buffers
+	const MESH_RANGE& GetMesh(int meshID) const { return m_meshes[meshID]; }
+	// get the mesh ID of a basic shape at a tessellation
+	// level, shapes without levels return themselves
+	int GetLodMesh(int meshID, int lodLevel) const;
+	// check if a basic shape has coarser levels
+	bool HasLods(int meshID) const { return GetLodMesh(meshID, LOD_COUNT - 1) != meshID; }
+
+	// start a frame of at most the passed in number of draws
+	// and commands, waiting for its ring regions to be free
+	void BeginFrame(int maxDrawCount, int maxCommandCount);
+	// index of the first per-draw data of the frame, to be
+	// added to the baseInstance of every command
+	GLuint GetDrawDataBase() const;
+	// write the per-draw data and draw commands of the frame,
+	// starting at the passed in draw or command of the frame
+	void UpdateDrawData(const DRAW_DATA* drawData, int drawCount, int firstDraw = 0);
+	void UpdateCommands(const DRAW_COMMAND* commands, int commandCount, int firstCommand = 0);
+	// draw a run of the written commands with one call, the
+	// depth pre-pass only needs the positions
+	void MultiDraw(int firstCommand, int commandCount, bool bPositionsOnly = false);
+	// fence the frame once all its runs are drawn
+	void EndFrame();
+
+private:
+	GLuint m_vao;
+	// vertex array of the depth pre-pass, positions only
+	GLuint m_depthVao;
+	// vertex and index buffers, and the packed positions of
+	// the vertex buffer
+	GLuint m_vertexBuffer;
+	GLuint m_positionBuffer;
+	GLuint m_indexBuffer;
+	// per-draw data and indirect command rings, with the
+	// number of draws and commands a frame region holds
+	FrameRingBuffer m_drawDataRing;
+	FrameRingBuffer m_commandRing;
+	int m_drawCapacity;
+	int m_commandCapacity;
+	// location of every mesh in the shared buffers, the
+	// SCENE_MESH shapes first
+	std::vector<MESH_RANGE> m_meshes;
+	// mesh ID of every SCENE_MESH shape at every level,
+	// LOD_COUNT entries per shape
+	std::vector<int> m_lodMeshes;
+
+	// vertex and index data kept until Upload()
+	std::vector<GLfloat> m_vertices;
+	std::vector<GLuint> m_indices;
+	// first vertex and index of the mesh being built
+	GLuint m_meshFirstVertex;
+	GLuint m_meshFirstIndex;
+
+	// point the per-draw attributes at the draw data ring
+	void SetDrawDataAttributes();
+
+	// start and finish building a mesh
+	void BeginMesh();
+	void EndMesh(int meshID);
+	// number of vertices added to the mesh being built
+	GLuint GetMeshVertexCount() const;
+	// add a vertex or a triangle to the mesh being built,
+	// triangles index the vertices of the mesh from 0
+	void AddVertex(const glm::vec3& position, const glm::vec3& normal, const glm::vec2& uv);
+	void AddTriangle(GLuint a, GLuint b, GLuint c);
+
+	// build a basic shape at a tessellation level
+	void BuildShape(int meshID, int lodLevel);
+	// build the basic shapes, same size as the ShapeMeshes ones
+	void BuildBox();
+	void BuildPlane();
+	void BuildFrustum(float bottomRadius, float topRadius, bool bTopCap, int slices);
+	void BuildPrism();
+	void BuildPyramid4();
+	void BuildSphere(int slices, int stacks);
+	void BuildTorus(int rings, int sides);
+	// build a flat disc cap of a cylinder or cone
+	void BuildCap(float radius, float height, bool bFacingUp, int slices);
+};
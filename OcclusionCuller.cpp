@@ -0,0 +1,499 @@
+///////////////////////////////////////////////////////////////////////////////
+// occlusionculler.cpp
+// ============
+// rasterize the large occluders into a small CPU depth buffer and test
+// bounding boxes against it
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "OcclusionCuller.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define OCCLUSION_CULLER_SSE2
+#include <emmintrin.h>
+#endif
+
+// declare the global variables
+namespace
+{
+	// size of the depth buffer, the aspect of the window -
+	// the width is a whole number of tiles and of SIMD groups
+	const int g_BufferWidth = 320;
+	const int g_BufferHeight = 256;
+	// tiles rasterized by one job at a time
+	const int g_TileSize = 64;
+	const int g_TilesX = g_BufferWidth / g_TileSize;
+	const int g_TilesY = g_BufferHeight / g_TileSize;
+	// blocks that keep their farthest depth
+	const int g_BlockSize = 8;
+	const int g_BlocksX = g_BufferWidth / g_BlockSize;
+	const int g_BlocksY = g_BufferHeight / g_BlockSize;
+	// pixels rasterized together, the width of an SSE register
+	const int g_GroupSize = 4;
+	// occluder triangles that make rasterizing the tiles as
+	// jobs of their own worth it
+	const int g_MinTrianglesForJobs = 256;
+	// depth a box must be behind the occluders to be hidden,
+	// covers the depth interpolated at the pixel centers
+	const float g_DepthBias = 0.0001f;
+	// part of a pixel the triangle edges are widened by
+	const float g_EdgeTolerance = 1.0f / 256.0f;
+
+	// the unit box and plane of the basic shapes
+	const glm::vec3 g_BoxPositions[8] = {
+		glm::vec3(-0.5f, -0.5f, -0.5f), glm::vec3( 0.5f, -0.5f, -0.5f),
+		glm::vec3( 0.5f,  0.5f, -0.5f), glm::vec3(-0.5f,  0.5f, -0.5f),
+		glm::vec3(-0.5f, -0.5f,  0.5f), glm::vec3( 0.5f, -0.5f,  0.5f),
+		glm::vec3( 0.5f,  0.5f,  0.5f), glm::vec3(-0.5f,  0.5f,  0.5f)
+	};
+	const int g_BoxIndices[36] = {
+		0, 2, 1, 0, 3, 2,
+		4, 5, 6, 4, 6, 7,
+		0, 4, 7, 0, 7, 3,
+		1, 2, 6, 1, 6, 5,
+		0, 1, 5, 0, 5, 4,
+		3, 7, 6, 3, 6, 2
+	};
+	const glm::vec3 g_PlanePositions[4] = {
+		glm::vec3(-1.0f, 0.0f,  1.0f), glm::vec3( 1.0f, 0.0f,  1.0f),
+		glm::vec3( 1.0f, 0.0f, -1.0f), glm::vec3(-1.0f, 0.0f, -1.0f)
+	};
+	const int g_PlaneIndices[6] = { 0, 1, 2, 0, 2, 3 };
+}
+
+/***********************************************************
+ *  OcclusionCuller()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+OcclusionCuller::OcclusionCuller()
+{
+	m_viewProjection = glm::mat4(1.0f);
+	m_pArena = nullptr;
+	m_tileBins.resize(g_TilesX * g_TilesY);
+	m_depth.assign(g_BufferWidth * g_BufferHeight, 1.0f);
+	m_blockDepth.assign(g_BlocksX * g_BlocksY, 1.0f);
+}
+
+/***********************************************************
+ *  BeginFrame()
+ *
+ *  This method is used for starting the occluders of a new
+ *  frame, seen through the passed in camera.
+ ***********************************************************/
+void OcclusionCuller::BeginFrame(const glm::mat4& viewProjection, FrameArena& arena)
+{
+	m_viewProjection = viewProjection;
+	m_pArena = &arena;
+	m_triangles.clear();
+}
+
+/***********************************************************
+ *  AddBoxOccluder()
+ *
+ *  This method is used for adding the unit box, centered on
+ *  the origin, as an occluder.  Its back faces are hidden
+ *  by its front faces, so they are not drawn.
+ ***********************************************************/
+void OcclusionCuller::AddBoxOccluder(const glm::mat4& model)
+{
+	AddMeshOccluder(model, g_BoxPositions, 8, g_BoxIndices, 36, true);
+}
+
+/***********************************************************
+ *  AddPlaneOccluder()
+ *
+ *  This method is used for adding the plane, from -1 to 1
+ *  on the XZ plane, as an occluder.  Both of its sides hide
+ *  what is behind them.
+ ***********************************************************/
+void OcclusionCuller::AddPlaneOccluder(const glm::mat4& model)
+{
+	AddMeshOccluder(model, g_PlanePositions, 4, g_PlaneIndices, 6, false);
+}
+
+/***********************************************************
+ *  AddMeshOccluder()
+ *
+ *  This method is used for moving the vertices of a local
+ *  mesh into clip space and adding its triangles.  A model
+ *  matrix that mirrors the mesh turns its winding around.
+ ***********************************************************/
+void OcclusionCuller::AddMeshOccluder(
+	const glm::mat4& model,
+	const glm::vec3* positions,
+	int positionCount,
+	const int* indices,
+	int indexCount,
+	bool bClosed)
+{
+	const glm::mat4 modelViewProjection = m_viewProjection * model;
+	int winding = 0;
+	if (bClosed == true)
+	{
+		const float determinant = glm::dot(glm::cross(glm::vec3(model[0]), glm::vec3(model[1])), glm::vec3(model[2]));
+		winding = (determinant < 0.0f) ? -1 : 1;
+	}
+	glm::vec4* clipPositions = m_pArena->AllocateArray<glm::vec4>(JobSystem::GetWorkerIndex(), positionCount);
+
+	for (int i = 0; i < positionCount; i++)
+	{
+		clipPositions[i] = modelViewProjection * glm::vec4(positions[i], 1.0f);
+	}
+	for (int i = 0; i + 2 < indexCount; i += 3)
+	{
+		AddTriangle(clipPositions[indices[i]], clipPositions[indices[i + 1]], clipPositions[indices[i + 2]], winding);
+	}
+}
+
+/***********************************************************
+ *  AddTriangle()
+ *
+ *  This method is used for clipping a triangle against the
+ *  near plane, where z = -w.  Clipping one corner off turns
+ *  the triangle into a quad, which is added as two.
+ ***********************************************************/
+void OcclusionCuller::AddTriangle(const glm::vec4& a, const glm::vec4& b, const glm::vec4& c, int winding)
+{
+	const glm::vec4 input[3] = { a, b, c };
+	glm::vec4 clipped[4];
+	int clippedCount = 0;
+
+	for (int i = 0; i < 3; i++)
+	{
+		const glm::vec4& current = input[i];
+		const glm::vec4& next = input[(i + 1) % 3];
+		const float currentDistance = current.z + current.w;
+		const float nextDistance = next.z + next.w;
+
+		if (currentDistance >= 0.0f)
+		{
+			clipped[clippedCount++] = current;
+		}
+		if ((currentDistance >= 0.0f) != (nextDistance >= 0.0f))
+		{
+			float t = currentDistance / (currentDistance - nextDistance);
+			clipped[clippedCount++] = current + (next - current) * t;
+		}
+	}
+
+	for (int i = 1; i + 1 < clippedCount; i++)
+	{
+		AddClippedTriangle(clipped[0], clipped[i], clipped[i + 1], winding);
+	}
+}
+
+/***********************************************************
+ *  AddClippedTriangle()
+ *
+ *  This method is used for projecting a triangle in front
+ *  of the near plane onto the depth buffer pixels.  The
+ *  triangles that face away or cover no pixel center are
+ *  dropped.
+ ***********************************************************/
+void OcclusionCuller::AddClippedTriangle(const glm::vec4& a, const glm::vec4& b, const glm::vec4& c, int winding)
+{
+	const glm::vec4 input[3] = { a, b, c };
+	SCREEN_TRIANGLE triangle;
+
+	for (int i = 0; i < 3; i++)
+	{
+		if (input[i].w <= 0.0f)
+		{
+			return;
+		}
+		triangle.vertices[i] = glm::vec3(
+			(input[i].x / input[i].w * 0.5f + 0.5f) * g_BufferWidth,
+			(input[i].y / input[i].w * 0.5f + 0.5f) * g_BufferHeight,
+			input[i].z / input[i].w);
+	}
+
+	const glm::vec3& v0 = triangle.vertices[0];
+	const glm::vec3& v1 = triangle.vertices[1];
+	const glm::vec3& v2 = triangle.vertices[2];
+	const float area = (v1.x - v0.x) * (v2.y - v0.y) - (v1.y - v0.y) * (v2.x - v0.x);
+	if ((std::fabs(area) < 1e-6f) || (area * (float)winding < 0.0f))
+	{
+		return;
+	}
+
+	// the pixels whose centers are inside the bounds
+	triangle.minX = std::max(0, (int)std::ceil(std::min(std::min(v0.x, v1.x), v2.x) - 0.5f));
+	triangle.minY = std::max(0, (int)std::ceil(std::min(std::min(v0.y, v1.y), v2.y) - 0.5f));
+	triangle.maxX = std::min(g_BufferWidth - 1, (int)std::floor(std::max(std::max(v0.x, v1.x), v2.x) - 0.5f));
+	triangle.maxY = std::min(g_BufferHeight - 1, (int)std::floor(std::max(std::max(v0.y, v1.y), v2.y) - 0.5f));
+	if ((triangle.minX > triangle.maxX) || (triangle.minY > triangle.maxY))
+	{
+		return;
+	}
+
+	m_triangles.push_back(triangle);
+}
+
+/***********************************************************
+ *  Rasterize()
+ *
+ *  This method is used for sorting the triangles into the
+ *  tiles they overlap and rasterizing the tiles.  Every tile
+ *  only writes its own pixels and blocks, so the tiles are
+ *  jobs that share nothing.  Without a job system, or with
+ *  few triangles, they are rasterized on this thread.
+ ***********************************************************/
+void OcclusionCuller::Rasterize(JobSystem* pJobs)
+{
+	if (m_triangles.empty() == true)
+	{
+		return;
+	}
+
+	for (std::vector<int>& bin : m_tileBins)
+	{
+		bin.clear();
+	}
+	for (int i = 0; i < (int)m_triangles.size(); i++)
+	{
+		const SCREEN_TRIANGLE& triangle = m_triangles[i];
+		for (int tileY = triangle.minY / g_TileSize; tileY <= triangle.maxY / g_TileSize; tileY++)
+		{
+			for (int tileX = triangle.minX / g_TileSize; tileX <= triangle.maxX / g_TileSize; tileX++)
+			{
+				m_tileBins[tileY * g_TilesX + tileX].push_back(i);
+			}
+		}
+	}
+
+	const int tileCount = g_TilesX * g_TilesY;
+	if ((pJobs == nullptr) || ((int)m_triangles.size() < g_MinTrianglesForJobs))
+	{
+		for (int tile = 0; tile < tileCount; tile++)
+		{
+			RasterizeTile(tile);
+		}
+		return;
+	}
+
+	pJobs->ParallelFor(tileCount, 1, [this](int firstTile, int lastTile)
+	{
+		for (int tile = firstTile; tile < lastTile; tile++)
+		{
+			RasterizeTile(tile);
+		}
+	});
+}
+
+/***********************************************************
+ *  RasterizeTile()
+ *
+ *  This method is used for clearing a tile, drawing the
+ *  depth of its triangles and keeping the farthest depth of
+ *  each of its blocks.  The edge functions and the depth
+ *  are linear in the pixel position, so a row is stepped
+ *  four pixels at a time by adding their X slopes.
+ ***********************************************************/
+void OcclusionCuller::RasterizeTile(int tile)
+{
+	const int tileX0 = (tile % g_TilesX) * g_TileSize;
+	const int tileY0 = (tile / g_TilesX) * g_TileSize;
+	const int tileX1 = tileX0 + g_TileSize - 1;
+	const int tileY1 = tileY0 + g_TileSize - 1;
+
+	for (int y = tileY0; y <= tileY1; y++)
+	{
+		std::fill(m_depth.begin() + y * g_BufferWidth + tileX0, m_depth.begin() + y * g_BufferWidth + tileX1 + 1, 1.0f);
+	}
+
+	for (int triangleIndex : m_tileBins[tile])
+	{
+		const SCREEN_TRIANGLE& triangle = m_triangles[triangleIndex];
+		const glm::vec3* v = triangle.vertices;
+
+		// edge k is opposite vertex k, positive inside for
+		// either winding
+		float area = (v[1].x - v[0].x) * (v[2].y - v[0].y) - (v[1].y - v[0].y) * (v[2].x - v[0].x);
+		const float sign = (area > 0.0f) ? 1.0f : -1.0f;
+		area *= sign;
+		float edgeA[3];
+		float edgeB[3];
+		float edgeC[3];
+		for (int k = 0; k < 3; k++)
+		{
+			const glm::vec3& from = v[(k + 1) % 3];
+			const glm::vec3& to = v[(k + 2) % 3];
+			edgeA[k] = -(to.y - from.y) * sign;
+			edgeB[k] = (to.x - from.x) * sign;
+			edgeC[k] = -(edgeA[k] * from.x + edgeB[k] * from.y);
+		}
+		const float depthA = (edgeA[0] * v[0].z + edgeA[1] * v[1].z + edgeA[2] * v[2].z) / area;
+		const float depthB = (edgeB[0] * v[0].z + edgeB[1] * v[1].z + edgeB[2] * v[2].z) / area;
+		const float depthC = (edgeC[0] * v[0].z + edgeC[1] * v[1].z + edgeC[2] * v[2].z) / area;
+
+		// widen the edges by a small part of a pixel, so the
+		// pixel centers on an edge shared by two triangles are
+		// not lost to rounding on both sides
+		for (int k = 0; k < 3; k++)
+		{
+			edgeC[k] += std::sqrt(edgeA[k] * edgeA[k] + edgeB[k] * edgeB[k]) * g_EdgeTolerance;
+		}
+
+		// rows start on a group, the tiles are whole groups wide
+		const int minX = std::max(triangle.minX, tileX0) & ~(g_GroupSize - 1);
+		const int maxX = std::min(triangle.maxX, tileX1);
+		const int minY = std::max(triangle.minY, tileY0);
+		const int maxY = std::min(triangle.maxY, tileY1);
+
+		for (int y = minY; y <= maxY; y++)
+		{
+			const float centerY = (float)y + 0.5f;
+			const float centerX = (float)minX + 0.5f;
+			float* row = &m_depth[y * g_BufferWidth];
+
+#ifdef OCCLUSION_CULLER_SSE2
+			const __m128 laneOffsets = _mm_set_ps(3.0f, 2.0f, 1.0f, 0.0f);
+			const __m128 zero = _mm_setzero_ps();
+			__m128 edge0 = _mm_add_ps(_mm_set1_ps(edgeA[0] * centerX + edgeB[0] * centerY + edgeC[0]), _mm_mul_ps(_mm_set1_ps(edgeA[0]), laneOffsets));
+			__m128 edge1 = _mm_add_ps(_mm_set1_ps(edgeA[1] * centerX + edgeB[1] * centerY + edgeC[1]), _mm_mul_ps(_mm_set1_ps(edgeA[1]), laneOffsets));
+			__m128 edge2 = _mm_add_ps(_mm_set1_ps(edgeA[2] * centerX + edgeB[2] * centerY + edgeC[2]), _mm_mul_ps(_mm_set1_ps(edgeA[2]), laneOffsets));
+			__m128 depth = _mm_add_ps(_mm_set1_ps(depthA * centerX + depthB * centerY + depthC), _mm_mul_ps(_mm_set1_ps(depthA), laneOffsets));
+			const __m128 edgeStep0 = _mm_set1_ps(edgeA[0] * g_GroupSize);
+			const __m128 edgeStep1 = _mm_set1_ps(edgeA[1] * g_GroupSize);
+			const __m128 edgeStep2 = _mm_set1_ps(edgeA[2] * g_GroupSize);
+			const __m128 depthStep = _mm_set1_ps(depthA * g_GroupSize);
+
+			for (int x = minX; x <= maxX; x += g_GroupSize)
+			{
+				__m128 inside = _mm_and_ps(_mm_cmpge_ps(edge0, zero), _mm_cmpge_ps(edge1, zero));
+				inside = _mm_and_ps(inside, _mm_cmpge_ps(edge2, zero));
+				if (_mm_movemask_ps(inside) != 0)
+				{
+					const __m128 stored = _mm_loadu_ps(row + x);
+					const __m128 nearest = _mm_min_ps(stored, depth);
+					_mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(inside, nearest), _mm_andnot_ps(inside, stored)));
+				}
+
+				edge0 = _mm_add_ps(edge0, edgeStep0);
+				edge1 = _mm_add_ps(edge1, edgeStep1);
+				edge2 = _mm_add_ps(edge2, edgeStep2);
+				depth = _mm_add_ps(depth, depthStep);
+			}
+#else
+			for (int x = minX; x <= maxX; x++)
+			{
+				const float pixelX = (float)x + 0.5f;
+				bool bInside = true;
+				for (int k = 0; (k < 3) && (bInside == true); k++)
+				{
+					bInside = (edgeA[k] * pixelX + edgeB[k] * centerY + edgeC[k] >= 0.0f);
+				}
+				if (bInside == true)
+				{
+					row[x] = std::min(row[x], depthA * pixelX + depthB * centerY + depthC);
+				}
+			}
+#endif
+		}
+	}
+
+	for (int blockY = tileY0 / g_BlockSize; blockY <= tileY1 / g_BlockSize; blockY++)
+	{
+		for (int blockX = tileX0 / g_BlockSize; blockX <= tileX1 / g_BlockSize; blockX++)
+		{
+			float farthest = 0.0f;
+			for (int y = blockY * g_BlockSize; y < (blockY + 1) * g_BlockSize; y++)
+			{
+				const float* row = &m_depth[y * g_BufferWidth + blockX * g_BlockSize];
+				farthest = std::max(farthest, *std::max_element(row, row + g_BlockSize));
+			}
+			m_blockDepth[blockY * g_BlocksX + blockX] = farthest;
+		}
+	}
+}
+
+/***********************************************************
+ *  IsOccluded()
+ *
+ *  This method is used for testing a world-space box against
+ *  the depth buffer.  The box is projected to a pixel
+ *  rectangle with the depth of its nearest corner, which is
+ *  compared to the farthest depth of the blocks it covers
+ *  first, and only to the pixels of the blocks that are not
+ *  decided by that.  Boxes that reach in front of the near
+ *  plane are never occluded.
+ ***********************************************************/
+bool OcclusionCuller::IsOccluded(const glm::vec3& center, const glm::vec3& extents) const
+{
+	if (m_triangles.empty() == true)
+	{
+		return(false);
+	}
+
+	float minX = 0.0f;
+	float minY = 0.0f;
+	float maxX = 0.0f;
+	float maxY = 0.0f;
+	float nearestDepth = 0.0f;
+
+	for (int corner = 0; corner < 8; corner++)
+	{
+		const glm::vec3 offset(
+			(corner & 1) ? extents.x : -extents.x,
+			(corner & 2) ? extents.y : -extents.y,
+			(corner & 4) ? extents.z : -extents.z);
+		const glm::vec4 clip = m_viewProjection * glm::vec4(center + offset, 1.0f);
+		if ((clip.z + clip.w < 0.0f) || (clip.w <= 0.0f))
+		{
+			return(false);
+		}
+
+		const float x = (clip.x / clip.w * 0.5f + 0.5f) * g_BufferWidth;
+		const float y = (clip.y / clip.w * 0.5f + 0.5f) * g_BufferHeight;
+		const float depth = clip.z / clip.w;
+		minX = (corner == 0) ? x : std::min(minX, x);
+		minY = (corner == 0) ? y : std::min(minY, y);
+		maxX = (corner == 0) ? x : std::max(maxX, x);
+		maxY = (corner == 0) ? y : std::max(maxY, y);
+		nearestDepth = (corner == 0) ? depth : std::min(nearestDepth, depth);
+	}
+
+	// one pixel of margin, the occluders are only drawn where
+	// they cover a pixel center
+	const int pixelX0 = std::max(0, (int)std::floor(minX) - 1);
+	const int pixelY0 = std::max(0, (int)std::floor(minY) - 1);
+	const int pixelX1 = std::min(g_BufferWidth - 1, (int)std::floor(maxX) + 1);
+	const int pixelY1 = std::min(g_BufferHeight - 1, (int)std::floor(maxY) + 1);
+	if ((pixelX0 > pixelX1) || (pixelY0 > pixelY1))
+	{
+		return(false);
+	}
+
+	const float threshold = nearestDepth - g_DepthBias;
+	for (int blockY = pixelY0 / g_BlockSize; blockY <= pixelY1 / g_BlockSize; blockY++)
+	{
+		for (int blockX = pixelX0 / g_BlockSize; blockX <= pixelX1 / g_BlockSize; blockX++)
+		{
+			if (m_blockDepth[blockY * g_BlocksX + blockX] < threshold)
+			{
+				continue;
+			}
+
+			const int x0 = std::max(pixelX0, blockX * g_BlockSize);
+			const int x1 = std::min(pixelX1, (blockX + 1) * g_BlockSize - 1);
+			const int y0 = std::max(pixelY0, blockY * g_BlockSize);
+			const int y1 = std::min(pixelY1, (blockY + 1) * g_BlockSize - 1);
+			for (int y = y0; y <= y1; y++)
+			{
+				for (int x = x0; x <= x1; x++)
+				{
+					if (m_depth[y * g_BufferWidth + x] >= threshold)
+					{
+						return(false);
+					}
+				}
+			}
+		}
+	}
+
+	return(true);
+}
@@ -0,0 +1,100 @@
+///////////////////////////////////////////////////////////////////////////////
+// occlusionculler.h
+// ============
+// rasterize the large occluders into a small CPU depth buffer and test
+// bounding boxes against it
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "JobSystem.h"
+
+#include <glm/glm.hpp>
+
+#include <vector>
+
+/***********************************************************
+ *  OcclusionCuller
+ *
+ *  This class rasterizes the triangles of a few large
+ *  occluders into a low resolution depth buffer on the CPU,
+ *  and then tests the world-space boxes of the drawables
+ *  against it.  A box is occluded when its nearest point is
+ *  behind the occluders at every pixel it covers.
+ *
+ *  The buffer holds the depth z/w, which is linear in screen
+ *  space for both projections, cleared to the far plane.  It
+ *  is split into tiles that are rasterized as jobs, four
+ *  pixels at a time with SSE2.  Every 8x8
+ *  block also keeps its farthest depth, so most boxes are
+ *  decided by a few block tests.
+ *
+ *  Nothing is read back from the GPU, the culler only needs
+ *  the camera matrix and the occluder transforms.
+ ***********************************************************/
+class OcclusionCuller
+{
+public:
+	// constructor
+	OcclusionCuller();
+
+	// start a frame seen through the passed in projection *
+	// view matrix, dropping the occluders of the last frame -
+	// the temporaries of the frame come from the arena
+	void BeginFrame(const glm::mat4& viewProjection, FrameArena& arena);
+	// add the unit box or plane of the basic shapes, moved
+	// by a model matrix, as an occluder
+	void AddBoxOccluder(const glm::mat4& model);
+	void AddPlaneOccluder(const glm::mat4& model);
+	// rasterize the added occluders into the depth buffer,
+	// the tiles are run as jobs when a job system is passed
+	void Rasterize(JobSystem* pJobs = nullptr);
+
+	// check if a world-space box is hidden by the occluders
+	bool IsOccluded(const glm::vec3& center, const glm::vec3& extents) const;
+
+	// number of occluder triangles rasterized this frame
+	int GetTriangleCount() const { return (int)m_triangles.size(); }
+
+private:
+	// occluder triangle in screen space, the vertices are in
+	// pixels with their depth
+	struct SCREEN_TRIANGLE
+	{
+		glm::vec3 vertices[3];
+		// covered pixels, inclusive
+		int minX;
+		int minY;
+		int maxX;
+		int maxY;
+	};
+
+	glm::mat4 m_viewProjection;
+	FrameArena* m_pArena;
+	std::vector<SCREEN_TRIANGLE> m_triangles;
+	// triangles overlapping every tile
+	std::vector<std::vector<int>> m_tileBins;
+	// depth of the nearest occluder per pixel
+	std::vector<float> m_depth;
+	// farthest depth per 8x8 block
+	std::vector<float> m_blockDepth;
+
+	// add the indexed triangles of a local mesh, closed
+	// meshes only add the triangles facing the camera
+	void AddMeshOccluder(
+		const glm::mat4& model,
+		const glm::vec3* positions,
+		int positionCount,
+		const int* indices,
+		int indexCount,
+		bool bClosed);
+	// clip a clip-space triangle at the near plane and add
+	// it to the frame - winding is 1 when only the counter-
+	// clockwise side is drawn, -1 for clockwise, 0 for both
+	void AddTriangle(const glm::vec4& a, const glm::vec4& b, const glm::vec4& c, int winding);
+	// add a clipped triangle in clip space
+	void AddClippedTriangle(const glm::vec4& a, const glm::vec4& b, const glm::vec4& c, int winding);
+	// rasterize the triangles of a tile and build its blocks
+	void RasterizeTile(int tile);
+};
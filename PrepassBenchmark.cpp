@@ -0,0 +1,159 @@
+///////////////////////////////////////////////////////////////////////////////
+// prepassbenchmark.cpp
+// ============
+// compare the fragments shaded with and without the depth pre-pass at
+// several resolutions
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "PrepassBenchmark.h"
+#include "SceneManager.h"
+#include "ViewManager.h"
+#include "RenderState.h"
+
+#include <GL/glew.h>
+
+#include <iomanip>
+#include <iostream>
+
+// declare the global variables
+namespace
+{
+	// offscreen sizes the scene is drawn at, the aspect of
+	// the window
+	const int g_Resolutions[][2] = { { 500, 400 }, { 1000, 800 }, { 1500, 1200 }, { 2000, 1600 }, { 3000, 2400 } };
+	// frames drawn before and while measuring each mode
+	const int g_WarmupFrames = 10;
+	const int g_MeasuredFrames = 50;
+
+	// averages of the measured frames of one mode
+	struct MODE_RESULT
+	{
+		double shadedSamples = 0.0;
+		double gpuMilliseconds = 0.0;
+	};
+
+	/***********************************************************
+	 *  MeasureMode()
+	 *
+	 *  Draws the scene into the bound framebuffer with or
+	 *  without the pre-pass and averages the samples passed by
+	 *  the shading passes and the GPU time of the frames.
+	 ***********************************************************/
+	MODE_RESULT MeasureMode(SceneManager* pSceneManager, ViewManager* pViewManager, RenderState* pRenderState, bool bPrepass)
+	{
+		GLuint queries[2];
+		MODE_RESULT result;
+
+		glGenQueries(2, queries);
+		pSceneManager->SetDepthPrepass(bPrepass);
+
+		for (int frame = 0; frame < g_WarmupFrames + g_MeasuredFrames; frame++)
+		{
+			const bool bMeasured = (frame >= g_WarmupFrames);
+
+			pRenderState->SetDepthTest(true);
+			pRenderState->SetClearColor(glm::vec4(0.0f, 0.0f, 0.0f, 1.0f));
+			glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+			pViewManager->PrepareSceneView();
+			pSceneManager->SetViewProjection(pViewManager->GetViewMatrix(), pViewManager->GetProjectionMatrix());
+			pSceneManager->SetShadingQuery((bMeasured == true) ? queries[0] : 0);
+			if (bMeasured == true)
+			{
+				glBeginQuery(GL_TIME_ELAPSED, queries[1]);
+			}
+			pSceneManager->RenderScene();
+			if (bMeasured == false)
+			{
+				continue;
+			}
+			glEndQuery(GL_TIME_ELAPSED);
+
+			// waits for the frame, the timings are per frame
+			GLuint64 samples = 0;
+			GLuint64 nanoseconds = 0;
+			glGetQueryObjectui64v(queries[0], GL_QUERY_RESULT, &samples);
+			glGetQueryObjectui64v(queries[1], GL_QUERY_RESULT, &nanoseconds);
+			result.shadedSamples += (double)samples / g_MeasuredFrames;
+			result.gpuMilliseconds += (double)nanoseconds / 1.0e6 / g_MeasuredFrames;
+		}
+
+		pSceneManager->SetShadingQuery(0);
+		glDeleteQueries(2, queries);
+
+		return(result);
+	}
+}
+
+/***********************************************************
+ *  RunPrepassBenchmark()
+ *
+ *  Draws the prepared scene into offscreen framebuffers of
+ *  growing size, without and with the depth pre-pass.  The
+ *  shaded fragments are the samples that pass the depth test
+ *  of the shading passes, which is every fragment that runs
+ *  the lighting, and the pixels in view are the least it
+ *  can be.  The GPU time covers the whole frame, pre-pass
+ *  included.
+ ***********************************************************/
+void RunPrepassBenchmark(SceneManager* pSceneManager, ViewManager* pViewManager, RenderState* pRenderState)
+{
+	pSceneManager->SetDepthPrepass(true);
+	if (pSceneManager->IsDepthPrepassActive() == false)
+	{
+		std::cout << "Depth pre-pass benchmark needs multi-draw indirect and the depth shaders" << std::endl;
+		return;
+	}
+
+	GLint viewport[4];
+	glGetIntegerv(GL_VIEWPORT, viewport);
+
+	std::cout << "resolution   pixels  | shaded fragments off/on  saved  | GPU ms off/on" << std::endl;
+
+	for (const int* resolution : g_Resolutions)
+	{
+		const int width = resolution[0];
+		const int height = resolution[1];
+
+		GLuint framebuffer = 0;
+		GLuint renderbuffers[2];
+		glGenFramebuffers(1, &framebuffer);
+		glGenRenderbuffers(2, renderbuffers);
+		glBindRenderbuffer(GL_RENDERBUFFER, renderbuffers[0]);
+		glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+		glBindRenderbuffer(GL_RENDERBUFFER, renderbuffers[1]);
+		glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height);
+		glBindRenderbuffer(GL_RENDERBUFFER, 0);
+		glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+		glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, renderbuffers[0]);
+		glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, renderbuffers[1]);
+
+		if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+		{
+			std::cout << "Could not create the benchmark framebuffer:" << width << "x" << height << std::endl;
+		}
+		else
+		{
+			glViewport(0, 0, width, height);
+			MODE_RESULT withoutPrepass = MeasureMode(pSceneManager, pViewManager, pRenderState, false);
+			MODE_RESULT withPrepass = MeasureMode(pSceneManager, pViewManager, pRenderState, true);
+			const double saved = (withoutPrepass.shadedSamples > 0.0) ?
+				100.0 * (1.0 - withPrepass.shadedSamples / withoutPrepass.shadedSamples) : 0.0;
+
+			std::cout << std::fixed << std::setprecision(2)
+				<< std::setw(4) << width << "x" << std::setw(4) << height << "  "
+				<< std::setw(8) << width * height << "  | "
+				<< std::setw(10) << (long long)withoutPrepass.shadedSamples << " / " << std::setw(10) << (long long)withPrepass.shadedSamples << "  "
+				<< std::setw(5) << saved << "%  | "
+				<< std::setw(6) << withoutPrepass.gpuMilliseconds << " / " << std::setw(6) << withPrepass.gpuMilliseconds << std::endl;
+		}
+
+		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+		glDeleteRenderbuffers(2, renderbuffers);
+		glDeleteFramebuffers(1, &framebuffer);
+	}
+
+	glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+	pSceneManager->SetDepthPrepass(false);
+}
@@ -0,0 +1,18 @@
+///////////////////////////////////////////////////////////////////////////////
+// prepassbenchmark.h
+// ============
+// compare the fragments shaded with and without the depth pre-pass at
+// several resolutions
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+class SceneManager;
+class ViewManager;
+class RenderState;
+
+// render the prepared scene offscreen and print the shaded
+// fragments and GPU times to the console, started with the
+// --prepass-benchmark command line argument
+void RunPrepassBenchmark(SceneManager* pSceneManager, ViewManager* pViewManager, RenderState* pRenderState);
@@ -0,0 +1,203 @@
+///////////////////////////////////////////////////////////////////////////////
+// renderqueue.cpp
+// ============
+// collect the draw packets of a frame and sort them by render state
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "RenderQueue.h"
+
+#include <cstddef>
+
+// declare the global variables
+namespace
+{
+	// the key is sorted one byte at a time
+	const int g_RadixBits = 8;
+	const int g_RadixBuckets = 1 << g_RadixBits;
+	const int g_RadixPasses = 64 / g_RadixBits;
+
+	// state key fields that mark a render state change
+	const uint64_t g_StateFieldMasks[] =
+	{
+		0xF000000000000000ull,	// pass
+		0x0F00000000000000ull,	// shader
+		0x00FF000000000000ull,	// mesh
+		0x0000FFFF00000000ull,	// texture
+		0x00000000FFFF0000ull	// material
+	};
+}
+
+/***********************************************************
+ *  MakeSortKey()
+ *
+ *  This method is used for packing the render state of a
+ *  draw packet into its sort key.
+ ***********************************************************/
+uint64_t RenderQueue::MakeSortKey(
+	int pass,
+	int shader,
+	int meshID,
+	int textureID,
+	int materialID,
+	uint32_t depth)
+{
+	uint64_t sortKey = 0;
+
+	sortKey |= (uint64_t)(pass & 0xF) << 60;
+	sortKey |= (uint64_t)(shader & 0xF) << 56;
+	sortKey |= (uint64_t)(meshID & 0xFF) << 48;
+	sortKey |= (uint64_t)((textureID + 1) & 0xFFFF) << 32;
+	sortKey |= (uint64_t)((materialID + 1) & 0xFFFF) << 16;
+	sortKey |= (uint64_t)(depth & 0xFFFF);
+
+	return(sortKey);
+}
+
+/***********************************************************
+ *  MakeDepthSortKey()
+ *
+ *  This method is used for building the key of a packet in a
+ *  pass that is drawn in depth order, the state fields are
+ *  left empty.
+ ***********************************************************/
+uint64_t RenderQueue::MakeDepthSortKey(int pass, uint32_t depth)
+{
+	return(MakeSortKey(pass, 0, 0, -1, -1, depth));
+}
+
+/***********************************************************
+ *  Clear()
+ *
+ *  This method is used for removing all the draw packets,
+ *  the memory is kept for the next frame.
+ ***********************************************************/
+void RenderQueue::Clear()
+{
+	m_packets.clear();
+}
+
+/***********************************************************
+ *  Add()
+ *
+ *  This method is used for adding a draw packet to the end
+ *  of the queue.  Packets ordered by depth pass their state
+ *  as a key of its own, the others carry it in the sort key.
+ ***********************************************************/
+void RenderQueue::Add(uint64_t sortKey, uint32_t payload)
+{
+	Add(sortKey, payload, sortKey);
+}
+
+void RenderQueue::Add(uint64_t sortKey, uint32_t payload, uint64_t stateKey)
+{
+	DRAW_PACKET packet;
+	packet.sortKey = sortKey;
+	packet.stateKey = stateKey;
+	packet.payload = payload;
+	m_packets.push_back(packet);
+}
+
+/***********************************************************
+ *  Append()
+ *
+ *  This method is used for adding packets that were
+ *  recorded into a list of their own, like the ones of a
+ *  recording thread, to the end of the queue in their order.
+ ***********************************************************/
+void RenderQueue::Append(const DRAW_PACKET* packets, int packetCount)
+{
+	m_packets.insert(m_packets.end(), packets, packets + packetCount);
+}
+
+/***********************************************************
+ *  Sort()
+ *
+ *  This method is used for sorting the draw packets by
+ *  their key with a least significant digit radix sort.
+ *  The sort is stable, so packets with the same key keep
+ *  the order they were added in.  Passes over bytes that
+ *  are the same in every key are skipped.
+ ***********************************************************/
+void RenderQueue::Sort()
+{
+	const size_t count = m_packets.size();
+	if (count < 2)
+	{
+		return;
+	}
+
+	m_sortBuffer.resize(count);
+	DRAW_PACKET* source = m_packets.data();
+	DRAW_PACKET* destination = m_sortBuffer.data();
+
+	for (int pass = 0; pass < g_RadixPasses; pass++)
+	{
+		const int shift = pass * g_RadixBits;
+		size_t histogram[g_RadixBuckets] = {};
+
+		for (size_t i = 0; i < count; i++)
+		{
+			histogram[(source[i].sortKey >> shift) & (g_RadixBuckets - 1)]++;
+		}
+
+		// every key has the same byte, nothing to reorder
+		if (histogram[(source[0].sortKey >> shift) & (g_RadixBuckets - 1)] == count)
+		{
+			continue;
+		}
+
+		// turn the histogram into the start offset of each bucket
+		size_t offset = 0;
+		for (int bucket = 0; bucket < g_RadixBuckets; bucket++)
+		{
+			size_t bucketCount = histogram[bucket];
+			histogram[bucket] = offset;
+			offset += bucketCount;
+		}
+
+		for (size_t i = 0; i < count; i++)
+		{
+			destination[histogram[(source[i].sortKey >> shift) & (g_RadixBuckets - 1)]++] = source[i];
+		}
+
+		DRAW_PACKET* swap = source;
+		source = destination;
+		destination = swap;
+	}
+
+	// an odd number of passes leaves the result in the scratch buffer
+	if (source != m_packets.data())
+	{
+		m_packets.swap(m_sortBuffer);
+	}
+}
+
+/***********************************************************
+ *  CountStateChanges()
+ *
+ *  This method is used for counting how many render states
+ *  (pass, shader, mesh, texture and material) would change
+ *  when the packets are submitted in their current order.
+ *  The states come from the state keys, so packets ordered
+ *  by depth are counted with the state they really draw
+ *  with.
+ ***********************************************************/
+int RenderQueue::CountStateChanges() const
+{
+	int stateChanges = 0;
+
+	for (size_t i = 0; i < m_packets.size(); i++)
+	{
+		for (uint64_t mask : g_StateFieldMasks)
+		{
+			// the first packet sets every state
+			if ((i == 0) || ((m_packets[i].stateKey & mask) != (m_packets[i - 1].stateKey & mask)))
+			{
+				stateChanges++;
+			}
+		}
+	}
+
+	return(stateChanges);
+}
@@ -0,0 +1,85 @@
+///////////////////////////////////////////////////////////////////////////////
+// renderqueue.h
+// ============
+// collect the draw packets of a frame and sort them by render state
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+/***********************************************************
+ *  RenderQueue
+ *
+ *  This class collects the draw packets of a frame.  Every
+ *  packet carries a 64-bit sort key built from its render
+ *  state, so that sorting the keys groups the packets that
+ *  share the same state:
+ *
+ *    bits 63-60  pass
+ *    bits 59-56  shader
+ *    bits 55-48  mesh
+ *    bits 47-32  texture slot + 1 (0 = no texture)
+ *    bits 31-16  material + 1 (0 = no material)
+ *    bits 15-0   depth
+ *
+ *  Passes that must be drawn in depth order, like blended
+ *  objects, use a key holding only the pass and the depth,
+ *  so the depth decides the order whatever the state.  The
+ *  packets of those passes carry their state in a key of
+ *  their own, for counting the state changes.
+ ***********************************************************/
+class RenderQueue
+{
+public:
+	struct DRAW_PACKET
+	{
+		uint64_t sortKey;
+		// render state of the packet in the layout of a sort
+		// key, the sort key itself unless ordered by depth
+		uint64_t stateKey;
+		// identifies what to draw, owned by the caller
+		uint32_t payload;
+	};
+
+	// build the sort key for a draw packet
+	static uint64_t MakeSortKey(
+		int pass,
+		int shader,
+		int meshID,
+		int textureID,
+		int materialID,
+		uint32_t depth = 0);
+	// build the sort key for a draw packet ordered by depth only
+	static uint64_t MakeDepthSortKey(int pass, uint32_t depth);
+
+	// get the fields back out of a sort key
+	static int GetPass(uint64_t sortKey) { return (int)(sortKey >> 60); }
+	static int GetShader(uint64_t sortKey) { return (int)((sortKey >> 56) & 0xF); }
+	static int GetMeshID(uint64_t sortKey) { return (int)((sortKey >> 48) & 0xFF); }
+	static int GetTextureID(uint64_t sortKey) { return (int)((sortKey >> 32) & 0xFFFF) - 1; }
+	static int GetMaterialID(uint64_t sortKey) { return (int)((sortKey >> 16) & 0xFFFF) - 1; }
+
+	// remove all the packets
+	void Clear();
+	// add a packet to the end of the queue, with the state
+	// in its sort key or in a state key of its own
+	void Add(uint64_t sortKey, uint32_t payload);
+	void Add(uint64_t sortKey, uint32_t payload, uint64_t stateKey);
+	// add packets recorded elsewhere to the end of the queue
+	void Append(const DRAW_PACKET* packets, int packetCount);
+	// sort the packets by their key
+	void Sort();
+
+	// count the state changes when submitting in the current order
+	int CountStateChanges() const;
+
+	const std::vector<DRAW_PACKET>& GetPackets() const { return m_packets; }
+
+private:
+	std::vector<DRAW_PACKET> m_packets;
+	// scratch buffer for the radix sort passes
+	std::vector<DRAW_PACKET> m_sortBuffer;
+};
@@ -0,0 +1,175 @@
+///////////////////////////////////////////////////////////////////////////////
+// renderstate.cpp
+// ============
+// shadow the OpenGL render state and drop the calls that change nothing
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "RenderState.h"
+
+/***********************************************************
+ *  RenderState()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+RenderState::RenderState()
+{
+	Invalidate();
+	m_stats = STATE_STATS();
+}
+
+/***********************************************************
+ *  Invalidate()
+ *
+ *  This method is used for marking all the shadowed state as
+ *  unknown, so the next call for every state reaches GL.
+ ***********************************************************/
+void RenderState::Invalidate()
+{
+	m_bDepthTest = false;
+	m_bDepthTestKnown = false;
+	m_bDepthWrite = false;
+	m_bDepthWriteKnown = false;
+	m_depthFunc = GL_LESS;
+	m_bDepthFuncKnown = false;
+	m_bColorWrite = false;
+	m_bColorWriteKnown = false;
+	m_bBlending = false;
+	m_bBlendingKnown = false;
+	m_clearColor = glm::vec4(0.0f);
+	m_bClearColorKnown = false;
+}
+
+/***********************************************************
+ *  SetDepthTest()
+ *
+ *  This method is used for enabling or disabling the depth
+ *  test when it is not already in that state.
+ ***********************************************************/
+void RenderState::SetDepthTest(bool bEnabled)
+{
+	if ((m_bDepthTestKnown == true) && (m_bDepthTest == bEnabled))
+	{
+		m_stats.elided++;
+		return;
+	}
+
+	if (bEnabled == true)
+		glEnable(GL_DEPTH_TEST);
+	else
+		glDisable(GL_DEPTH_TEST);
+
+	m_bDepthTest = bEnabled;
+	m_bDepthTestKnown = true;
+	m_stats.issued++;
+}
+
+/***********************************************************
+ *  SetDepthWrite()
+ *
+ *  This method is used for enabling or disabling writes to
+ *  the depth buffer when it is not already in that state.
+ ***********************************************************/
+void RenderState::SetDepthWrite(bool bEnabled)
+{
+	if ((m_bDepthWriteKnown == true) && (m_bDepthWrite == bEnabled))
+	{
+		m_stats.elided++;
+		return;
+	}
+
+	glDepthMask((bEnabled == true) ? GL_TRUE : GL_FALSE);
+
+	m_bDepthWrite = bEnabled;
+	m_bDepthWriteKnown = true;
+	m_stats.issued++;
+}
+
+/***********************************************************
+ *  SetDepthFunc()
+ *
+ *  This method is used for setting the comparison of the
+ *  depth test when it differs from the current one.
+ ***********************************************************/
+void RenderState::SetDepthFunc(GLenum function)
+{
+	if ((m_bDepthFuncKnown == true) && (m_depthFunc == function))
+	{
+		m_stats.elided++;
+		return;
+	}
+
+	glDepthFunc(function);
+
+	m_depthFunc = function;
+	m_bDepthFuncKnown = true;
+	m_stats.issued++;
+}
+
+/***********************************************************
+ *  SetColorWrite()
+ *
+ *  This method is used for enabling or disabling writes to
+ *  every channel of the color buffer when it is not already
+ *  in that state.
+ ***********************************************************/
+void RenderState::SetColorWrite(bool bEnabled)
+{
+	if ((m_bColorWriteKnown == true) && (m_bColorWrite == bEnabled))
+	{
+		m_stats.elided++;
+		return;
+	}
+
+	const GLboolean mask = (bEnabled == true) ? GL_TRUE : GL_FALSE;
+	glColorMask(mask, mask, mask, mask);
+
+	m_bColorWrite = bEnabled;
+	m_bColorWriteKnown = true;
+	m_stats.issued++;
+}
+
+/***********************************************************
+ *  SetBlending()
+ *
+ *  This method is used for enabling or disabling blending
+ *  when it is not already in that state.
+ ***********************************************************/
+void RenderState::SetBlending(bool bEnabled)
+{
+	if ((m_bBlendingKnown == true) && (m_bBlending == bEnabled))
+	{
+		m_stats.elided++;
+		return;
+	}
+
+	if (bEnabled == true)
+		glEnable(GL_BLEND);
+	else
+		glDisable(GL_BLEND);
+
+	m_bBlending = bEnabled;
+	m_bBlendingKnown = true;
+	m_stats.issued++;
+}
+
+/***********************************************************
+ *  SetClearColor()
+ *
+ *  This method is used for setting the clear color when it
+ *  differs from the current one.
+ ***********************************************************/
+void RenderState::SetClearColor(const glm::vec4& color)
+{
+	if ((m_bClearColorKnown == true) && (m_clearColor == color))
+	{
+		m_stats.elided++;
+		return;
+	}
+
+	glClearColor(color.r, color.g, color.b, color.a);
+
+	m_clearColor = color;
+	m_bClearColorKnown = true;
+	m_stats.issued++;
+}
@@ -0,0 +1,72 @@
+///////////////////////////////////////////////////////////////////////////////
+// renderstate.h
+// ============
+// shadow the OpenGL render state and drop the calls that change nothing
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+/***********************************************************
+ *  RenderState
+ *
+ *  This class keeps a copy of the OpenGL render state that
+ *  is set every frame.  A state call with the value GL
+ *  already has is counted and dropped instead of issued.
+ *  The state is unknown until it is first set, so the
+ *  first call for every state always reaches GL.
+ ***********************************************************/
+class RenderState
+{
+public:
+	// constructor
+	RenderState();
+
+	struct STATE_STATS
+	{
+		// state calls passed on to GL
+		int issued = 0;
+		// state calls dropped as no-ops
+		int elided = 0;
+	};
+
+	// enable or disable the depth test
+	void SetDepthTest(bool bEnabled);
+	// enable or disable writes to the depth buffer
+	void SetDepthWrite(bool bEnabled);
+	// set the comparison of the depth test
+	void SetDepthFunc(GLenum function);
+	// enable or disable writes to the color buffer
+	void SetColorWrite(bool bEnabled);
+	// enable or disable blending with the color buffer
+	void SetBlending(bool bEnabled);
+	// set the color the color buffer is cleared to
+	void SetClearColor(const glm::vec4& color);
+
+	// forget the shadowed state, for when GL state was
+	// changed without going through this class
+	void Invalidate();
+	// get and reset the counts of issued and elided calls
+	const STATE_STATS& GetStats() const { return m_stats; }
+	void ResetStats() { m_stats = STATE_STATS(); }
+
+private:
+	// shadowed state, only valid once its flag is set
+	bool m_bDepthTest;
+	bool m_bDepthTestKnown;
+	bool m_bDepthWrite;
+	bool m_bDepthWriteKnown;
+	GLenum m_depthFunc;
+	bool m_bDepthFuncKnown;
+	bool m_bColorWrite;
+	bool m_bColorWriteKnown;
+	bool m_bBlending;
+	bool m_bBlendingKnown;
+	glm::vec4 m_clearColor;
+	bool m_bClearColorKnown;
+	// counts of issued and elided calls
+	STATE_STATS m_stats;
+};
@@ -0,0 +1,105 @@
+///////////////////////////////////////////////////////////////////////////////
+// renderthread.cpp
+// ============
+// draw the frame snapshots on a thread that owns the GL context
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "RenderThread.h"
+
+/***********************************************************
+ *  RenderThread()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+RenderThread::RenderThread()
+{
+	m_bStopping.store(false);
+	m_frameCount.store(0);
+	m_pWindow = nullptr;
+	m_pSnapshots = nullptr;
+}
+
+/***********************************************************
+ *  ~RenderThread()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+RenderThread::~RenderThread()
+{
+	Stop();
+}
+
+/***********************************************************
+ *  Start()
+ *
+ *  This method is used for releasing the window context on
+ *  the calling thread and starting the render thread, which
+ *  makes it current on its own.
+ ***********************************************************/
+void RenderThread::Start(GLFWwindow* pWindow, SnapshotBuffer* pSnapshots, const RENDER_FUNCTION& renderFrame)
+{
+	if (IsRunning() == true)
+	{
+		return;
+	}
+
+	m_pWindow = pWindow;
+	m_pSnapshots = pSnapshots;
+	m_renderFrame = renderFrame;
+	m_bStopping.store(false);
+	m_frameCount.store(0);
+
+	glfwMakeContextCurrent(nullptr);
+	m_thread = std::thread(&RenderThread::Run, this);
+}
+
+/***********************************************************
+ *  Stop()
+ *
+ *  This method is used for stopping the render thread once
+ *  its frame is drawn and taking the window context back.
+ ***********************************************************/
+void RenderThread::Stop()
+{
+	if (IsRunning() == false)
+	{
+		return;
+	}
+
+	m_bStopping.store(true);
+	m_thread.join();
+	glfwMakeContextCurrent(m_pWindow);
+}
+
+/***********************************************************
+ *  Run()
+ *
+ *  This method is used for drawing frames until the thread
+ *  is stopped.  A frame is drawn with the newest snapshot,
+ *  or again with the last one when none was published since,
+ *  like the single thread loop draws a frame on every pass.
+ *  Nothing is drawn before the first snapshot.
+ ***********************************************************/
+void RenderThread::Run()
+{
+	bool bHasSnapshot = false;
+
+	glfwMakeContextCurrent(m_pWindow);
+
+	while (m_bStopping.load() == false)
+	{
+		bHasSnapshot = (m_pSnapshots->Acquire() == true) || (bHasSnapshot == true);
+		if (bHasSnapshot == false)
+		{
+			std::this_thread::yield();
+			continue;
+		}
+
+		m_renderFrame(m_pSnapshots->GetReadSnapshot());
+		glfwSwapBuffers(m_pWindow);
+		m_frameCount.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	glfwMakeContextCurrent(nullptr);
+}
@@ -0,0 +1,62 @@
+///////////////////////////////////////////////////////////////////////////////
+// renderthread.h
+// ============
+// draw the frame snapshots on a thread that owns the GL context
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "SnapshotBuffer.h"
+
+#include "GLFW/glfw3.h"
+
+#include <atomic>
+#include <functional>
+#include <thread>
+
+/***********************************************************
+ *  RenderThread
+ *
+ *  This class runs the rendering on a thread of its own.
+ *  The context of the window is moved to the thread when it
+ *  starts and handed back to the calling thread when it
+ *  stops, so only the render thread makes GL calls in
+ *  between.  Every frame draws the newest snapshot of the
+ *  snapshot buffer with the passed in function and swaps
+ *  the window buffers, so the update thread is free to
+ *  poll the input while the frame is drawn.
+ ***********************************************************/
+class RenderThread
+{
+public:
+	// draws one frame from a snapshot, on the render thread
+	typedef std::function<void(const SnapshotBuffer::FRAME_SNAPSHOT&)> RENDER_FUNCTION;
+
+	// constructor
+	RenderThread();
+	// destructor
+	~RenderThread();
+
+	// start drawing the snapshots of the buffer, the window
+	// context must be current on the calling thread
+	void Start(GLFWwindow* pWindow, SnapshotBuffer* pSnapshots, const RENDER_FUNCTION& renderFrame);
+	// stop after the frame being drawn and make the window
+	// context current on the calling thread again
+	void Stop();
+	bool IsRunning() const { return m_thread.joinable(); }
+
+	// frames drawn since the thread was started
+	int GetFrameCount() const { return m_frameCount.load(std::memory_order_relaxed); }
+
+private:
+	std::thread m_thread;
+	std::atomic<bool> m_bStopping;
+	std::atomic<int> m_frameCount;
+	GLFWwindow* m_pWindow;
+	SnapshotBuffer* m_pSnapshots;
+	RENDER_FUNCTION m_renderFrame;
+
+	// the loop run by the render thread
+	void Run();
+};
@@ -0,0 +1,602 @@
+///////////////////////////////////////////////////////////////////////////////
+// scenebvh.cpp
+// ============
+// bounding volume hierarchy over the scene object boxes for culling and
+// spatial queries
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "SceneBVH.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+// declare the global variables
+namespace
+{
+	// number of bins the split candidates are taken from
+	const int g_SplitBins = 12;
+	// a node with this many primitives or fewer may become a
+	// leaf, and it has to once the tree is this deep
+	const int g_MaxLeafSize = 4;
+	const int g_MaxDepth = 48;
+	// size of the traversal stacks, enough for g_MaxDepth
+	const int g_StackSize = 64;
+	// cost of visiting a node, relative to testing a primitive
+	const float g_TraversalCost = 1.0f;
+
+	// surface area of a box, half of it is enough for the
+	// cost comparisons
+	float HalfArea(const glm::vec3& boundsMin, const glm::vec3& boundsMax)
+	{
+		glm::vec3 size = boundsMax - boundsMin;
+		return((size.x * size.y) + (size.y * size.z) + (size.z * size.x));
+	}
+
+	struct SPLIT_BIN
+	{
+		glm::vec3 boundsMin;
+		glm::vec3 boundsMax;
+		int count;
+	};
+}
+
+/***********************************************************
+ *  SceneBVH()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+SceneBVH::SceneBVH()
+{
+	m_bDirty = false;
+}
+
+/***********************************************************
+ *  Resize()
+ *
+ *  This method is used for setting the number of primitive
+ *  boxes the tree can be built over.
+ ***********************************************************/
+void SceneBVH::Resize(int count)
+{
+	m_boundsMin.resize(count, glm::vec3(0.0f));
+	m_boundsMax.resize(count, glm::vec3(0.0f));
+}
+
+/***********************************************************
+ *  SetBounds()
+ *
+ *  This method is used for setting the box of a primitive.
+ *  A built tree is refit on the next Refit() call.  Boxes of
+ *  different primitives can be set from different threads.
+ ***********************************************************/
+void SceneBVH::SetBounds(int index, const glm::vec3& boundsMin, const glm::vec3& boundsMax)
+{
+	m_boundsMin[index] = boundsMin;
+	m_boundsMax[index] = boundsMax;
+	m_bDirty.store(true, std::memory_order_relaxed);
+}
+
+/***********************************************************
+ *  Build()
+ *
+ *  This method is used for building the tree over the
+ *  passed in primitives, replacing the current tree.
+ ***********************************************************/
+void SceneBVH::Build(const std::vector<int>& primitives)
+{
+	m_primitives = primitives;
+	m_nodes.clear();
+	m_bDirty = false;
+
+	if (m_primitives.empty() == true)
+	{
+		return;
+	}
+
+	// a binary tree with leaves of one or more primitives
+	// never has more than 2n - 1 nodes
+	m_nodes.reserve(m_primitives.size() * 2);
+	m_nodes.push_back(NODE());
+	BuildNode(0, 0, (int)m_primitives.size(), 0);
+	m_nodes.shrink_to_fit();
+}
+
+/***********************************************************
+ *  UpdateNodeBounds()
+ *
+ *  This method is used for setting the box of a node to the
+ *  box around a range of the primitive list.
+ ***********************************************************/
+void SceneBVH::UpdateNodeBounds(NODE& node, int first, int count) const
+{
+	node.boundsMin = glm::vec3(FLT_MAX);
+	node.boundsMax = glm::vec3(-FLT_MAX);
+	for (int i = first; i < first + count; i++)
+	{
+		int primitive = m_primitives[i];
+		node.boundsMin = glm::min(node.boundsMin, m_boundsMin[primitive]);
+		node.boundsMax = glm::max(node.boundsMax, m_boundsMax[primitive]);
+	}
+}
+
+/***********************************************************
+ *  BuildNode()
+ *
+ *  This method is used for building the subtree of a node
+ *  over a range of the primitive list.  The primitive
+ *  centers are sorted into bins along every axis, and the
+ *  split between two bins with the lowest surface area
+ *  cost is taken, unless keeping the node as a leaf is
+ *  cheaper.  The left child is built right after its parent
+ *  and the right child after the whole left subtree.
+ ***********************************************************/
+void SceneBVH::BuildNode(int nodeIndex, int first, int count, int depth)
+{
+	UpdateNodeBounds(m_nodes[nodeIndex], first, count);
+	m_nodes[nodeIndex].firstOrRight = first;
+	m_nodes[nodeIndex].count = count;
+
+	if ((count <= 1) || (depth >= g_MaxDepth))
+	{
+		return;
+	}
+
+	// the bins are spread over the box of the centers
+	glm::vec3 centerMin(FLT_MAX);
+	glm::vec3 centerMax(-FLT_MAX);
+	for (int i = first; i < first + count; i++)
+	{
+		int primitive = m_primitives[i];
+		glm::vec3 center = (m_boundsMin[primitive] + m_boundsMax[primitive]) * 0.5f;
+		centerMin = glm::min(centerMin, center);
+		centerMax = glm::max(centerMax, center);
+	}
+
+	int bestAxis = -1;
+	int bestSplit = 0;
+	float bestCost = FLT_MAX;
+
+	for (int axis = 0; axis < 3; axis++)
+	{
+		float extent = centerMax[axis] - centerMin[axis];
+		if (extent <= 0.0f)
+		{
+			continue;
+		}
+
+		SPLIT_BIN bins[g_SplitBins];
+		for (SPLIT_BIN& bin : bins)
+		{
+			bin.boundsMin = glm::vec3(FLT_MAX);
+			bin.boundsMax = glm::vec3(-FLT_MAX);
+			bin.count = 0;
+		}
+
+		const float scale = g_SplitBins / extent;
+		for (int i = first; i < first + count; i++)
+		{
+			int primitive = m_primitives[i];
+			float center = (m_boundsMin[primitive][axis] + m_boundsMax[primitive][axis]) * 0.5f;
+			int bin = std::min(g_SplitBins - 1, (int)((center - centerMin[axis]) * scale));
+			bins[bin].boundsMin = glm::min(bins[bin].boundsMin, m_boundsMin[primitive]);
+			bins[bin].boundsMax = glm::max(bins[bin].boundsMax, m_boundsMax[primitive]);
+			bins[bin].count++;
+		}
+
+		// sweep from both sides to get the cost of the left
+		// and right halves of every split
+		float leftArea[g_SplitBins - 1];
+		int leftCount[g_SplitBins - 1];
+		glm::vec3 sweepMin(FLT_MAX);
+		glm::vec3 sweepMax(-FLT_MAX);
+		int sweepCount = 0;
+		for (int split = 0; split < g_SplitBins - 1; split++)
+		{
+			if (bins[split].count > 0)
+			{
+				sweepMin = glm::min(sweepMin, bins[split].boundsMin);
+				sweepMax = glm::max(sweepMax, bins[split].boundsMax);
+				sweepCount += bins[split].count;
+			}
+			leftArea[split] = (sweepCount > 0) ? HalfArea(sweepMin, sweepMax) : 0.0f;
+			leftCount[split] = sweepCount;
+		}
+
+		sweepMin = glm::vec3(FLT_MAX);
+		sweepMax = glm::vec3(-FLT_MAX);
+		sweepCount = 0;
+		for (int split = g_SplitBins - 2; split >= 0; split--)
+		{
+			if (bins[split + 1].count > 0)
+			{
+				sweepMin = glm::min(sweepMin, bins[split + 1].boundsMin);
+				sweepMax = glm::max(sweepMax, bins[split + 1].boundsMax);
+				sweepCount += bins[split + 1].count;
+			}
+			if ((leftCount[split] == 0) || (sweepCount == 0))
+			{
+				continue;
+			}
+
+			float cost = (leftArea[split] * leftCount[split]) + (HalfArea(sweepMin, sweepMax) * sweepCount);
+			if (cost < bestCost)
+			{
+				bestCost = cost;
+				bestAxis = axis;
+				bestSplit = split;
+			}
+		}
+	}
+
+	// a leaf costs testing all its primitives, a split costs
+	// visiting the two children on top of their primitives,
+	// small nodes stay leaves unless the split is cheaper
+	const NODE& node = m_nodes[nodeIndex];
+	const float nodeArea = HalfArea(node.boundsMin, node.boundsMax);
+	float leafCost = nodeArea * count;
+	float splitCost = (nodeArea * g_TraversalCost) + bestCost;
+	if ((bestAxis < 0) || ((count <= g_MaxLeafSize) && (splitCost >= leafCost)))
+	{
+		return;
+	}
+
+	// partition the primitives on the chosen split
+	const float scale = g_SplitBins / (centerMax[bestAxis] - centerMin[bestAxis]);
+	int* pBegin = m_primitives.data() + first;
+	int* pMiddle = std::partition(pBegin, pBegin + count, [&](int primitive)
+		{
+			float center = (m_boundsMin[primitive][bestAxis] + m_boundsMax[primitive][bestAxis]) * 0.5f;
+			int bin = std::min(g_SplitBins - 1, (int)((center - centerMin[bestAxis]) * scale));
+			return(bin <= bestSplit);
+		});
+	int leftCountTotal = (int)(pMiddle - pBegin);
+	if ((leftCountTotal == 0) || (leftCountTotal == count))
+	{
+		return;
+	}
+
+	int leftIndex = (int)m_nodes.size();
+	m_nodes.push_back(NODE());
+	BuildNode(leftIndex, first, leftCountTotal, depth + 1);
+
+	int rightIndex = (int)m_nodes.size();
+	m_nodes.push_back(NODE());
+	BuildNode(rightIndex, first + leftCountTotal, count - leftCountTotal, depth + 1);
+
+	m_nodes[nodeIndex].firstOrRight = rightIndex;
+	m_nodes[nodeIndex].count = 0;
+}
+
+/***********************************************************
+ *  Refit()
+ *
+ *  This method is used for updating the node boxes from the
+ *  primitive boxes.  Children always come after their
+ *  parent in the node array, so one backwards pass sees
+ *  every child before its parent.
+ ***********************************************************/
+void SceneBVH::Refit()
+{
+	if ((m_bDirty == false) || (m_nodes.empty() == true))
+	{
+		return;
+	}
+
+	for (int i = (int)m_nodes.size() - 1; i >= 0; i--)
+	{
+		NODE& node = m_nodes[i];
+		if (node.count > 0)
+		{
+			UpdateNodeBounds(node, node.firstOrRight, node.count);
+		}
+		else
+		{
+			const NODE& left = m_nodes[i + 1];
+			const NODE& right = m_nodes[node.firstOrRight];
+			node.boundsMin = glm::min(left.boundsMin, right.boundsMin);
+			node.boundsMax = glm::max(left.boundsMax, right.boundsMax);
+		}
+	}
+
+	m_bDirty = false;
+}
+
+/***********************************************************
+ *  MarkSubtree()
+ *
+ *  This method is used for marking all the primitives under
+ *  a node as visible without testing them.
+ ***********************************************************/
+void SceneBVH::MarkSubtree(int nodeIndex, uint8_t* visible) const
+{
+	// the subtree is one run of the primitive list, from the
+	// leftmost leaf to the end of the rightmost leaf
+	int leftmost = nodeIndex;
+	while (m_nodes[leftmost].count == 0)
+	{
+		leftmost = leftmost + 1;
+	}
+	int rightmost = nodeIndex;
+	while (m_nodes[rightmost].count == 0)
+	{
+		rightmost = m_nodes[rightmost].firstOrRight;
+	}
+
+	int first = m_nodes[leftmost].firstOrRight;
+	int last = m_nodes[rightmost].firstOrRight + m_nodes[rightmost].count;
+	for (int i = first; i < last; i++)
+	{
+		visible[m_primitives[i]] = 1;
+	}
+}
+
+/***********************************************************
+ *  QueryFrustum()
+ *
+ *  This method is used for finding the primitives inside or
+ *  crossing the frustum.  A node outside of any plane is
+ *  skipped with its whole subtree, and a node inside all
+ *  the planes marks its subtree visible without testing it.
+ ***********************************************************/
+void SceneBVH::QueryFrustum(const glm::vec4 planes[6], uint8_t* visible) const
+{
+	if (m_nodes.empty() == true)
+	{
+		return;
+	}
+
+	int stack[g_StackSize];
+	int stackSize = 0;
+	stack[stackSize++] = 0;
+
+	while (stackSize > 0)
+	{
+		int nodeIndex = stack[--stackSize];
+		const NODE& node = m_nodes[nodeIndex];
+
+		glm::vec3 center = (node.boundsMin + node.boundsMax) * 0.5f;
+		glm::vec3 extents = (node.boundsMax - node.boundsMin) * 0.5f;
+		bool bOutside = false;
+		bool bInside = true;
+		for (int p = 0; (p < 6) && (bOutside == false); p++)
+		{
+			const glm::vec4& plane = planes[p];
+			float distance = plane.x * center.x + plane.y * center.y + plane.z * center.z + plane.w;
+			float radius =
+				std::fabs(plane.x) * extents.x +
+				std::fabs(plane.y) * extents.y +
+				std::fabs(plane.z) * extents.z;
+			bOutside = (distance + radius < 0.0f);
+			bInside = bInside && (distance - radius >= 0.0f);
+		}
+
+		if (bOutside == true)
+		{
+			continue;
+		}
+		if (bInside == true)
+		{
+			MarkSubtree(nodeIndex, visible);
+		}
+		else if (node.count > 0)
+		{
+			// a leaf crossing the frustum tests its primitives
+			for (int i = node.firstOrRight; i < node.firstOrRight + node.count; i++)
+			{
+				int primitive = m_primitives[i];
+				glm::vec3 primitiveCenter = (m_boundsMin[primitive] + m_boundsMax[primitive]) * 0.5f;
+				glm::vec3 primitiveExtents = (m_boundsMax[primitive] - m_boundsMin[primitive]) * 0.5f;
+				bool bPrimitiveOutside = false;
+				for (int p = 0; (p < 6) && (bPrimitiveOutside == false); p++)
+				{
+					const glm::vec4& plane = planes[p];
+					float distance = plane.x * primitiveCenter.x + plane.y * primitiveCenter.y + plane.z * primitiveCenter.z + plane.w;
+					float radius =
+						std::fabs(plane.x) * primitiveExtents.x +
+						std::fabs(plane.y) * primitiveExtents.y +
+						std::fabs(plane.z) * primitiveExtents.z;
+					bPrimitiveOutside = (distance + radius < 0.0f);
+				}
+				if (bPrimitiveOutside == false)
+				{
+					visible[primitive] = 1;
+				}
+			}
+		}
+		else
+		{
+			stack[stackSize++] = node.firstOrRight;
+			stack[stackSize++] = nodeIndex + 1;
+		}
+	}
+}
+
+/***********************************************************
+ *  IntersectRay()
+ *
+ *  This method is used for intersecting a ray with a box
+ *  using the slab test.  It returns the distance along the
+ *  ray where it enters the box, 0 when it starts inside,
+ *  and -1 when the box is missed within the max distance.
+ ***********************************************************/
+float SceneBVH::IntersectRay(
+	const glm::vec3& origin,
+	const glm::vec3& inverseDirection,
+	const glm::vec3& boundsMin,
+	const glm::vec3& boundsMax,
+	float maxDistance)
+{
+	float nearDistance = 0.0f;
+	float farDistance = maxDistance;
+
+	for (int axis = 0; axis < 3; axis++)
+	{
+		float t0 = (boundsMin[axis] - origin[axis]) * inverseDirection[axis];
+		float t1 = (boundsMax[axis] - origin[axis]) * inverseDirection[axis];
+		nearDistance = std::max(nearDistance, std::min(t0, t1));
+		farDistance = std::min(farDistance, std::max(t0, t1));
+	}
+
+	return((nearDistance <= farDistance) ? nearDistance : -1.0f);
+}
+
+/***********************************************************
+ *  Raycast()
+ *
+ *  This method is used for finding the primitive box that a
+ *  ray hits first.  The closer child is visited first, and
+ *  a node farther away than the closest hit so far is
+ *  skipped.
+ ***********************************************************/
+int SceneBVH::Raycast(
+	const glm::vec3& origin,
+	const glm::vec3& direction,
+	float maxDistance,
+	float& hitDistance) const
+{
+	int hitPrimitive = -1;
+	hitDistance = maxDistance;
+
+	if (m_nodes.empty() == true)
+	{
+		return(hitPrimitive);
+	}
+
+	const glm::vec3 inverseDirection(1.0f / direction.x, 1.0f / direction.y, 1.0f / direction.z);
+
+	int stack[g_StackSize];
+	int stackSize = 0;
+	if (IntersectRay(origin, inverseDirection, m_nodes[0].boundsMin, m_nodes[0].boundsMax, hitDistance) >= 0.0f)
+	{
+		stack[stackSize++] = 0;
+	}
+
+	while (stackSize > 0)
+	{
+		const NODE& node = m_nodes[stack[--stackSize]];
+
+		if (node.count > 0)
+		{
+			for (int i = node.firstOrRight; i < node.firstOrRight + node.count; i++)
+			{
+				int primitive = m_primitives[i];
+				float distance = IntersectRay(origin, inverseDirection, m_boundsMin[primitive], m_boundsMax[primitive], hitDistance);
+				if ((distance >= 0.0f) && ((hitPrimitive < 0) || (distance < hitDistance)))
+				{
+					hitDistance = distance;
+					hitPrimitive = primitive;
+				}
+			}
+			continue;
+		}
+
+		int leftIndex = (int)(&node - m_nodes.data()) + 1;
+		int rightIndex = node.firstOrRight;
+		float leftDistance = IntersectRay(origin, inverseDirection, m_nodes[leftIndex].boundsMin, m_nodes[leftIndex].boundsMax, hitDistance);
+		float rightDistance = IntersectRay(origin, inverseDirection, m_nodes[rightIndex].boundsMin, m_nodes[rightIndex].boundsMax, hitDistance);
+
+		// push the farther child first, so the closer one is
+		// visited next
+		if ((leftDistance >= 0.0f) && (rightDistance >= 0.0f))
+		{
+			bool bLeftFirst = (leftDistance <= rightDistance);
+			stack[stackSize++] = bLeftFirst ? rightIndex : leftIndex;
+			stack[stackSize++] = bLeftFirst ? leftIndex : rightIndex;
+		}
+		else if (leftDistance >= 0.0f)
+		{
+			stack[stackSize++] = leftIndex;
+		}
+		else if (rightDistance >= 0.0f)
+		{
+			stack[stackSize++] = rightIndex;
+		}
+	}
+
+	return(hitPrimitive);
+}
+
+/***********************************************************
+ *  DistanceSquared()
+ *
+ *  This method is used for getting the squared distance from
+ *  a point to the closest point of a box, 0 inside the box.
+ ***********************************************************/
+float SceneBVH::DistanceSquared(
+	const glm::vec3& point,
+	const glm::vec3& boundsMin,
+	const glm::vec3& boundsMax)
+{
+	float distanceSquared = 0.0f;
+
+	for (int axis = 0; axis < 3; axis++)
+	{
+		float outside = std::max(boundsMin[axis] - point[axis], 0.0f) + std::max(point[axis] - boundsMax[axis], 0.0f);
+		distanceSquared += outside * outside;
+	}
+
+	return(distanceSquared);
+}
+
+/***********************************************************
+ *  FindNearest()
+ *
+ *  This method is used for finding the primitive box that is
+ *  closest to a point.  The closer child is visited first,
+ *  and a node farther away than the closest box so far is
+ *  skipped.
+ ***********************************************************/
+int SceneBVH::FindNearest(
+	const glm::vec3& point,
+	float maxDistance,
+	float& nearestDistance) const
+{
+	int nearestPrimitive = -1;
+	float nearestSquared = maxDistance * maxDistance;
+
+	if (m_nodes.empty() == false)
+	{
+		int stack[g_StackSize];
+		int stackSize = 0;
+		stack[stackSize++] = 0;
+
+		while (stackSize > 0)
+		{
+			int nodeIndex = stack[--stackSize];
+			const NODE& node = m_nodes[nodeIndex];
+			if (DistanceSquared(point, node.boundsMin, node.boundsMax) > nearestSquared)
+			{
+				continue;
+			}
+
+			if (node.count > 0)
+			{
+				for (int i = node.firstOrRight; i < node.firstOrRight + node.count; i++)
+				{
+					int primitive = m_primitives[i];
+					float distanceSquared = DistanceSquared(point, m_boundsMin[primitive], m_boundsMax[primitive]);
+					if (distanceSquared <= nearestSquared)
+					{
+						nearestSquared = distanceSquared;
+						nearestPrimitive = primitive;
+					}
+				}
+				continue;
+			}
+
+			int leftIndex = nodeIndex + 1;
+			int rightIndex = node.firstOrRight;
+			float leftSquared = DistanceSquared(point, m_nodes[leftIndex].boundsMin, m_nodes[leftIndex].boundsMax);
+			float rightSquared = DistanceSquared(point, m_nodes[rightIndex].boundsMin, m_nodes[rightIndex].boundsMax);
+			bool bLeftFirst = (leftSquared <= rightSquared);
+			stack[stackSize++] = bLeftFirst ? rightIndex : leftIndex;
+			stack[stackSize++] = bLeftFirst ? leftIndex : rightIndex;
+		}
+	}
+
+	nearestDistance = std::sqrt(nearestSquared);
+
+	return(nearestPrimitive);
+}
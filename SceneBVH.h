@@ -0,0 +1,113 @@
+///////////////////////////////////////////////////////////////////////////////
+// scenebvh.h
+// ============
+// bounding volume hierarchy over the scene object boxes for culling and
+// spatial queries
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+/***********************************************************
+ *  SceneBVH
+ *
+ *  This class builds a binary tree of bounding boxes over a
+ *  set of primitive boxes, split by the surface area
+ *  heuristic.  The nodes are flattened into one array in
+ *  depth-first order, so the left child of a node is always
+ *  the next node and a node is 32 bytes, two per cache line.
+ *
+ *  When primitives move, Refit() grows and shrinks the node
+ *  boxes without changing the tree.  The tree only needs to
+ *  be built again when the primitives moved so far that the
+ *  queries slow down.
+ *
+ *  The queries are frustum culling, the closest box hit by a
+ *  ray and the box closest to a point.  They test the boxes
+ *  of the primitives, not their meshes.
+ ***********************************************************/
+class SceneBVH
+{
+public:
+	// constructor
+	SceneBVH();
+
+	// flattened tree node, a leaf when count is not 0
+	struct NODE
+	{
+		glm::vec3 boundsMin;
+		// leaf: first entry in the primitive list
+		// interior: index of the right child
+		int32_t firstOrRight;
+		glm::vec3 boundsMax;
+		int32_t count;
+	};
+
+	// set the number of primitive boxes, keeping the existing
+	void Resize(int count);
+	// set the box of a primitive, the tree is refit with it
+	void SetBounds(int index, const glm::vec3& boundsMin, const glm::vec3& boundsMax);
+
+	// build the tree over the passed in primitives
+	void Build(const std::vector<int>& primitives);
+	// update the node boxes after primitives moved
+	void Refit();
+
+	bool IsBuilt() const { return m_nodes.empty() == false; }
+	int GetNodeCount() const { return (int)m_nodes.size(); }
+	const std::vector<NODE>& GetNodes() const { return m_nodes; }
+
+	// set visible[primitive] to 1 for the primitives in or
+	// crossing the frustum, the others are left unchanged
+	void QueryFrustum(const glm::vec4 planes[6], uint8_t* visible) const;
+	// find the closest primitive hit by a ray, -1 if none
+	int Raycast(
+		const glm::vec3& origin,
+		const glm::vec3& direction,
+		float maxDistance,
+		float& hitDistance) const;
+	// find the primitive closest to a point, -1 if none is
+	// within the maximum distance
+	int FindNearest(
+		const glm::vec3& point,
+		float maxDistance,
+		float& nearestDistance) const;
+
+	// distance along a ray to a box, -1 when it is missed
+	static float IntersectRay(
+		const glm::vec3& origin,
+		const glm::vec3& inverseDirection,
+		const glm::vec3& boundsMin,
+		const glm::vec3& boundsMax,
+		float maxDistance);
+	// squared distance from a point to a box
+	static float DistanceSquared(
+		const glm::vec3& point,
+		const glm::vec3& boundsMin,
+		const glm::vec3& boundsMax);
+
+private:
+	// box of every primitive, by primitive index
+	std::vector<glm::vec3> m_boundsMin;
+	std::vector<glm::vec3> m_boundsMax;
+	// primitives in the tree, leaves point into it
+	std::vector<int> m_primitives;
+	std::vector<NODE> m_nodes;
+	// set when a primitive box changed since the last refit,
+	// the boxes of different primitives may be set by several
+	// threads at once
+	std::atomic<bool> m_bDirty;
+
+	// build the subtree over a range of the primitive list
+	void BuildNode(int nodeIndex, int first, int count, int depth);
+	// set a node box to enclose a range of the primitives
+	void UpdateNodeBounds(NODE& node, int first, int count) const;
+	// mark every primitive under a node as visible
+	void MarkSubtree(int nodeIndex, uint8_t* visible) const;
+};
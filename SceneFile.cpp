@@ -0,0 +1,516 @@
+///////////////////////////////////////////////////////////////////////////////
+// scenefile.cpp
+// ============
+// load the scene description from the text (authoring) format or the
+// compact binary (loading) format
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "SceneFile.h"
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+// declare the global variables
+namespace
+{
+	// names of the meshes in the text format, in SCENE_MESH order
+	const char* g_MeshNames[MESH_COUNT] =
+	{
+		"box",
+		"plane",
+		"cylinder",
+		"cone",
+		"prism",
+		"pyramid4",
+		"sphere",
+		"taperedcylinder",
+		"torus"
+	};
+
+	// binary file identification
+	const char g_BinaryMagic[4] = { 'S', 'C', 'N', 'B' };
+	const uint32_t g_BinaryVersion = 3;
+
+	struct BINARY_HEADER
+	{
+		char magic[4];
+		uint32_t version;
+		uint32_t sourceHash;
+		uint32_t textureTagCount;
+		uint32_t materialTagCount;
+		uint32_t nodeCount;
+		uint32_t objectCount;
+	};
+
+	/***********************************************************
+	 *  HashText()
+	 *
+	 *  FNV-1a hash of the text scene, used to detect when the
+	 *  binary file is older than the text it was built from.
+	 ***********************************************************/
+	uint32_t HashText(const std::string& text)
+	{
+		uint32_t hash = 2166136261u;
+		for (unsigned char c : text)
+		{
+			hash ^= c;
+			hash *= 16777619u;
+		}
+		return(hash);
+	}
+
+	/***********************************************************
+	 *  ReadFloats()
+	 *
+	 *  Read a fixed number of float values for an object field.
+	 ***********************************************************/
+	bool ReadFloats(std::istringstream& stream, float* values, int count)
+	{
+		for (int i = 0; i < count; i++)
+		{
+			if (!(stream >> values[i]))
+			{
+				return(false);
+			}
+		}
+		return(true);
+	}
+
+	/***********************************************************
+	 *  WriteTags()
+	 *
+	 *  Write a tag table as length prefixed strings.
+	 ***********************************************************/
+	bool WriteTags(std::ofstream& file, const std::vector<std::string>& tags)
+	{
+		for (const std::string& tag : tags)
+		{
+			uint32_t length = (uint32_t)tag.size();
+			file.write((const char*)&length, sizeof(length));
+			file.write(tag.data(), length);
+		}
+		return(file.good());
+	}
+
+	/***********************************************************
+	 *  ReadTags()
+	 *
+	 *  Read a tag table written by WriteTags().
+	 ***********************************************************/
+	bool ReadTags(std::ifstream& file, std::vector<std::string>& tags, uint32_t count)
+	{
+		tags.resize(count);
+		for (uint32_t i = 0; i < count; i++)
+		{
+			uint32_t length = 0;
+			file.read((char*)&length, sizeof(length));
+			if (!file.good() || length > 256)
+			{
+				return(false);
+			}
+			tags[i].resize(length);
+			file.read(&tags[i][0], length);
+		}
+		return(file.good());
+	}
+}
+
+/***********************************************************
+ *  Load()
+ *
+ *  This method is used for loading the scene.  The binary
+ *  file is used when it was built from the current text
+ *  file, otherwise the text file is parsed and the binary
+ *  file is rebuilt from it.  When only the binary file is
+ *  present it is loaded as is.
+ ***********************************************************/
+bool SceneFile::Load(const char* textFilename, const char* binaryFilename)
+{
+	std::ifstream textFile(textFilename, std::ios::binary);
+	if (!textFile.is_open())
+	{
+		return(ReadBinary(binaryFilename, false, 0));
+	}
+
+	std::stringstream buffer;
+	buffer << textFile.rdbuf();
+	std::string text = buffer.str();
+	uint32_t sourceHash = HashText(text);
+
+	if (ReadBinary(binaryFilename, true, sourceHash) == true)
+	{
+		return(true);
+	}
+
+	if (ParseText(textFilename, text) == false)
+	{
+		return(false);
+	}
+
+	std::cout << "Rebuilding binary scene:" << binaryFilename << std::endl;
+	if (WriteBinary(binaryFilename, sourceHash) == false)
+	{
+		std::cout << "Could not write binary scene:" << binaryFilename << std::endl;
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *  ParseText()
+ *
+ *  This method is used for parsing the text scene format.
+ *  Each "object" line holds one object and its fields, and
+ *  each "node" line a named node that objects and nodes
+ *  after it can be parented to, see scenes/desk.scene for
+ *  the description of the format.
+ ***********************************************************/
+bool SceneFile::ParseText(const char* filename, const std::string& text)
+{
+	std::istringstream lines(text);
+	std::string line;
+	int lineNumber = 0;
+
+	textureTags.clear();
+	materialTags.clear();
+	nodeNames.clear();
+	nodes.clear();
+	objects.clear();
+
+	while (std::getline(lines, line))
+	{
+		lineNumber++;
+
+		// strip the comments
+		size_t comment = line.find('#');
+		if (comment != std::string::npos)
+		{
+			line.erase(comment);
+		}
+
+		std::istringstream stream(line);
+		std::string keyword;
+		if (!(stream >> keyword))
+		{
+			continue;
+		}
+
+		if ((keyword != "object") && (keyword != "node"))
+		{
+			std::cout << filename << "(" << lineNumber << "): unknown keyword '" << keyword << "'" << std::endl;
+			return(false);
+		}
+		const bool bNode = (keyword == "node");
+
+		NODE_RECORD node = {};
+		node.parentIndex = -1;
+		node.scaleXYZ[0] = node.scaleXYZ[1] = node.scaleXYZ[2] = 1.0f;
+
+		OBJECT_RECORD object = {};
+		object.parentIndex = -1;
+		object.textureIndex = -1;
+		object.materialIndex = -1;
+		object.color[0] = object.color[1] = object.color[2] = object.color[3] = 1.0f;
+		object.uvScale[0] = object.uvScale[1] = 1.0f;
+		object.scaleXYZ[0] = object.scaleXYZ[1] = object.scaleXYZ[2] = 1.0f;
+
+		std::string name;
+		stream >> name;
+		if (bNode == true)
+		{
+			if ((name.empty() == true) || (FindNode(name) >= 0))
+			{
+				std::cout << filename << "(" << lineNumber << "): missing or repeated node name '" << name << "'" << std::endl;
+				return(false);
+			}
+		}
+		else
+		{
+			object.meshID = FindMeshID(name);
+			if (object.meshID < 0)
+			{
+				std::cout << filename << "(" << lineNumber << "): unknown mesh '" << name << "'" << std::endl;
+				return(false);
+			}
+		}
+
+		// the transform fields are shared by nodes and objects
+		float* scaleXYZ = (bNode == true) ? node.scaleXYZ : object.scaleXYZ;
+		float* rotationXYZ = (bNode == true) ? node.rotationXYZ : object.rotationXYZ;
+		float* positionXYZ = (bNode == true) ? node.positionXYZ : object.positionXYZ;
+		int32_t& parentIndex = (bNode == true) ? node.parentIndex : object.parentIndex;
+
+		std::string field;
+		while (stream >> field)
+		{
+			bool bValid = true;
+			std::string tag;
+
+			if (field == "scale")
+				bValid = ReadFloats(stream, scaleXYZ, 3);
+			else if (field == "rotation")
+				bValid = ReadFloats(stream, rotationXYZ, 3);
+			else if (field == "position")
+				bValid = ReadFloats(stream, positionXYZ, 3);
+			else if (field == "parent")
+			{
+				// parents are defined before their children
+				bValid = (bool)(stream >> tag);
+				parentIndex = FindNode(tag);
+				if ((bValid == true) && (parentIndex < 0))
+				{
+					std::cout << filename << "(" << lineNumber << "): unknown node '" << tag << "'" << std::endl;
+					return(false);
+				}
+			}
+			else if (field == "static")
+			{
+				node.flags |= NODE_FLAG_STATIC;
+				object.flags |= OBJECT_FLAG_STATIC;
+			}
+			else if ((bNode == false) && (field == "occluder"))
+				object.flags |= OBJECT_FLAG_OCCLUDER;
+			else if ((bNode == false) && (field == "color"))
+				bValid = ReadFloats(stream, object.color, 4);
+			else if ((bNode == false) && (field == "uvscale"))
+				bValid = ReadFloats(stream, object.uvScale, 2);
+			else if ((bNode == false) && (field == "texture"))
+			{
+				bValid = (bool)(stream >> tag);
+				object.textureIndex = AddTag(textureTags, tag);
+			}
+			else if ((bNode == false) && (field == "material"))
+			{
+				bValid = (bool)(stream >> tag);
+				object.materialIndex = AddTag(materialTags, tag);
+			}
+			else
+			{
+				std::cout << filename << "(" << lineNumber << "): unknown field '" << field << "'" << std::endl;
+				return(false);
+			}
+
+			if (bValid == false)
+			{
+				std::cout << filename << "(" << lineNumber << "): missing values for '" << field << "'" << std::endl;
+				return(false);
+			}
+		}
+
+		if (bNode == true)
+		{
+			nodeNames.push_back(name);
+			nodes.push_back(node);
+		}
+		else
+		{
+			objects.push_back(object);
+		}
+	}
+
+	std::cout << "Successfully parsed scene:" << filename << ", nodes:" << nodes.size() << ", objects:" << objects.size() << std::endl;
+
+	return(true);
+}
+
+/***********************************************************
+ *  ReadBinary()
+ *
+ *  This method is used for reading the binary scene format.
+ *  When bCheckHash is set, the file is only accepted if it
+ *  was built from the text with the passed in hash.
+ ***********************************************************/
+bool SceneFile::ReadBinary(const char* filename, bool bCheckHash, uint32_t sourceHash)
+{
+	std::ifstream file(filename, std::ios::binary);
+	if (!file.is_open())
+	{
+		return(false);
+	}
+
+	file.seekg(0, std::ios::end);
+	const uint64_t fileSize = (uint64_t)file.tellg();
+	file.seekg(0, std::ios::beg);
+
+	BINARY_HEADER header;
+	file.read((char*)&header, sizeof(header));
+	// every tag takes at least its length, so counts that do
+	// not fit in the file are rejected before anything is
+	// allocated for them
+	const uint64_t smallestSize = sizeof(header) +
+		sizeof(uint32_t) * ((uint64_t)header.textureTagCount + header.materialTagCount + header.nodeCount) +
+		sizeof(NODE_RECORD) * (uint64_t)header.nodeCount +
+		sizeof(OBJECT_RECORD) * (uint64_t)header.objectCount;
+	if (!file.good() ||
+		memcmp(header.magic, g_BinaryMagic, sizeof(g_BinaryMagic)) != 0 ||
+		header.version != g_BinaryVersion ||
+		smallestSize > fileSize)
+	{
+		std::cout << "Invalid binary scene:" << filename << std::endl;
+		return(false);
+	}
+
+	if ((bCheckHash == true) && (header.sourceHash != sourceHash))
+	{
+		return(false);
+	}
+
+	if ((ReadTags(file, textureTags, header.textureTagCount) == false) ||
+		(ReadTags(file, materialTags, header.materialTagCount) == false) ||
+		(ReadTags(file, nodeNames, header.nodeCount) == false))
+	{
+		std::cout << "Invalid binary scene:" << filename << std::endl;
+		return(false);
+	}
+
+	// the node and object records are read in a single block each
+	nodes.resize(header.nodeCount);
+	file.read((char*)nodes.data(), sizeof(NODE_RECORD) * header.nodeCount);
+	objects.resize(header.objectCount);
+	file.read((char*)objects.data(), sizeof(OBJECT_RECORD) * header.objectCount);
+	if (!file.good() || (CheckRecords() == false))
+	{
+		std::cout << "Invalid binary scene:" << filename << std::endl;
+		nodes.clear();
+		objects.clear();
+		return(false);
+	}
+
+	std::cout << "Successfully loaded scene:" << filename << ", nodes:" << nodes.size() << ", objects:" << objects.size() << std::endl;
+
+	return(true);
+}
+
+/***********************************************************
+ *  WriteBinary()
+ *
+ *  This method is used for writing the binary scene format.
+ ***********************************************************/
+bool SceneFile::WriteBinary(const char* filename, uint32_t sourceHash) const
+{
+	std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+	if (!file.is_open())
+	{
+		return(false);
+	}
+
+	BINARY_HEADER header;
+	memcpy(header.magic, g_BinaryMagic, sizeof(g_BinaryMagic));
+	header.version = g_BinaryVersion;
+	header.sourceHash = sourceHash;
+	header.textureTagCount = (uint32_t)textureTags.size();
+	header.materialTagCount = (uint32_t)materialTags.size();
+	header.nodeCount = (uint32_t)nodes.size();
+	header.objectCount = (uint32_t)objects.size();
+
+	file.write((const char*)&header, sizeof(header));
+	WriteTags(file, textureTags);
+	WriteTags(file, materialTags);
+	WriteTags(file, nodeNames);
+	file.write((const char*)nodes.data(), sizeof(NODE_RECORD) * nodes.size());
+	file.write((const char*)objects.data(), sizeof(OBJECT_RECORD) * objects.size());
+
+	return(file.good());
+}
+
+/***********************************************************
+ *  FindMeshID()
+ *
+ *  This method is used for getting the mesh ID that is
+ *  associated with the passed in mesh name.
+ ***********************************************************/
+int SceneFile::FindMeshID(const std::string& name)
+{
+	for (int i = 0; i < MESH_COUNT; i++)
+	{
+		if (name.compare(g_MeshNames[i]) == 0)
+		{
+			return(i);
+		}
+	}
+
+	return(-1);
+}
+
+/***********************************************************
+ *  AddTag()
+ *
+ *  This method is used for adding a tag into a tag table,
+ *  tags that are already in the table are reused.
+ ***********************************************************/
+int32_t SceneFile::AddTag(std::vector<std::string>& tags, const std::string& tag)
+{
+	for (size_t i = 0; i < tags.size(); i++)
+	{
+		if (tags[i].compare(tag) == 0)
+		{
+			return((int32_t)i);
+		}
+	}
+
+	tags.push_back(tag);
+	return((int32_t)(tags.size() - 1));
+}
+
+/***********************************************************
+ *  FindNode()
+ *
+ *  This method is used for getting the index of a node by
+ *  its name, only the nodes defined so far are found.
+ ***********************************************************/
+int32_t SceneFile::FindNode(const std::string& name) const
+{
+	for (size_t i = 0; i < nodeNames.size(); i++)
+	{
+		if (nodeNames[i].compare(name) == 0)
+		{
+			return((int32_t)i);
+		}
+	}
+
+	return(-1);
+}
+
+/***********************************************************
+ *  CheckRecords()
+ *
+ *  This method is used for checking the records read from
+ *  the binary file, which the scene manager uses straight
+ *  as indices.  The text parser only creates records that
+ *  pass, the binary file may have been changed since.
+ ***********************************************************/
+bool SceneFile::CheckRecords() const
+{
+	const int32_t nodeCount = (int32_t)nodes.size();
+	const int32_t textureCount = (int32_t)textureTags.size();
+	const int32_t materialCount = (int32_t)materialTags.size();
+
+	// parents come before their children
+	for (int32_t index = 0; index < nodeCount; index++)
+	{
+		const int32_t parentIndex = nodes[index].parentIndex;
+		if ((parentIndex < -1) || (parentIndex >= index))
+		{
+			std::cout << "Scene node record has an invalid parent:" << index << std::endl;
+			return(false);
+		}
+	}
+
+	for (size_t index = 0; index < objects.size(); index++)
+	{
+		const OBJECT_RECORD& record = objects[index];
+		if ((record.meshID < 0) || (record.meshID >= MESH_COUNT) ||
+			(record.parentIndex < -1) || (record.parentIndex >= nodeCount) ||
+			(record.textureIndex < -1) || (record.textureIndex >= textureCount) ||
+			(record.materialIndex < -1) || (record.materialIndex >= materialCount))
+		{
+			std::cout << "Scene object record is out of range:" << index << std::endl;
+			return(false);
+		}
+	}
+
+	return(true);
+}
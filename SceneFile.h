@@ -0,0 +1,137 @@
+///////////////////////////////////////////////////////////////////////////////
+// scenefile.h
+// ============
+// load the scene description from the text (authoring) format or the
+// compact binary (loading) format
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/***********************************************************
+ *  SCENE_MESH
+ *
+ *  The basic shape meshes that a scene object can be
+ *  drawn with.
+ ***********************************************************/
+enum SCENE_MESH
+{
+	MESH_BOX = 0,
+	MESH_PLANE,
+	MESH_CYLINDER,
+	MESH_CONE,
+	MESH_PRISM,
+	MESH_PYRAMID4,
+	MESH_SPHERE,
+	MESH_TAPERED_CYLINDER,
+	MESH_TORUS,
+	MESH_COUNT
+};
+
+/***********************************************************
+ *  OBJECT_FLAGS
+ *
+ *  Flags of a scene object record.
+ ***********************************************************/
+enum OBJECT_FLAGS
+{
+	// the object never moves and can be baked
+	OBJECT_FLAG_STATIC = 0x1,
+	// the object is large and solid, it is drawn into the
+	// occlusion depth buffer to hide what is behind it
+	OBJECT_FLAG_OCCLUDER = 0x2
+};
+
+/***********************************************************
+ *  NODE_FLAGS
+ *
+ *  Flags of a scene node record.
+ ***********************************************************/
+enum NODE_FLAGS
+{
+	// the node never moves, its static objects can be baked
+	NODE_FLAG_STATIC = 0x1
+};
+
+/***********************************************************
+ *  SceneFile
+ *
+ *  This class contains the objects read from a scene
+ *  description file.  Textures and materials are stored as
+ *  indices into tag tables so that the scene manager can
+ *  resolve them once after loading.  Objects, and the
+ *  transform-only nodes that group them, can be placed
+ *  relative to a parent node.
+ ***********************************************************/
+class SceneFile
+{
+public:
+	// one node record - the layout is written as is into
+	// the binary scene file
+	struct NODE_RECORD
+	{
+		// index into nodes of the parent, -1 at the root
+		int32_t parentIndex;
+		// NODE_FLAGS of the node
+		int32_t flags;
+		float scaleXYZ[3];
+		float rotationXYZ[3];
+		float positionXYZ[3];
+	};
+
+	// one object record - the layout is written as is
+	// into the binary scene file
+	struct OBJECT_RECORD
+	{
+		int32_t meshID;
+		// index into nodes of the parent, -1 at the root
+		int32_t parentIndex;
+		// index into textureTags, -1 when drawn with the color
+		int32_t textureIndex;
+		// index into materialTags, -1 when no material is set
+		int32_t materialIndex;
+		// OBJECT_FLAGS of the object
+		int32_t flags;
+		float color[4];
+		float uvScale[2];
+		float scaleXYZ[3];
+		float rotationXYZ[3];
+		float positionXYZ[3];
+	};
+
+	// tags of the textures referenced by the objects
+	std::vector<std::string> textureTags;
+	// tags of the materials referenced by the objects
+	std::vector<std::string> materialTags;
+	// names of the nodes, in the order of the nodes
+	std::vector<std::string> nodeNames;
+	// all the nodes in the scene, parents before children
+	std::vector<NODE_RECORD> nodes;
+	// all the objects in the scene, in drawing order
+	std::vector<OBJECT_RECORD> objects;
+
+	// load the scene, preferring an up to date binary file
+	bool Load(const char* textFilename, const char* binaryFilename);
+
+	// parse the scene from the text format
+	bool ParseText(const char* filename, const std::string& text);
+	// read the scene from the binary format
+	bool ReadBinary(const char* filename, bool bCheckHash, uint32_t sourceHash);
+	// write the scene into the binary format
+	bool WriteBinary(const char* filename, uint32_t sourceHash) const;
+
+	// get the mesh ID for a mesh name, -1 if unknown
+	static int FindMeshID(const std::string& name);
+
+private:
+	// add a tag into a tag table and return its index
+	static int32_t AddTag(std::vector<std::string>& tags, const std::string& tag);
+	// get the index of a named node, -1 if not defined yet
+	int32_t FindNode(const std::string& name) const;
+	// check that every index in the records is in range
+	bool CheckRecords() const;
+};
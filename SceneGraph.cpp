@@ -0,0 +1,182 @@
+///////////////////////////////////////////////////////////////////////////////
+// scenegraph.cpp
+// ============
+// parent and child transforms of the scene nodes, propagated in one pass
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "SceneGraph.h"
+
+#include <algorithm>
+#include <iostream>
+
+/***********************************************************
+ *  SceneGraph()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+SceneGraph::SceneGraph()
+{
+	m_firstDirty = 0;
+	m_bChanged = false;
+}
+
+/***********************************************************
+ *  Build()
+ *
+ *  This method is used for ordering the nodes breadth-first
+ *  from the roots.  Every node starts with the identity
+ *  local matrix and is rebuilt by the next Propagate().
+ ***********************************************************/
+bool SceneGraph::Build(const std::vector<int>& parents)
+{
+	const int nodeCount = (int)parents.size();
+
+	// children of every node in a flat list, the children of
+	// node i are at firstChild[i] .. firstChild[i + 1]
+	std::vector<int> firstChild(nodeCount + 1, 0);
+	for (int node = 0; node < nodeCount; node++)
+	{
+		if (parents[node] >= nodeCount)
+		{
+			std::cout << "Scene node has an invalid parent:" << node << std::endl;
+			return(false);
+		}
+		firstChild[(parents[node] >= 0) ? parents[node] + 1 : 0]++;
+	}
+	const int rootCount = firstChild[0];
+	firstChild[0] = 0;
+	for (int node = 0; node < nodeCount; node++)
+	{
+		firstChild[node + 1] += firstChild[node];
+	}
+	std::vector<int> children(firstChild[nodeCount]);
+	std::vector<int> childFill(firstChild.begin(), firstChild.end() - 1);
+	std::vector<int> roots;
+	roots.reserve(rootCount);
+	for (int node = 0; node < nodeCount; node++)
+	{
+		if (parents[node] >= 0)
+		{
+			children[childFill[parents[node]]++] = node;
+		}
+		else
+		{
+			roots.push_back(node);
+		}
+	}
+
+	// the stored order doubles as the breadth-first queue
+	m_nodes = roots;
+	m_nodes.reserve(nodeCount);
+	for (size_t i = 0; i < m_nodes.size(); i++)
+	{
+		const int node = m_nodes[i];
+		m_nodes.insert(m_nodes.end(), children.begin() + firstChild[node], children.begin() + firstChild[node + 1]);
+	}
+
+	// nodes that are not reached from a root are in a loop
+	if ((int)m_nodes.size() != nodeCount)
+	{
+		std::cout << "Scene node parents form a loop" << std::endl;
+		m_nodes.clear();
+		m_slots.clear();
+		return(false);
+	}
+
+	m_slots.assign(nodeCount, -1);
+	for (int slot = 0; slot < nodeCount; slot++)
+	{
+		m_slots[m_nodes[slot]] = slot;
+	}
+	m_parentSlots.resize(nodeCount);
+	for (int slot = 0; slot < nodeCount; slot++)
+	{
+		const int parent = parents[m_nodes[slot]];
+		m_parentSlots[slot] = (parent >= 0) ? m_slots[parent] : -1;
+	}
+
+	m_localMatrices.assign(nodeCount, glm::mat4(1.0f));
+	m_worldMatrices.assign(nodeCount, glm::mat4(1.0f));
+	m_dirty.assign(nodeCount, 1);
+	m_changed.assign(nodeCount, 0);
+	m_firstDirty = 0;
+	m_bChanged = false;
+
+	return(true);
+}
+
+/***********************************************************
+ *  SetLocalMatrix()
+ *
+ *  This method is used for setting the transform of a node
+ *  relative to its parent.  Its world matrix, and the ones
+ *  of the nodes below it, are rebuilt by Propagate().
+ ***********************************************************/
+void SceneGraph::SetLocalMatrix(int node, const glm::mat4& localMatrix)
+{
+	const int slot = m_slots[node];
+
+	m_localMatrices[slot] = localMatrix;
+	m_dirty[slot] = 1;
+	m_firstDirty = std::min(m_firstDirty, slot);
+}
+
+/***********************************************************
+ *  Propagate()
+ *
+ *  This method is used for rebuilding the world matrices.
+ *  A node is rebuilt when its local matrix was set or when
+ *  its parent was rebuilt, and since the parents come first
+ *  one pass over the slots from the first dirty one reaches
+ *  every node below a change.
+ ***********************************************************/
+int SceneGraph::Propagate()
+{
+	const int slotCount = (int)m_nodes.size();
+	int rebuiltCount = 0;
+
+	// the flags of the last pass are cleared up to where
+	// this pass starts writing them
+	if (m_bChanged == true)
+	{
+		std::fill(m_changed.begin(), m_changed.begin() + std::min(m_firstDirty, slotCount), (uint8_t)0);
+		m_bChanged = false;
+	}
+
+	for (int slot = m_firstDirty; slot < slotCount; slot++)
+	{
+		const int parent = m_parentSlots[slot];
+		const bool bRebuild = (m_dirty[slot] != 0) || ((parent >= 0) && (m_changed[parent] != 0));
+
+		m_changed[slot] = (bRebuild == true) ? 1 : 0;
+		if (bRebuild == false)
+		{
+			continue;
+		}
+
+		m_worldMatrices[slot] = (parent >= 0) ?
+			m_worldMatrices[parent] * m_localMatrices[slot] :
+			m_localMatrices[slot];
+		m_dirty[slot] = 0;
+		rebuiltCount++;
+	}
+
+	m_bChanged = (rebuiltCount > 0);
+	m_firstDirty = slotCount;
+
+	return(rebuiltCount);
+}
+
+/***********************************************************
+ *  GetParent()
+ *
+ *  This method is used for getting the parent of a node as
+ *  it was passed to Build(), -1 for a root node.
+ ***********************************************************/
+int SceneGraph::GetParent(int node) const
+{
+	const int parentSlot = m_parentSlots[m_slots[node]];
+
+	return((parentSlot >= 0) ? m_nodes[parentSlot] : -1);
+}
@@ -0,0 +1,68 @@
+///////////////////////////////////////////////////////////////////////////////
+// scenegraph.h
+// ============
+// parent and child transforms of the scene nodes, propagated in one pass
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <vector>
+
+/***********************************************************
+ *  SceneGraph
+ *
+ *  This class keeps a local matrix per scene node and builds
+ *  the world matrix of every node from the world matrix of
+ *  its parent.  The nodes are stored breadth-first, so every
+ *  parent comes before its children in the arrays and the
+ *  world matrices are rebuilt with one pass from the first
+ *  changed node.  Only the changed nodes and the nodes below
+ *  them are rebuilt.
+ *
+ *  Nodes are identified by the index they were passed to
+ *  Build() with, the stored order is internal.
+ ***********************************************************/
+class SceneGraph
+{
+public:
+	// constructor
+	SceneGraph();
+
+	// build the graph from the parent of every node, -1 for
+	// the nodes at the root - fails when the parents loop
+	bool Build(const std::vector<int>& parents);
+	int GetNodeCount() const { return (int)m_slots.size(); }
+
+	// set the transform of a node relative to its parent
+	void SetLocalMatrix(int node, const glm::mat4& localMatrix);
+	// rebuild the world matrices of the changed nodes and
+	// their children, returns the number rebuilt
+	int Propagate();
+
+	const glm::mat4& GetWorldMatrix(int node) const { return m_worldMatrices[m_slots[node]]; }
+	// set when the last Propagate() rebuilt the world matrix
+	bool IsWorldChanged(int node) const { return m_changed[m_slots[node]] != 0; }
+	// parent of a node as passed to Build()
+	int GetParent(int node) const;
+
+private:
+	// per stored slot, in breadth-first order
+	std::vector<int> m_parentSlots;
+	std::vector<int> m_nodes;
+	std::vector<glm::mat4> m_localMatrices;
+	std::vector<glm::mat4> m_worldMatrices;
+	// local matrix set since the last Propagate()
+	std::vector<uint8_t> m_dirty;
+	// world matrix rebuilt by the last Propagate()
+	std::vector<uint8_t> m_changed;
+	// stored slot of every node
+	std::vector<int> m_slots;
+	// first dirty slot, the pass starts there
+	int m_firstDirty;
+	// set when m_changed holds flags to clear
+	bool m_bChanged;
+};
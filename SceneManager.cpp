@@ -25,14 +25,131 @@
 
 #include <glm/gtx/transform.hpp>
 
+#include <algorithm>
+#include <atomic>
+
 // declare the global variables
 namespace
 {
 	const char* g_ModelName = "model";
 	const char* g_ColorValueName = "objectColor";
 	const char* g_TextureValueName = "objectTexture";
+	const char* g_TextureLayerName = "textureLayer";
 	const char* g_UseTextureName = "bUseTexture";
 	const char* g_UseLightingName = "bUseLighting";
+	const char* g_UseInstancingName = "bUseInstancing";
+	const char* g_UseDrawDataName = "bUseDrawData";
+	const char* g_UVScaleName = "UVscale";
+	const char* g_MaterialIndexName = "materialIndex";
+	const char* g_MaterialBlockName = "MaterialBlock";
+	const char* g_LightBlockName = "LightBlock";
+
+	// uniform buffer binding point of the material block, and
+	// the size of its material array - MAX_MATERIALS in the
+	// fragment shader
+	const GLuint g_MaterialBindingPoint = 0;
+	const int g_MaxMaterials = 256;
+
+	// uniform buffer binding point of the light block, and
+	// the most lights it holds - MAX_LIGHTS in the fragment
+	// shader
+	const GLuint g_LightBindingPoint = 1;
+	const int g_MaxLights = 128;
+
+	// scene description files, the binary file is rebuilt
+	// from the text file whenever the text file changes
+	const char* g_SceneTextFile = "scenes/desk.scene";
+	const char* g_SceneBinaryFile = "scenes/desk.sceneb";
+
+	// cache of the baked static objects, it is read back as
+	// long as the static objects are unchanged
+	const char* g_BakedCacheFile = "scenes/desk.baked";
+	const bool g_UseBakedCache = true;
+
+	// shaders of the depth pre-pass
+	const char* g_DepthVertexShaderFile = "shaders/depthVertexShader.glsl";
+	const char* g_DepthFragmentShaderFile = "shaders/depthFragmentShader.glsl";
+
+	// objects outside the view frustum are not submitted
+	const bool g_UseFrustumCulling = true;
+	// scenes with this many objects are culled by walking the
+	// object hierarchy, smaller ones test every box with SIMD,
+	// which is faster below about this count
+	const int g_HierarchyCullingMinimum = 4096;
+	// objects inside the frustum but behind the occluders
+	// are not submitted
+	const bool g_UseOcclusionCulling = true;
+	// farthest a spatial query looks for an object
+	const float g_MaxQueryDistance = 1000.0f;
+
+	// the round shapes are drawn at a coarser level once their
+	// bounding sphere covers less than this fraction of the
+	// screen height, one entry between every two levels
+	const float g_LodScreenSizes[MeshArena::LOD_COUNT - 1] = { 0.08f, 0.02f };
+	// an object only changes level once its size is this far
+	// past the threshold, so it does not pop back and forth
+	const float g_LodHysteresis = 0.2f;
+
+	// local bounding box of every SCENE_MESH shape, the same
+	// sizes the basic shape meshes are built with
+	const glm::vec3 g_MeshBoundsMin[MESH_COUNT] =
+	{
+		glm::vec3(-0.5f, -0.5f, -0.5f),	// box
+		glm::vec3(-1.0f,  0.0f, -1.0f),	// plane
+		glm::vec3(-1.0f,  0.0f, -1.0f),	// cylinder
+		glm::vec3(-1.0f,  0.0f, -1.0f),	// cone
+		glm::vec3(-0.5f, -0.5f, -0.5f),	// prism
+		glm::vec3(-0.5f, -0.5f, -0.5f),	// pyramid4
+		glm::vec3(-1.0f, -1.0f, -1.0f),	// sphere
+		glm::vec3(-1.0f,  0.0f, -1.0f),	// tapered cylinder
+		glm::vec3(-1.1f, -1.1f, -0.1f)	// torus
+	};
+	const glm::vec3 g_MeshBoundsMax[MESH_COUNT] =
+	{
+		glm::vec3( 0.5f,  0.5f,  0.5f),	// box
+		glm::vec3( 1.0f,  0.0f,  1.0f),	// plane
+		glm::vec3( 1.0f,  1.0f,  1.0f),	// cylinder
+		glm::vec3( 1.0f,  1.0f,  1.0f),	// cone
+		glm::vec3( 0.5f,  0.5f,  0.5f),	// prism
+		glm::vec3( 0.5f,  0.5f,  0.5f),	// pyramid4
+		glm::vec3( 1.0f,  1.0f,  1.0f),	// sphere
+		glm::vec3( 1.0f,  1.0f,  1.0f),	// tapered cylinder
+		glm::vec3( 1.1f,  1.1f,  0.1f)	// torus
+	};
+
+	// smallest number of matching objects that are drawn
+	// as one instanced draw call
+	const int g_MinInstanceCount = 4;
+
+	// render queue payloads with one of these bits set are
+	// instance batches or baked meshes, the others are scene
+	// objects
+	const uint32_t g_BatchPayloadFlag = 0x80000000u;
+	const uint32_t g_BakedPayloadFlag = 0x40000000u;
+	const uint32_t g_PayloadIndexMask = ~(g_BatchPayloadFlag | g_BakedPayloadFlag);
+
+	// render queue passes, the opaque objects are drawn first
+	// and then the blended ones over them
+	const int g_OpaquePass = 0;
+	const int g_TransparentPass = 1;
+	// largest depth in a sort key
+	const uint32_t g_MaxSortDepth = 0xFFFF;
+
+	// scene objects, culling boxes and packets every job of
+	// the per-frame stages takes care of
+	const int g_TransformGrain = 1024;
+	const int g_OcclusionGrain = 512;
+	const int g_RecordGrain = 1024;
+	// local matrices are built in blocks of this many nodes,
+	// a whole block when any of its nodes changed
+	const int g_TransformBlock = 8;
+
+	// names of the per-frame stages, for the statistics
+	const char* g_StageNames[] = { "transforms", "occlusion", "queue", "commands" };
+
+	// bytes every worker starts its frame sub-arena with, it
+	// grows when a frame needs more
+	const size_t g_FrameArenaBlockSize = 64 * 1024;
 }
 
 /***********************************************************
@@ -40,18 +157,30 @@ namespace
  *
  *  The constructor for the class
  ***********************************************************/
-SceneManager::SceneManager(ShaderManager* pShaderManager)
+SceneManager::SceneManager(ShaderManager* pShaderManager, ShaderUniforms* pShaderUniforms, RenderState* pRenderState)
 {
 	m_pShaderManager = pShaderManager;
+	m_pShaderUniforms = pShaderUniforms;
+	m_pRenderState = pRenderState;
+	m_shaderHandles = SHADER_HANDLES();
 	m_basicMeshes = new ShapeMeshes();
-
-	// initialize the texture collection
-	for (int i = 0; i < 16; i++)
-	{
-		m_textureIDs[i].tag = "/0";
-		m_textureIDs[i].ID = -1;
-	}
-	m_loadedTextures = 0;
+	m_instancedMeshes = new InstancedMeshes();
+	m_meshArena = new MeshArena();
+	m_view = glm::mat4(1.0f);
+	m_projection = glm::mat4(1.0f);
+	m_viewProjection = glm::mat4(1.0f);
+	m_projectionScale = 1.0f;
+	m_bDepthPrepass = false;
+	m_shadingQuery = 0;
+	m_bUseMultiDraw = false;
+	m_bObjectsChanged = false;
+	m_frameStats = FRAME_STATS();
+
+	// the per-frame stages run as jobs on every hardware thread,
+	// and every worker allocates from a sub-arena of its own
+	m_jobSystem.Start();
+	m_frameArena.Initialize(m_jobSystem.GetWorkerCount(), g_FrameArenaBlockSize);
+	m_jobSystem.SetFrameArena(&m_frameArena);
 }
 
 /***********************************************************
@@ -63,8 +192,14 @@ SceneManager::~SceneManager()
 {
 	// clear the allocated memory
 	m_pShaderManager = NULL;
+	m_pShaderUniforms = NULL;
 	delete m_basicMeshes;
 	m_basicMeshes = NULL;
+	delete m_instancedMeshes;
+	m_instancedMeshes = NULL;
+	delete m_meshArena;
+	m_meshArena = NULL;
+	m_jobSystem.Stop();
 	// destroy the created OpenGL textures
 	DestroyGLTextures();
 }
@@ -72,229 +207,273 @@ SceneManager::~SceneManager()
 /***********************************************************
  *  CreateGLTexture()
  *
- *  This method is used for loading textures from image files,
- *  configuring the texture mapping parameters in OpenGL,
- *  generating the mipmaps, and loading the read texture into
- *  the next available texture slot in memory.
+ *  This method is used for loading textures from image files
+ *  and associating them with a tag.  The images are stored
+ *  in the texture arrays when the textures are bound.
  ***********************************************************/
-bool SceneManager::CreateGLTexture(const char* filename, std::string tag)
+bool SceneManager::CreateGLTexture(const char* filename, const std::string& tag)
 {
-	int width = 0;
-	int height = 0;
-	int colorChannels = 0;
-	GLuint textureID = 0;
-
-	// indicate to always flip images vertically when loaded
-	stbi_set_flip_vertically_on_load(true);
-
-	// try to parse the image data from the specified image file
-	unsigned char* image = stbi_load(
-		filename,
-		&width,
-		&height,
-		&colorChannels,
-		0);
-
-	// if the image was successfully read from the image file
-	if (image)
-	{
-		std::cout << "Successfully loaded image:" << filename << ", width:" << width << ", height:" << height << ", channels:" << colorChannels << std::endl;
-
-		glGenTextures(1, &textureID);
-		glBindTexture(GL_TEXTURE_2D, textureID);
-
-		// set the texture wrapping parameters
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-		// set texture filtering parameters
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-		// if the loaded image is in RGB format
-		if (colorChannels == 3)
-			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB8, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, image);
-		// if the loaded image is in RGBA format - it supports transparency
-		else if (colorChannels == 4)
-			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, image);
-		else
-		{
-			std::cout << "Not implemented to handle image with " << colorChannels << " channels" << std::endl;
-			return false;
-		}
+	return(m_textureArrays.LoadImage(filename, tag));
+}
 
-		// generate the texture mipmaps for mapping textures to lower resolutions
-		glGenerateMipmap(GL_TEXTURE_2D);
+/***********************************************************
+ *  BindGLTextures()
+ *
+ *  This method is used for storing the loaded textures in
+ *  texture arrays, one for each image size, and binding
+ *  every array to its own texture unit.
+ ***********************************************************/
+void SceneManager::BindGLTextures()
+{
+	m_textureArrays.Build();
+	m_textureArrays.Bind();
+}
 
-		// free the image data from local memory
-		stbi_image_free(image);
-		glBindTexture(GL_TEXTURE_2D, 0); // Unbind the texture
+/***********************************************************
+ *  DestroyGLTextures()
+ *
+ *  This method is used for freeing the memory of all the
+ *  texture arrays.
+ ***********************************************************/
+void SceneManager::DestroyGLTextures()
+{
+	m_textureArrays.Destroy();
+}
 
-		// register the loaded texture and associate it with the special tag string
-		m_textureIDs[m_loadedTextures].ID = textureID;
-		m_textureIDs[m_loadedTextures].tag = tag;
-		m_loadedTextures++;
+/***********************************************************
+ *  FindTextureSlot()
+ *
+ *  This method is used for getting the index of the previously
+ *  loaded texture bitmap associated with the passed in tag.
+ ***********************************************************/
+int SceneManager::FindTextureSlot(const std::string& tag) const
+{
+	return(m_textureArrays.FindTexture(tag));
+}
 
-		return true;
+/***********************************************************
+ *  GetTextureKey()
+ *
+ *  This method is used for getting the render queue key of
+ *  a loaded texture.  Textures in the same array are drawn
+ *  without any state change, so the key is the array.
+ ***********************************************************/
+int SceneManager::GetTextureKey(int textureSlot) const
+{
+	if (textureSlot < 0)
+	{
+		return(-1);
 	}
 
-	std::cout << "Could not load image:" << filename << std::endl;
-
-	// Error loading the image
-	return false;
+	return(m_textureArrays.GetLayer(textureSlot).arrayIndex);
 }
 
 /***********************************************************
- *  BindGLTextures()
+ *  FindMaterialID()
  *
- *  This method is used for binding the loaded textures to
- *  OpenGL texture memory slots.  There are up to 16 slots.
+ *  This method is used for getting the index of the previously
+ *  defined material that is associated with the passed in tag.
+ *  The tags are indexed when the materials are uploaded.
  ***********************************************************/
-void SceneManager::BindGLTextures()
+int SceneManager::FindMaterialID(const std::string& tag) const
 {
-	for (int i = 0; i < m_loadedTextures; i++)
-	{
-		// bind textures on corresponding texture units
-		glActiveTexture(GL_TEXTURE0 + i);
-		glBindTexture(GL_TEXTURE_2D, m_textureIDs[i].ID);
-	}
+	std::unordered_map<std::string, int>::const_iterator found = m_materialIDs.find(tag);
+
+	return((found != m_materialIDs.end()) ? found->second : -1);
 }
 
 /***********************************************************
- *  DestroyGLTextures()
+ *  SetModelMatrix()
  *
- *  This method is used for freeing the memory in all the
- *  used texture memory slots.
+ *  This method is used for setting an already built model
+ *  matrix into the transform buffer.
  ***********************************************************/
-void SceneManager::DestroyGLTextures()
+void SceneManager::SetModelMatrix(const glm::mat4& modelView)
 {
-	for (int i = 0; i < m_loadedTextures; i++)
+	if (NULL != m_pShaderManager)
 	{
-		glGenTextures(1, &m_textureIDs[i].ID);
+		m_pShaderUniforms->setMat4Value(m_shaderHandles.model, modelView);
 	}
 }
 
 /***********************************************************
- *  FindTextureID()
+ *  SetObjectTransformations()
  *
- *  This method is used for getting an ID for the previously
- *  loaded texture bitmap associated with the passed in tag.
+ *  This method is used for changing the transformation
+ *  values of a scene object.  Its model matrix is rebuilt
+ *  before the next frame is rendered.
  ***********************************************************/
-int SceneManager::FindTextureID(std::string tag)
+void SceneManager::SetObjectTransformations(
+	OBJECT_HANDLE objectHandle,
+	glm::vec3 scaleXYZ,
+	glm::vec3 rotationXYZ,
+	glm::vec3 positionXYZ)
 {
-	int textureID = -1;
-	int index = 0;
-	bool bFound = false;
+	const int objectIndex = m_objectHandles.GetIndex(objectHandle);
+	if (objectIndex < 0)
+	{
+		std::cout << "Scene object handle is stale:" << objectHandle.slot << std::endl;
+		return;
+	}
 
-	while ((index < m_loadedTextures) && (bFound == false))
+	SCENE_OBJECT& object = m_sceneObjects[objectIndex];
+
+	if (object.bBaked == true)
 	{
-		if (m_textureIDs[index].tag.compare(tag) == 0)
-		{
-			textureID = m_textureIDs[index].ID;
-			bFound = true;
-		}
-		else
-			index++;
+		std::cout << "Baked static object cannot be moved:" << objectIndex << std::endl;
+		return;
 	}
 
-	return(textureID);
+	m_localTransforms.Set((int)m_sceneNodes.size() + objectIndex, scaleXYZ, rotationXYZ, positionXYZ);
+	object.bTransformDirty = true;
 }
 
 /***********************************************************
- *  FindTextureSlot()
+ *  FindSceneNode()
  *
- *  This method is used for getting a slot index for the previously
- *  loaded texture bitmap associated with the passed in tag.
+ *  This method is used for getting the index of a scene
+ *  node by the name it has in the scene description.
  ***********************************************************/
-int SceneManager::FindTextureSlot(std::string tag)
+int SceneManager::FindSceneNode(const std::string& name) const
 {
-	int textureSlot = -1;
-	int index = 0;
-	bool bFound = false;
-
-	while ((index < m_loadedTextures) && (bFound == false))
+	for (int index = 0; index < (int)m_sceneNodes.size(); index++)
 	{
-		if (m_textureIDs[index].tag.compare(tag) == 0)
+		if (m_sceneNodes[index].name.compare(name) == 0)
 		{
-			textureSlot = index;
-			bFound = true;
+			return(index);
 		}
-		else
-			index++;
 	}
 
-	return(textureSlot);
+	return(-1);
 }
 
 /***********************************************************
- *  FindMaterial()
+ *  SetNodeTransformations()
  *
- *  This method is used for getting a material from the previously
- *  defined materials list that is associated with the passed in tag.
+ *  This method is used for changing the transformation
+ *  values of a scene node.  The world matrices of the node
+ *  and everything below it are rebuilt before the next
+ *  frame is rendered.
  ***********************************************************/
-bool SceneManager::FindMaterial(std::string tag, OBJECT_MATERIAL& material)
+void SceneManager::SetNodeTransformations(
+	int nodeIndex,
+	glm::vec3 scaleXYZ,
+	glm::vec3 rotationXYZ,
+	glm::vec3 positionXYZ)
 {
-	if (m_objectMaterials.size() == 0)
+	if ((nodeIndex < 0) || (nodeIndex >= (int)m_sceneNodes.size()))
 	{
-		return(false);
+		std::cout << "Scene node is not defined:" << nodeIndex << std::endl;
+		return;
 	}
 
-	int index = 0;
-	bool bFound = false;
-	while ((index < m_objectMaterials.size()) && (bFound == false))
+	SCENE_NODE& node = m_sceneNodes[nodeIndex];
+
+	if (node.bBaked == true)
 	{
-		if (m_objectMaterials[index].tag.compare(tag) == 0)
-		{
-			bFound = true;
-			material.ambientColor = m_objectMaterials[index].ambientColor;
-			material.ambientStrength = m_objectMaterials[index].ambientStrength;
-			material.diffuseColor = m_objectMaterials[index].diffuseColor;
-			material.specularColor = m_objectMaterials[index].specularColor;
-			material.shininess = m_objectMaterials[index].shininess;
-		}
-		else
-		{
-			index++;
-		}
+		std::cout << "Baked static node cannot be moved:" << node.name << std::endl;
+		return;
 	}
 
-	return(true);
+	m_localTransforms.Set(nodeIndex, scaleXYZ, rotationXYZ, positionXYZ);
+	node.bTransformDirty = true;
 }
 
 /***********************************************************
- *  SetTransformation()
+ *  UpdateTransformations()
  *
- *  This method is used for setting the transform buffer
- *  using the passed in transformation values.
+ *  This method is used for rebuilding the local matrices of
+ *  the scene nodes and objects whose transformation values
+ *  changed, and then the world matrices below them.  The
+ *  local matrices are built by the SIMD kernel of the
+ *  transform arrays a block at a time, and only the changed
+ *  ones of a block are passed to the scene graph.  The
+ *  objects whose world matrix changed get new culling boxes,
+ *  built as jobs of a range of objects each.
  ***********************************************************/
-void SceneManager::SetTransformations(
-	glm::vec3 scaleXYZ,
-	float XrotationDegrees,
-	float YrotationDegrees,
-	float ZrotationDegrees,
-	glm::vec3 positionXYZ)
+void SceneManager::UpdateTransformations()
 {
-	// variables for this method
-	glm::mat4 modelView;
-	glm::mat4 scale;
-	glm::mat4 rotationX;
-	glm::mat4 rotationY;
-	glm::mat4 rotationZ;
-	glm::mat4 translation;
-
-	// set the scale value in the transform buffer
-	scale = glm::scale(scaleXYZ);
-	// set the rotation values in the transform buffer
-	rotationX = glm::rotate(glm::radians(XrotationDegrees), glm::vec3(1.0f, 0.0f, 0.0f));
-	rotationY = glm::rotate(glm::radians(YrotationDegrees), glm::vec3(0.0f, 1.0f, 0.0f));
-	rotationZ = glm::rotate(glm::radians(ZrotationDegrees), glm::vec3(0.0f, 0.0f, 1.0f));
-	// set the translation value in the transform buffer
-	translation = glm::translate(positionXYZ);
-
-	modelView = translation * rotationX * rotationY * rotationZ * scale;
+	// the scene objects follow the scene nodes in the graph
+	const int nodeCount = (int)m_sceneNodes.size();
+	const int transformCount = m_localTransforms.GetCount();
 
-	if (NULL != m_pShaderManager)
+	glm::mat4 localMatrices[g_TransformBlock];
+	for (int first = 0; first < transformCount; first += g_TransformBlock)
+	{
+		const int count = std::min(g_TransformBlock, transformCount - first);
+
+		bool dirty[g_TransformBlock];
+		bool bAnyDirty = false;
+		for (int offset = 0; offset < count; offset++)
+		{
+			const int index = first + offset;
+			bool& bTransformDirty = (index < nodeCount) ?
+				m_sceneNodes[index].bTransformDirty :
+				m_sceneObjects[index - nodeCount].bTransformDirty;
+			dirty[offset] = bTransformDirty;
+			bAnyDirty = bAnyDirty || bTransformDirty;
+			bTransformDirty = false;
+		}
+		if (bAnyDirty == false)
+		{
+			continue;
+		}
+
+		m_localTransforms.ComposeMatrices(first, count, localMatrices);
+		for (int offset = 0; offset < count; offset++)
+		{
+			if (dirty[offset] == true)
+			{
+				m_sceneGraph.SetLocalMatrix(first + offset, localMatrices[offset]);
+			}
+		}
+	}
+
+	const int rebuiltCount = m_sceneGraph.Propagate();
+	m_frameStats.matricesRecomputed += rebuiltCount;
+	if (rebuiltCount == 0)
+	{
+		return;
+	}
+
+	// every job only writes the objects and boxes of its range
+	m_jobSystem.ParallelFor((int)m_sceneObjects.size(), g_TransformGrain, [this, nodeCount](int firstObject, int lastObject)
+	{
+		for (int index = firstObject; index < lastObject; index++)
+		{
+			SCENE_OBJECT& object = m_sceneObjects[index];
+			if (m_sceneGraph.IsWorldChanged(nodeCount + index) == false)
+			{
+				continue;
+			}
+
+			object.modelMatrix = m_sceneGraph.GetWorldMatrix(nodeCount + index);
+
+			glm::vec3 center;
+			glm::vec3 extents;
+			FrustumCuller::TransformBounds(
+				object.modelMatrix,
+				g_MeshBoundsMin[object.meshID],
+				g_MeshBoundsMax[object.meshID],
+				center,
+				extents);
+			SetCullingBounds(index, center, extents);
+			object.boundingSphere = glm::vec4(center, glm::length(extents));
+		}
+	});
+
+	// the instance data of the moved objects must be uploaded
+	// again, batches are shared between the ranges
+	for (INSTANCE_BATCH& batch : m_instanceBatches)
 	{
-		m_pShaderManager->setMat4Value(g_ModelName, modelView);
+		for (int index : batch.objectIndices)
+		{
+			if (m_sceneGraph.IsWorldChanged(nodeCount + index) == true)
+			{
+				batch.bDirty = true;
+				break;
+			}
+		}
 	}
 }
 
@@ -320,27 +499,28 @@ void SceneManager::SetShaderColor(
 
 	if (NULL != m_pShaderManager)
 	{
-		m_pShaderManager->setIntValue(g_UseTextureName, false);
-		m_pShaderManager->setVec4Value(g_ColorValueName, currentColor);
+		m_pShaderUniforms->setIntValue(m_shaderHandles.useTexture, false);
+		m_pShaderUniforms->setVec4Value(m_shaderHandles.objectColor, currentColor);
 	}
 }
 
 /***********************************************************
- *  SetShaderTexture()
+ *  SetShaderTextureSlot()
  *
- *  This method is used for setting the texture data
- *  associated with the passed in ID into the shader.
+ *  This method is used for setting the texture data of the
+ *  passed in loaded texture into the shader, as the texture
+ *  unit of its array and its layer in the array.
  ***********************************************************/
-void SceneManager::SetShaderTexture(
-	std::string textureTag)
+void SceneManager::SetShaderTextureSlot(
+	int textureSlot)
 {
-	if (NULL != m_pShaderManager)
+	if ((NULL != m_pShaderManager) && (textureSlot >= 0))
 	{
-		m_pShaderManager->setIntValue(g_UseTextureName, true);
+		const TextureArrays::TEXTURE_LAYER& location = m_textureArrays.GetLayer(textureSlot);
 
-		int textureID = -1;
-		textureID = FindTextureSlot(textureTag);
-		m_pShaderManager->setSampler2DValue(g_TextureValueName, textureID);
+		m_pShaderUniforms->setIntValue(m_shaderHandles.useTexture, true);
+		m_pShaderUniforms->setSampler2DArrayValue(m_shaderHandles.objectTexture, location.arrayIndex);
+		m_pShaderUniforms->setIntValue(m_shaderHandles.textureLayer, location.layer);
 	}
 }
 
@@ -354,7 +534,7 @@ void SceneManager::SetTextureUVScale(float u, float v)
 {
 	if (NULL != m_pShaderManager)
 	{
-		m_pShaderManager->setVec2Value("UVscale", glm::vec2(u, v));
+		m_pShaderUniforms->setVec2Value(m_shaderHandles.uvScale, glm::vec2(u, v));
 	}
 }
 
@@ -366,30 +546,18 @@ void SceneManager::SetTextureUVScale(float u, float v)
 /**************************************************************/
 
 /***********************************************************
- *  SetShaderMaterial()
+ *  SetShaderMaterialID()
  *
- *  This method is used for passing the material values
- *  into the shader.
+ *  This method is used for selecting the material at the
+ *  passed in index in the material buffer for the next
+ *  draw command.
  ***********************************************************/
-void SceneManager::SetShaderMaterial(
-	std::string materialTag)
+void SceneManager::SetShaderMaterialID(
+	int materialID)
 {
-	if (m_objectMaterials.size() > 0)
+	if (NULL != m_pShaderManager)
 	{
-		OBJECT_MATERIAL material;
-		bool bReturn = false;
-
-		// find the defined material that matches the tag
-		bReturn = FindMaterial(materialTag, material);
-		if (bReturn == true)
-		{
-			// pass the material properties into the shader
-			m_pShaderManager->setVec3Value("material.ambientColor", material.ambientColor);
-			m_pShaderManager->setFloatValue("material.ambientStrength", material.ambientStrength);
-			m_pShaderManager->setVec3Value("material.diffuseColor", material.diffuseColor);
-			m_pShaderManager->setVec3Value("material.specularColor", material.specularColor);
-			m_pShaderManager->setFloatValue("material.shininess", material.shininess);
-		}
+		m_pShaderUniforms->setIntValue(m_shaderHandles.materialIndex, materialID);
 	}
 }
 
@@ -403,9 +571,9 @@ void SceneManager::SetShaderMaterial(
 void SceneManager::LoadSceneTextures()
 {
 	/*** STUDENTS - add the code BELOW for loading the textures that ***/
-	/*** will be used for mapping to objects in the 3D scene. Up to  ***/
-	/*** 16 textures can be loaded per scene. Refer to the code in   ***/
-	/*** the OpenGL Sample for help.                                 ***/
+	/*** will be used for mapping to objects in the 3D scene. Images ***/
+	/*** of the same size share a texture array. Refer to the code   ***/
+	/*** in the OpenGL Sample for help.                              ***/
 
 	bool bReturn = false;
 
@@ -428,8 +596,8 @@ void SceneManager::LoadSceneTextures()
 	bReturn = CreateGLTexture("../../Utilities/textures/abstract.jpg", "cone");
 
 	// after the texture image data is loaded into memory, the
-	// loaded textures need to be bound to texture slots - there
-	// are a total of 16 available slots for scene textures
+	// loaded textures are stored in texture arrays by image size
+	// and every array is bound to its own texture unit
 	BindGLTextures();
 }
 
@@ -515,44 +683,141 @@ void SceneManager::DefineObjectMaterials()
  *  SetupSceneLights()
  *
  *  This method is called to add and configure the light
- *  sources for the 3D scene.  There are up to 4 light sources.
+ *  sources for the 3D scene.  The light buffer holds up to
+ *  g_MaxLights light sources.
  ***********************************************************/
 void SceneManager::SetupSceneLights()
 {
+	LightBuffer::LIGHT_SOURCE light;
+
 	// Enable custom lighting
 	m_pShaderManager->setBoolValue("bUseLighting", true);
 
+	m_lightBuffer.Create(g_LightBindingPoint, g_MaxLights);
+	m_pShaderUniforms->BindUniformBlock(g_LightBlockName, g_LightBindingPoint);
+
 	// Key Light (Weaker sunlight simulation)
-	m_pShaderManager->setVec3Value("lightSources[0].position", 0.1f, 0.1f, 0.1f);
-	m_pShaderManager->setVec3Value("lightSources[0].ambientColor", 0.1f, 0.1f, 0.1f);
-	m_pShaderManager->setVec3Value("lightSources[0].diffuseColor", 0.1f, 0.1f, 0.1f);
-	m_pShaderManager->setVec3Value("lightSources[0].specularColor", 0.1f, 0.1f, 0.1f);
-	m_pShaderManager->setFloatValue("lightSources[0].focalStrength", 0.1f);
-	m_pShaderManager->setFloatValue("lightSources[0].specularIntensity", 0.1f);
+	light.position = glm::vec3(0.1f, 0.1f, 0.1f);
+	light.ambientColor = glm::vec3(0.1f, 0.1f, 0.1f);
+	light.diffuseColor = glm::vec3(0.1f, 0.1f, 0.1f);
+	light.specularColor = glm::vec3(0.1f, 0.1f, 0.1f);
+	light.focalStrength = 0.1f;
+	light.specularIntensity = 0.1f;
+	m_lightBuffer.SetLight(0, light);
 
 	// Fill Light (Darker shadow softener)
-	m_pShaderManager->setVec3Value("lightSources[1].position", 0.1f, 0.1f, 0.1f);
-	m_pShaderManager->setVec3Value("lightSources[1].ambientColor", 0.1f, 0.1f, 0.1f);
-	m_pShaderManager->setVec3Value("lightSources[1].diffuseColor", 0.1f, 0.1f, 0.1f);
-	m_pShaderManager->setVec3Value("lightSources[1].specularColor", 0.1f, 0.1f, 0.1f);
-	m_pShaderManager->setFloatValue("lightSources[1].focalStrength", 0.1f);
-	m_pShaderManager->setFloatValue("lightSources[1].specularIntensity", 0.1f);
+	light.position = glm::vec3(0.1f, 0.1f, 0.1f);
+	light.ambientColor = glm::vec3(0.1f, 0.1f, 0.1f);
+	light.diffuseColor = glm::vec3(0.1f, 0.1f, 0.1f);
+	light.specularColor = glm::vec3(0.1f, 0.1f, 0.1f);
+	light.focalStrength = 0.1f;
+	light.specularIntensity = 0.1f;
+	m_lightBuffer.SetLight(1, light);
 
 	// Rim Light (Minimal edge highlights)
-	m_pShaderManager->setVec3Value("lightSources[2].position", 0.1f, 0.1f, 0.1f);
-	m_pShaderManager->setVec3Value("lightSources[2].ambientColor", 0.1f, 0.1f, 0.1f);
-	m_pShaderManager->setVec3Value("lightSources[2].diffuseColor", 0.1f, 0.1f, 0.1f);
-	m_pShaderManager->setVec3Value("lightSources[2].specularColor", 0.1f, 0.1f, 0.1f);
-	m_pShaderManager->setFloatValue("lightSources[2].focalStrength", 0.1f);
-	m_pShaderManager->setFloatValue("lightSources[2].specularIntensity", 0.1f);
+	light.position = glm::vec3(0.1f, 0.1f, 0.1f);
+	light.ambientColor = glm::vec3(0.1f, 0.1f, 0.1f);
+	light.diffuseColor = glm::vec3(0.1f, 0.1f, 0.1f);
+	light.specularColor = glm::vec3(0.1f, 0.1f, 0.1f);
+	light.focalStrength = 0.1f;
+	light.specularIntensity = 0.1f;
+	m_lightBuffer.SetLight(2, light);
 
 	// Background Light (Subtle ambiance)
-	m_pShaderManager->setVec3Value("lightSources[3].position", 0.1f, 0.1f, 0.1f);
-	m_pShaderManager->setVec3Value("lightSources[3].ambientColor", 0.1f, 0.1f, 0.1f);
-	m_pShaderManager->setVec3Value("lightSources[3].diffuseColor", 0.1f, 0.1f, 0.1f);
-	m_pShaderManager->setVec3Value("lightSources[3].specularColor", 0.1f, 0.1f, 0.1f);
-	m_pShaderManager->setFloatValue("lightSources[3].focalStrength", 0.1f);
-	m_pShaderManager->setFloatValue("lightSources[3].specularIntensity", 0.1f);
+	light.position = glm::vec3(0.1f, 0.1f, 0.1f);
+	light.ambientColor = glm::vec3(0.1f, 0.1f, 0.1f);
+	light.diffuseColor = glm::vec3(0.1f, 0.1f, 0.1f);
+	light.specularColor = glm::vec3(0.1f, 0.1f, 0.1f);
+	light.focalStrength = 0.1f;
+	light.specularIntensity = 0.1f;
+	m_lightBuffer.SetLight(3, light);
+
+	m_lightBuffer.SetLightCount(4);
+	m_lightBuffer.Upload();
+}
+
+/***********************************************************
+ *  SetViewProjection()
+ *
+ *  This method is used for setting the view and projection
+ *  matrices of the camera, the scene objects outside of its
+ *  frustum are not drawn in the next frame.
+ ***********************************************************/
+void SceneManager::SetViewProjection(const glm::mat4& view, const glm::mat4& projection)
+{
+	const glm::mat4 viewProjection = projection * view;
+
+	m_view = view;
+	m_projection = projection;
+	m_viewProjection = viewProjection;
+
+	// the second row of the matrix is the view space up axis
+	// scaled by the projection, for both projection modes
+	m_projectionScale = glm::length(glm::vec3(viewProjection[0][1], viewProjection[1][1], viewProjection[2][1]));
+}
+
+/***********************************************************
+ *  RaycastObjects()
+ *
+ *  This method is used for finding the scene object whose
+ *  box is hit first by a ray, for example to pick the
+ *  object under the mouse.
+ ***********************************************************/
+SceneManager::OBJECT_HANDLE SceneManager::RaycastObjects(
+	const glm::vec3& origin,
+	const glm::vec3& direction,
+	float& hitDistance) const
+{
+	// the hierarchy still holds the objects of the last frame
+	if (m_bObjectsChanged == true)
+	{
+		return(OBJECT_HANDLE());
+	}
+
+	return(m_objectHandles.GetHandle(m_sceneHierarchy.Raycast(origin, direction, g_MaxQueryDistance, hitDistance)));
+}
+
+/***********************************************************
+ *  FindNearestObject()
+ *
+ *  This method is used for finding the scene object whose
+ *  box is closest to a point.
+ ***********************************************************/
+SceneManager::OBJECT_HANDLE SceneManager::FindNearestObject(
+	const glm::vec3& point,
+	float& distance) const
+{
+	if (m_bObjectsChanged == true)
+	{
+		return(OBJECT_HANDLE());
+	}
+
+	return(m_objectHandles.GetHandle(m_sceneHierarchy.FindNearest(point, g_MaxQueryDistance, distance)));
+}
+
+/***********************************************************
+ *  SetLightSource()
+ *
+ *  This method is used for changing a scene light source,
+ *  growing the light count when the light is past the last
+ *  one in use.  The light is uploaded before the next frame
+ *  is rendered.
+ ***********************************************************/
+void SceneManager::SetLightSource(
+	int lightIndex,
+	const LightBuffer::LIGHT_SOURCE& light)
+{
+	if ((lightIndex < 0) || (lightIndex >= m_lightBuffer.GetCapacity()))
+	{
+		std::cout << "Light index is out of range:" << lightIndex << std::endl;
+		return;
+	}
+
+	m_lightBuffer.SetLight(lightIndex, light);
+	if (lightIndex >= m_lightBuffer.GetLightCount())
+	{
+		m_lightBuffer.SetLightCount(lightIndex + 1);
+	}
 }
 
 /***********************************************************
@@ -564,2752 +829,1528 @@ void SceneManager::SetupSceneLights()
  ***********************************************************/
 void SceneManager::PrepareScene()
 {
+	// look up the uniforms that are set for every draw
+	GetShaderHandles();
+
 	// load the textures for the 3D scene
 	LoadSceneTextures();
 	DefineObjectMaterials();
+	UploadObjectMaterials();
 	SetupSceneLights();
 
 	// only one instance of a particular mesh needs to be
 	// loaded in memory no matter how many times it is drawn
 	// in the rendered 3D scene
+	m_bUseMultiDraw = MeshArena::IsSupported();
+	if (m_bUseMultiDraw == true)
+	{
+		// all the meshes share one set of buffers
+		m_meshArena->LoadMeshes();
+	}
+	else
+	{
+		m_basicMeshes->LoadBoxMesh();
+		m_basicMeshes->LoadPlaneMesh();
+		m_basicMeshes->LoadCylinderMesh();
+		m_basicMeshes->LoadConeMesh();
+		m_basicMeshes->LoadPrismMesh();
+		m_basicMeshes->LoadPyramid4Mesh();
+		m_basicMeshes->LoadSphereMesh();
+		m_basicMeshes->LoadTaperedCylinderMesh();
+		m_basicMeshes->LoadTorusMesh();
+
+		// the meshes that repeated objects are drawn instanced with
+		m_instancedMeshes->LoadBoxMesh();
+		m_instancedMeshes->LoadPlaneMesh();
+	}
+
+	// load the objects that make up the 3D scene
+	LoadSceneObjects();
+
+	// the baked meshes are part of the arena, so it is only
+	// uploaded once the scene is loaded
+	if (m_bUseMultiDraw == true)
+	{
+		m_meshArena->Upload();
 
-	m_basicMeshes->LoadBoxMesh();
-	m_basicMeshes->LoadPlaneMesh();
-	m_basicMeshes->LoadCylinderMesh();
-	m_basicMeshes->LoadConeMesh();
-	m_basicMeshes->LoadPrismMesh();
-	m_basicMeshes->LoadPyramid4Mesh();
-	m_basicMeshes->LoadSphereMesh();
-	m_basicMeshes->LoadTaperedCylinderMesh();
-	m_basicMeshes->LoadTorusMesh();
+		// the depth pre-pass draws the arena positions
+		if (m_depthPrepass.Load(g_DepthVertexShaderFile, g_DepthFragmentShaderFile) == false)
+		{
+			std::cout << "Depth pre-pass is not available" << std::endl;
+		}
+	}
 }
 
 /***********************************************************
- *  RenderScene()
+ *  IsDepthPrepassActive()
  *
- *  This method is used for rendering the 3D scene by
- *  transforming and drawing the basic 3D shapes
+ *  This method is used for checking if the next frame is
+ *  drawn with a depth pre-pass.  It needs the mesh arena
+ *  and the depth program.
  ***********************************************************/
-void SceneManager::RenderScene()
+bool SceneManager::IsDepthPrepassActive() const
 {
-	// declare the variables for the transformations
-	glm::vec3 scaleXYZ;
-	float XrotationDegrees = 0.0f;
-	float YrotationDegrees = 0.0f;
-	float ZrotationDegrees = 0.0f;
-	glm::vec3 positionXYZ;
-
-	glm::mat4 scale;
-	glm::mat4 rotation;
-	glm::mat4 rotation2;
-	glm::mat4 translation;
-	glm::mat4 model;
-
-	// CREATING DESKTOP
-
-	// BOOK #1 (PAGES)
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(2.6f, 0.2f, 3.0f); // wide , tall , deep
-
-	XrotationDegrees = 3.0f; // x = tilt forward/backward
-	YrotationDegrees = 0.0f; // y = spin left/right
-	ZrotationDegrees = 0.0f; // z = lean left/right
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(-6.5f, 4.5f, 1.5f); // right , downward , forward
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderColor(1.0, 1.0, 1.0, 1.0); // Pure White
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawBoxMesh();
-
-	// BOOK #1 (BOX)
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(2.6f, 0.3f, 3.0f); // wide , tall , deep
-
-	XrotationDegrees = 3.0f; // x = tilt forward/backward
-	YrotationDegrees = 0.0f; // y = spin left/right
-	ZrotationDegrees = 0.0f; // z = lean left/right
+	return((m_bDepthPrepass == true) && (m_bUseMultiDraw == true) && (m_depthPrepass.IsLoaded() == true));
+}
 
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(-6.5f, 4.7f, 1.5f); // right , downward , forward
+/***********************************************************
+ *  GetShaderHandles()
+ *
+ *  This method is used for getting the handles of the
+ *  shader uniforms that are set while rendering, so that
+ *  no uniform is looked up by name in the render loop.
+ ***********************************************************/
+void SceneManager::GetShaderHandles()
+{
+	m_shaderHandles.model = m_pShaderUniforms->GetHandle(g_ModelName);
+	m_shaderHandles.objectColor = m_pShaderUniforms->GetHandle(g_ColorValueName);
+	m_shaderHandles.objectTexture = m_pShaderUniforms->GetHandle(g_TextureValueName);
+	m_shaderHandles.textureLayer = m_pShaderUniforms->GetHandle(g_TextureLayerName);
+	m_shaderHandles.useTexture = m_pShaderUniforms->GetHandle(g_UseTextureName);
+	m_shaderHandles.useInstancing = m_pShaderUniforms->GetHandle(g_UseInstancingName);
+	m_shaderHandles.useDrawData = m_pShaderUniforms->GetHandle(g_UseDrawDataName);
+	m_shaderHandles.uvScale = m_pShaderUniforms->GetHandle(g_UVScaleName);
+	m_shaderHandles.materialIndex = m_pShaderUniforms->GetHandle(g_MaterialIndexName);
+}
 
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	//SetShaderColor(1.0, 0.85, 0.0, 1.0); // Bright Yellow
-
-	SetShaderTexture("plant");
-	SetShaderMaterial("cement");
-	SetTextureUVScale(1.0, 1.0);
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawBoxMesh();
-
-	// BOOK #2 (PAGES)
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(2.6f, 0.3f, 3.0f); // wide , tall , deep
+/***********************************************************
+ *  UploadObjectMaterials()
+ *
+ *  This method is used for packing all the defined materials
+ *  into the std140 layout of the material uniform block and
+ *  uploading them once.  While rendering, a draw only passes
+ *  the index of its material into the shader.  The index of
+ *  every tag is kept for the lookups by tag, the first
+ *  material wins when a tag is defined twice.  Materials
+ *  past the size of the block get no index, so they are
+ *  never passed into the shader.
+ ***********************************************************/
+void SceneManager::UploadObjectMaterials()
+{
+	int materialCount = (int)m_objectMaterials.size();
+	if (materialCount > g_MaxMaterials)
+	{
+		std::cout << "Too many materials defined, only the first " << g_MaxMaterials << " are used" << std::endl;
+		materialCount = g_MaxMaterials;
+	}
 
-	XrotationDegrees = 3.0f; // x = tilt forward/backward
-	YrotationDegrees = 0.0f; // y = spin left/right
-	ZrotationDegrees = 0.0f; // z = lean left/right
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(-6.5f, 4.0f, 1.5f); // right , downward , forward
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderColor(1.0, 1.0, 1.0, 1.0); // Pure White
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawBoxMesh();
-
-	// BOOK #2 (BOX)
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(2.6f, 0.3f, 3.0f); // wide , tall , deep
-
-	XrotationDegrees = 3.0f; // x = tilt forward/backward
-	YrotationDegrees = 0.0f; // y = spin left/right
-	ZrotationDegrees = 0.0f; // z = lean left/right
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(-6.5f, 4.3f, 1.5f); // right , downward , forward
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderColor(0.0, 1.0, 0.0, 1.0); // GREEN
-	SetShaderMaterial("cement");
-	SetTextureUVScale(1.0, 1.0);
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawBoxMesh();
-
-	// BOOK #3 (PAGES)
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(2.8f, 0.4f, 3.0f); // wide , tall , deep
-
-	XrotationDegrees = 3.0f; // x = tilt forward/backward
-	YrotationDegrees = 0.0f; // y = spin left/right
-	ZrotationDegrees = 0.0f; // z = lean left/right
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(-6.5f, 3.5f, 1.5f); // right , downward , forward
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderColor(1.0, 1.0, 1.0, 1.0); // Pure White
-
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawBoxMesh();
-
-	// BOOK #3 (BOX)
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(2.8f, 0.2f, 3.0f); // wide , tall , deep
-
-	XrotationDegrees = 0.0f; // x = tilt forward/backward
-	YrotationDegrees = 0.0f; // y = spin left/right
-	ZrotationDegrees = 0.0f; // z = lean left/right
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(-6.5f, 3.75f, 1.5f); // right , downward , forward
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderTexture("abstract");
-	SetShaderMaterial("cement");
-	SetTextureUVScale(1.0, 1.0);
-	SetShaderColor(1.0, 0.5, 0.0, 1.0); // ORANGE
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawBoxMesh();
-
-	/******************************************************************/
-
-	// PENCIL #1 - CONE (Dark Tip)
-	scaleXYZ = glm::vec3(0.1f, 0.1f, 0.2f); // Wide, tall, deep
-	XrotationDegrees = 0.0f;  // No tilt
-	YrotationDegrees = 0.0f;  // No spin
-	ZrotationDegrees = 0.0f;  // No lean
-	positionXYZ = glm::vec3(6.0f, 5.0f, -1.0f); // Right, downward, forward (close together)
-	SetTransformations(scaleXYZ, XrotationDegrees, YrotationDegrees, ZrotationDegrees, positionXYZ);
-	SetShaderColor(0.3, 0.15, 0.05, 1.0); // DARK BROWN
-	m_basicMeshes->DrawConeMesh(); // Draw cone mesh
-
-	// PENCIL #1 - CONE (Tip)
-	scaleXYZ = glm::vec3(0.1f, 0.2f, 0.2f); // Wide, tall, deep
-	XrotationDegrees = 0.0f;  // No tilt
-	YrotationDegrees = 0.0f;  // No spin
-	ZrotationDegrees = 0.0f;  // No lean
-	positionXYZ = glm::vec3(6.0f, 5.0f, -1.0f); // Right, downward, forward (close together)
-	SetTransformations(scaleXYZ, XrotationDegrees, YrotationDegrees, ZrotationDegrees, positionXYZ);
-	SetShaderColor(0.6, 0.4, 0.2, 1.0); // Darker wood color
-	m_basicMeshes->DrawConeMesh(); // Draw cone mesh
-
-	// PENCIL #1 - CYLINDER (Body)
-	scaleXYZ = glm::vec3(0.1f, 0.8f, 0.2f); // Wide, tall, deep
-	XrotationDegrees = 0.0f;  // No tilt
-	YrotationDegrees = 0.0f;  // No spin
-	ZrotationDegrees = 0.0f;  // No lean
-	positionXYZ = glm::vec3(6.0f, 5.0f, -1.0f); // Right, downward, forward (close together)
-	SetTransformations(scaleXYZ, XrotationDegrees, YrotationDegrees, ZrotationDegrees, positionXYZ);
-	SetShaderColor(1.0, 0.85, 0.0, 1.0); // Bright yellow
-	SetShaderMaterial("clay");
-	m_basicMeshes->DrawConeMesh(); // Draw cylinder mesh
-
-	// PENCIL #2 - CONE (Dark Tip)
-	scaleXYZ = glm::vec3(0.1f, 0.1f, 0.2f); // Wide, tall, deep
-	XrotationDegrees = 0.0f;  // No tilt
-	YrotationDegrees = 0.0f;  // No spin
-	ZrotationDegrees = 0.0f;  // No lean
-	positionXYZ = glm::vec3(5.7f, 5.0f, -1.0f); // Right, downward, forward (close together)
-	SetTransformations(scaleXYZ, XrotationDegrees, YrotationDegrees, ZrotationDegrees, positionXYZ);
-	SetShaderColor(0.3, 0.15, 0.05, 1.0); // DARK BROWN
-	m_basicMeshes->DrawConeMesh(); // Draw cone mesh
-
-	// PENCIL #2 - CONE (Tip)
-	scaleXYZ = glm::vec3(0.1f, 0.2f, 0.2f); // Wide, tall, deep
-	XrotationDegrees = 0.0f;  // No tilt
-	YrotationDegrees = 0.0f;  // No spin
-	ZrotationDegrees = 0.0f;  // No lean
-	positionXYZ = glm::vec3(5.7f, 5.0f, -1.0f); // Right, downward, forward (close together)
-	SetTransformations(scaleXYZ, XrotationDegrees, YrotationDegrees, ZrotationDegrees, positionXYZ);
-	SetShaderColor(0.6, 0.4, 0.2, 1.0); // Darker wood color
-	m_basicMeshes->DrawConeMesh(); // Draw cone mesh
-
-	// PENCIL #2 - CYLINDER (Body)
-	scaleXYZ = glm::vec3(0.1f, 0.8f, 0.2f); // Wide, tall, deep
-	XrotationDegrees = 0.0f;  // No tilt
-	YrotationDegrees = 0.0f;  // No spin
-	ZrotationDegrees = 0.0f;  // No lean
-	positionXYZ = glm::vec3(5.7f, 5.0f, -1.0f); // Right, downward, forward (close together)
-	SetTransformations(scaleXYZ, XrotationDegrees, YrotationDegrees, ZrotationDegrees, positionXYZ);
-	SetShaderColor(1.0, 0.85, 0.0, 1.0); // Bright yellow
-	SetShaderMaterial("clay");
-	m_basicMeshes->DrawConeMesh(); // Draw cylinder mesh
-
-	/******************************************************************/
-
-	// PENCIL HOLDER (inside)
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(1.0f, 0.1f, 1.0f); // wide , tall , deep
-
-	XrotationDegrees = 0.0f; // x = tilt forward/backward
-	YrotationDegrees = 0.0f; // y = spin left/right
-	ZrotationDegrees = 0.0f; // z = lean left/right
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(5.8f, 5.0f, -1.3f); // right , downward , forward
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderColor(0.1, 0.1, 0.1, 1.0); // VERY DARK GRAY
-	SetShaderMaterial("glass");
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawCylinderMesh();
-
-	// PENCIL HOLDER
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(1.0f, 2.0f, 1.0f); // wide , tall , deep
-
-	XrotationDegrees = 0.0f; // x = tilt forward/backward
-	YrotationDegrees = 0.0f; // y = spin left/right
-	ZrotationDegrees = 0.0f; // z = lean left/right
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(5.8f, 3.0f, -1.3f); // right , downward , forward
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	//SetShaderColor(0.5, 0.0, 0.5, 1.0); // PURPLE
-
-	SetShaderTexture("tile");
-	SetShaderMaterial("cement");
-	SetTextureUVScale(1.0, 1.0);
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawCylinderMesh();
-
-	/******************************************************************/
-
-	// TORUS - (inside rim)
-	// set the XYZ scale for the mesh
-
-	scaleXYZ = glm::vec3(1.0f, 0.1f, 1.2f); // wide , tall , deep
-
-	XrotationDegrees = 0.0f; // x = tilt forward/backward
-	YrotationDegrees = 0.0f; // y = spin left/right
-	ZrotationDegrees = 0.0f; // z = lean left/right
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(8.5f, 5.6f, 2.0f); // right , downward , forward
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderColor(0.5, 0.25, 0.1, 1.0); // BROWN
-	SetShaderMaterial("cement");
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawCylinderMesh();
+	m_materialIDs.clear();
+	for (int index = 0; index < materialCount; index++)
+	{
+		m_materialIDs.emplace(m_objectMaterials[index].tag, index);
+	}
 
-	// TORUS - (cup rim)
-	// set the XYZ scale for the mesh
+	// the whole block is allocated, so an index past the
+	// defined materials reads zeros instead of undefined data
+	MATERIAL_DATA emptyMaterial;
+	emptyMaterial.ambientColorStrength = glm::vec4(0.0f);
+	emptyMaterial.diffuseColorShininess = glm::vec4(0.0f);
+	emptyMaterial.specularColor = glm::vec4(0.0f);
+	std::vector<MATERIAL_DATA> materials(g_MaxMaterials, emptyMaterial);
+	for (int i = 0; i < materialCount; i++)
+	{
+		const OBJECT_MATERIAL& material = m_objectMaterials[i];
+		materials[i].ambientColorStrength = glm::vec4(material.ambientColor, material.ambientStrength);
+		materials[i].diffuseColorShininess = glm::vec4(material.diffuseColor, material.shininess);
+		materials[i].specularColor = glm::vec4(material.specularColor, 0.0f);
+	}
 
-	scaleXYZ = glm::vec3(1.2f, 0.2f, 1.2f); // wide , tall , deep
+	m_materialBuffer.Create(
+		g_MaterialBindingPoint,
+		(GLsizeiptr)(materials.size() * sizeof(MATERIAL_DATA)),
+		materials.data());
+	m_pShaderUniforms->BindUniformBlock(g_MaterialBlockName, g_MaterialBindingPoint);
+}
 
-	XrotationDegrees = 0.0f; // x = tilt forward/backward
-	YrotationDegrees = 0.0f; // y = spin left/right
-	ZrotationDegrees = 0.0f; // z = lean left/right
+/***********************************************************
+ *  LoadSceneObjects()
+ *
+ *  This method is used for loading the scene description
+ *  and resolving it into the flat table of scene objects
+ *  that is drawn every frame.
+ ***********************************************************/
+bool SceneManager::LoadSceneObjects()
+{
+	SceneFile sceneFile;
 
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(8.5f, 5.5f, 2.0f); // right , downward , forward
+	m_sceneNodes.clear();
+	m_sceneObjects.clear();
+	m_objectHandles.Clear();
+	m_localTransforms.Resize(0);
+	m_bObjectsChanged = false;
 
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
+	if (sceneFile.Load(g_SceneTextFile, g_SceneBinaryFile) == false)
+	{
+		std::cout << "Could not load scene:" << g_SceneTextFile << std::endl;
+		return(false);
+	}
 
-	//SetShaderColor(0.3, 0.0, 0.3, 1.0); // DARK PURPLE
+	// resolve the texture and material tags only once
+	std::vector<int> textureSlots;
+	for (const std::string& tag : sceneFile.textureTags)
+	{
+		textureSlots.push_back(FindTextureSlot(tag));
+		if (textureSlots.back() < 0)
+		{
+			std::cout << "Scene references unknown texture:" << tag << std::endl;
+		}
+	}
+	std::vector<int> materialIDs;
+	for (const std::string& tag : sceneFile.materialTags)
+	{
+		materialIDs.push_back(FindMaterialID(tag));
+		if (materialIDs.back() < 0)
+		{
+			std::cout << "Scene references unknown material:" << tag << std::endl;
+		}
+	}
 
-	SetShaderTexture("marble");
-	SetShaderMaterial("gold");
-	SetTextureUVScale(1.0, 1.0);
+	// parents come before their children in the file, so a
+	// node is static only when its parent is
+	std::vector<int> parents;
+	m_sceneNodes.reserve(sceneFile.nodes.size());
+	m_localTransforms.Resize((int)(sceneFile.nodes.size() + sceneFile.objects.size()));
+	for (size_t index = 0; index < sceneFile.nodes.size(); index++)
+	{
+		const SceneFile::NODE_RECORD& record = sceneFile.nodes[index];
+		if (record.parentIndex >= (int)index)
+		{
+			std::cout << "Scene node parent is not defined before it:" << sceneFile.nodeNames[index] << std::endl;
+			m_sceneNodes.clear();
+			m_localTransforms.Resize(0);
+			return(false);
+		}
 
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawCylinderMesh();
+		SCENE_NODE node;
+		node.name = sceneFile.nodeNames[index];
+		m_localTransforms.Set((int)index,
+			glm::vec3(record.scaleXYZ[0], record.scaleXYZ[1], record.scaleXYZ[2]),
+			glm::vec3(record.rotationXYZ[0], record.rotationXYZ[1], record.rotationXYZ[2]),
+			glm::vec3(record.positionXYZ[0], record.positionXYZ[1], record.positionXYZ[2]));
+		node.bTransformDirty = true;
+		node.bStatic = ((record.flags & NODE_FLAG_STATIC) != 0) &&
+			((record.parentIndex < 0) || (m_sceneNodes[record.parentIndex].bStatic == true));
+		node.bBaked = false;
+		m_sceneNodes.push_back(node);
+		parents.push_back(record.parentIndex);
+	}
 
-	// CYLINDER - (coffee mug)
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(1.2f, 2.5f, 1.2f); // wide , tall , deep
+	m_sceneObjects.reserve(sceneFile.objects.size());
+	m_frustumCuller.Resize((int)sceneFile.objects.size());
+	m_sceneHierarchy.Resize((int)sceneFile.objects.size());
+	for (const SceneFile::OBJECT_RECORD& record : sceneFile.objects)
+	{
+		if (record.parentIndex >= (int)m_sceneNodes.size())
+		{
+			std::cout << "Scene object parent is not defined:" << record.parentIndex << std::endl;
+			m_sceneNodes.clear();
+			m_sceneObjects.clear();
+			m_objectHandles.Clear();
+			m_localTransforms.Resize(0);
+			return(false);
+		}
 
-	XrotationDegrees = 0.0f; // x = tilt forward/backward
-	YrotationDegrees = 0.0f; // y = spin left/right
-	ZrotationDegrees = 0.0f; // z = lean left/right
+		SCENE_OBJECT object;
+		object.meshID = record.meshID;
+		object.textureID = (record.textureIndex >= 0) ? textureSlots[record.textureIndex] : -1;
+		object.materialID = (record.materialIndex >= 0) ? materialIDs[record.materialIndex] : -1;
+		object.color = glm::vec4(record.color[0], record.color[1], record.color[2], record.color[3]);
+		object.uvScale = glm::vec2(record.uvScale[0], record.uvScale[1]);
+		m_localTransforms.Set((int)(m_sceneNodes.size() + m_sceneObjects.size()),
+			glm::vec3(record.scaleXYZ[0], record.scaleXYZ[1], record.scaleXYZ[2]),
+			glm::vec3(record.rotationXYZ[0], record.rotationXYZ[1], record.rotationXYZ[2]),
+			glm::vec3(record.positionXYZ[0], record.positionXYZ[1], record.positionXYZ[2]));
+		object.bTransformDirty = true;
+		object.batchID = -1;
+		object.bStatic = ((record.flags & OBJECT_FLAG_STATIC) != 0) &&
+			((record.parentIndex < 0) || (m_sceneNodes[record.parentIndex].bStatic == true));
+		object.bBaked = false;
+		object.bOccluder = ((record.flags & OBJECT_FLAG_OCCLUDER) != 0);
+		object.bTransparent = IsTransparent(object.textureID, object.color);
+		object.boundingSphere = glm::vec4(0.0f);
+		object.lodLevel = 0;
+		object.parentIndex = record.parentIndex;
+		m_sceneObjects.push_back(object);
+		m_objectHandles.Add();
+		parents.push_back(record.parentIndex);
+	}
 
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(8.5f, 3.0f, 2.0f); // right , downward , forward
+	if (m_sceneGraph.Build(parents) == false)
+	{
+		std::cout << "Could not build the scene graph:" << g_SceneTextFile << std::endl;
+		m_sceneNodes.clear();
+		m_sceneObjects.clear();
+		m_objectHandles.Clear();
+		m_localTransforms.Resize(0);
+		return(false);
+	}
 
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
+	// build all the model matrices up front, static objects
+	// never need them rebuilt again
+	UpdateTransformations();
 
-	//SetShaderColor(0.5, 0.0, 0.5, 1.0); // PURPLE
+	// the baked meshes are drawn through the mesh arena
+	m_bakedDraws.clear();
+	if (m_bUseMultiDraw == true)
+	{
+		BakeStaticObjects();
+	}
 
-	SetShaderTexture("gold");
-	SetShaderMaterial("cement");
-	//SetTextureUVScale(1.0, 1.0);
+	// group the repeated objects into instanced draws
+	BuildInstanceBatches();
 
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawCylinderMesh();
+	BuildSceneHierarchy();
 
-	// TORUS - (coffee cup handle)
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(0.4f, 0.5f, 1.5f); // wide , tall , deep
+	return(true);
+}
 
-	XrotationDegrees = 0.0f; // x = tilt forward/backward
-	YrotationDegrees = 0.0f; // y = spin left/right
-	ZrotationDegrees = 0.0f; // z = lean left/right
+/***********************************************************
+ *  BuildSceneHierarchy()
+ *
+ *  This method is used for building the object hierarchy
+ *  from the culling boxes of the scene objects.  It covers
+ *  every object, baked or not, so the spatial queries find
+ *  all of them.
+ ***********************************************************/
+void SceneManager::BuildSceneHierarchy()
+{
+	std::vector<int> primitives(m_sceneObjects.size());
+	for (int index = 0; index < (int)m_sceneObjects.size(); index++)
+	{
+		primitives[index] = index;
+	}
+	m_sceneHierarchy.Build(primitives);
+}
 
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(10.0f, 4.5f, 2.0f); // right , downward , forward
+/***********************************************************
+ *  AddSceneObject()
+ *
+ *  This method is used for adding a scene object while the
+ *  scene is running.  It goes at the end of the table and
+ *  is drawn on its own, it is never baked or batched.  The
+ *  scene graph and the culling boxes take it in before the
+ *  next frame is rendered.
+ ***********************************************************/
+SceneManager::OBJECT_HANDLE SceneManager::AddSceneObject(
+	int meshID,
+	const std::string& textureTag,
+	const std::string& materialTag,
+	const glm::vec4& color,
+	int parentNode,
+	glm::vec3 scaleXYZ,
+	glm::vec3 rotationXYZ,
+	glm::vec3 positionXYZ)
+{
+	if ((meshID < 0) || (meshID >= MESH_COUNT))
+	{
+		std::cout << "Scene object mesh is not defined:" << meshID << std::endl;
+		return(OBJECT_HANDLE());
+	}
+	if ((parentNode < -1) || (parentNode >= (int)m_sceneNodes.size()))
+	{
+		std::cout << "Scene object parent is not defined:" << parentNode << std::endl;
+		return(OBJECT_HANDLE());
+	}
 
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
+	SCENE_OBJECT object;
+	object.meshID = meshID;
+	object.textureID = (textureTag.empty() == false) ? FindTextureSlot(textureTag) : -1;
+	object.materialID = (materialTag.empty() == false) ? FindMaterialID(materialTag) : -1;
+	object.color = color;
+	object.uvScale = glm::vec2(1.0f, 1.0f);
+	object.modelMatrix = glm::mat4(1.0f);
+	object.bTransformDirty = true;
+	object.batchID = -1;
+	object.bStatic = false;
+	object.bBaked = false;
+	object.bOccluder = false;
+	object.bTransparent = IsTransparent(object.textureID, object.color);
+	object.boundingSphere = glm::vec4(0.0f);
+	object.lodLevel = 0;
+	object.parentIndex = parentNode;
+
+	m_sceneObjects.push_back(object);
+	const int transformCount = (int)(m_sceneNodes.size() + m_sceneObjects.size());
+	m_localTransforms.Resize(transformCount);
+	m_localTransforms.Set(transformCount - 1, scaleXYZ, rotationXYZ, positionXYZ);
+	m_bObjectsChanged = true;
+
+	return(m_objectHandles.Add());
+}
 
-	//SetShaderColor(0.5, 0.0, 0.5, 1.0); // PURPLE
+/***********************************************************
+ *  RemoveSceneObject()
+ *
+ *  This method is used for removing a scene object while
+ *  the scene is running.  The last object in the table is
+ *  moved into its place, so the table stays packed and only
+ *  the instance batch of the moved object has to follow it.
+ *  The scene graph and the culling boxes are rebuilt before
+ *  the next frame is rendered.
+ ***********************************************************/
+bool SceneManager::RemoveSceneObject(OBJECT_HANDLE objectHandle)
+{
+	const int objectIndex = m_objectHandles.GetIndex(objectHandle);
+	if (objectIndex < 0)
+	{
+		std::cout << "Scene object handle is stale:" << objectHandle.slot << std::endl;
+		return(false);
+	}
+	if (m_sceneObjects[objectIndex].bBaked == true)
+	{
+		std::cout << "Baked static object cannot be removed:" << objectIndex << std::endl;
+		return(false);
+	}
 
-	SetShaderTexture("gold");
-	SetShaderMaterial("cement");
-	SetTextureUVScale(1.0, 1.0);
+	// the batch draws one instance less
+	const int batchID = m_sceneObjects[objectIndex].batchID;
+	if (batchID >= 0)
+	{
+		std::vector<int>& objectIndices = m_instanceBatches[batchID].objectIndices;
+		objectIndices.erase(std::find(objectIndices.begin(), objectIndices.end(), objectIndex));
+		m_instanceBatches[batchID].bDirty = true;
+	}
 
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawTorusMesh();
-
-	/******************************************************************/
-
-	// iMAC (white screen)
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(6.5f, 10.0f, 4.0f); // wide , tall , deep
+	m_objectHandles.Remove(objectHandle);
+	const int nodeCount = (int)m_sceneNodes.size();
+	const int lastIndex = (int)m_sceneObjects.size() - 1;
+	if (objectIndex != lastIndex)
+	{
+		m_sceneObjects[objectIndex] = m_sceneObjects[lastIndex];
+		m_localTransforms.Move(nodeCount + lastIndex, nodeCount + objectIndex);
 
-	XrotationDegrees = 75.0f; // x = tilt forward/backward
-	YrotationDegrees = 0.0f; // y = spin left/right
-	ZrotationDegrees = 0.0f; // z = lean left/right
+		const int movedBatchID = m_sceneObjects[objectIndex].batchID;
+		if (movedBatchID >= 0)
+		{
+			std::vector<int>& objectIndices = m_instanceBatches[movedBatchID].objectIndices;
+			*std::find(objectIndices.begin(), objectIndices.end(), lastIndex) = objectIndex;
+			m_instanceBatches[movedBatchID].bDirty = true;
+		}
+	}
+	m_sceneObjects.pop_back();
+	m_localTransforms.Resize(nodeCount + lastIndex);
+	m_bObjectsChanged = true;
 
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(0.0f, 10.3f, -2.0f); // right , downward , forward
+	return(true);
+}
 
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
+/***********************************************************
+ *  RebuildObjectLayout()
+ *
+ *  This method is used for catching up with the objects
+ *  added and removed since the last frame.  The scene graph
+ *  is built again, which moves every object to its new
+ *  index, and all the local matrices are set again.  The
+ *  culling boxes of the baked meshes move to follow the
+ *  objects, the ones of the objects are set when their
+ *  world matrices are rebuilt.
+ ***********************************************************/
+void SceneManager::RebuildObjectLayout()
+{
+	const int nodeCount = (int)m_sceneNodes.size();
+	const int objectCount = (int)m_sceneObjects.size();
 
-	SetShaderColor(1.0, 1.0, 1.0, 1.0); // WHITE
-	SetShaderMaterial("glass");
+	// the nodes themselves did not change
+	std::vector<int> parents(nodeCount + objectCount);
+	for (int index = 0; index < nodeCount; index++)
+	{
+		parents[index] = m_sceneGraph.GetParent(index);
+		m_sceneNodes[index].bTransformDirty = true;
+	}
+	for (int index = 0; index < objectCount; index++)
+	{
+		parents[nodeCount + index] = m_sceneObjects[index].parentIndex;
+		m_sceneObjects[index].bTransformDirty = true;
+	}
+	m_sceneGraph.Build(parents);
 
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawPlaneMesh();
+	m_frustumCuller.Resize(objectCount + (int)m_bakedDraws.size());
+	m_sceneHierarchy.Resize(objectCount);
+	for (int bakedID = 0; bakedID < (int)m_bakedDraws.size(); bakedID++)
+	{
+		const BAKED_DRAW& baked = m_bakedDraws[bakedID];
+		SetCullingBounds(objectCount + bakedID, baked.boundsCenter, baked.boundsExtents);
+	}
+}
 
-	// iMAC (silver screen)
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(8.0f, 10.0f, 5.0f); // wide , tall , deep
+/***********************************************************
+ *  BakeStaticObjects()
+ *
+ *  This method is used for merging the static scene objects
+ *  into baked meshes in the mesh arena.  The static objects
+ *  that share a texture and material are drawn as one mesh,
+ *  so the static draws scale with the number of different
+ *  materials instead of the number of objects.
+ ***********************************************************/
+void SceneManager::BakeStaticObjects()
+{
+	std::vector<StaticGeometry::BAKE_OBJECT> bakeObjects;
+	StaticGeometry staticGeometry;
 
-	XrotationDegrees = 75.0f; // x = tilt forward/backward
-	YrotationDegrees = 0.0f; // y = spin left/right
-	ZrotationDegrees = 0.0f; // z = lean left/right
+	for (const SCENE_OBJECT& object : m_sceneObjects)
+	{
+		if (object.bStatic == false)
+		{
+			continue;
+		}
 
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(0.0f, 10.5f, -3.0f); // right , downward , forward
+		StaticGeometry::BAKE_OBJECT bakeObject;
+		bakeObject.meshID = object.meshID;
+		bakeObject.textureID = object.textureID;
+		bakeObject.materialID = object.materialID;
+		bakeObject.color = object.color;
+		bakeObject.uvScale = object.uvScale;
+		bakeObject.modelMatrix = object.modelMatrix;
+		bakeObjects.push_back(bakeObject);
+	}
 
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
+	if (bakeObjects.empty() == true)
+	{
+		return;
+	}
 
-	//SetShaderColor(0.7, 0.7, 0.7, 1.0); // Light Gray
-
-	SetShaderTexture("metallic");
-	SetShaderMaterial("cement");
-	SetTextureUVScale(1.0, 1.0);
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawPlaneMesh();
-
-	/******************************************************************/
-
-	// iMAC (mouse scroll ball)
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(0.2f, 0.2f, 0.2f); // wide , tall , deep
-
-	XrotationDegrees = 0.0f; // x = tilt forward/backward
-	YrotationDegrees = 0.0f; // y = spin left/right
-	ZrotationDegrees = 0.0f; // z = lean left/right
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(5.0f, 3.55f, 1.7f); // right , downward , forward
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderColor(1.0, 0.0, 0.0, 1.0); // RED
-	SetShaderMaterial("glass");
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawSphereMesh();
-	
-	// iMAC (iMac mouse)
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(1.0f, 0.1f, 1.0f); // wide , tall , deep
-
-	XrotationDegrees = 0.0f; // x = tilt forward/backward
-	YrotationDegrees = 0.0f; // y = spin left/right
-	ZrotationDegrees = 0.0f; // z = lean left/right
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(5.0f, 3.55f, 2.0f); // right , downward , forward
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	//SetShaderColor(0.7, 0.7, 0.7, 1.0); // LIGHT GREY
-
-	SetShaderTexture("metallic");
-	SetShaderMaterial("glass");
-	SetTextureUVScale(1.0, 1.0);
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawBoxMesh();
-
-	/******************************************************************/
-
-	// KEYBOARD ROW #1
-
-	/******************************************************************/
-
-	// iMAC (key letter #1)
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(0.03f, 0.03f, 0.03f); // wide , tall , deep
-
-	XrotationDegrees = 0.0f; // x = tilt forward/backward
-	YrotationDegrees = 0.0f; // y = spin left/right
-	ZrotationDegrees = 0.0f; // z = lean left/right
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(-2.4f, 3.75f, 1.5f); // right , downward , forward
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderColor(0.0, 0.0, 0.0, 1.0); // BLACK
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawPlaneMesh();
-
-	// iMAC (keyboard key #1)
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(0.2f, 0.3f, 0.2f); // wide , tall , deep
-
-	XrotationDegrees = 0.0f; // x = tilt forward/backward
-	YrotationDegrees = 0.0f; // y = spin left/right
-	ZrotationDegrees = 0.0f; // z = lean left/right
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(-2.4f, 3.55f, 1.5f); // right , downward , forward
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderColor(1.0, 1.0, 1.0, 1.0); // WHITE
-	SetShaderTexture("metallic");
-	SetShaderMaterial("glass");
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawBoxMesh();
-
-	// iMAC (key letter #2)
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(0.03f, 0.03f, 0.03f); // wide , tall , deep
-
-	XrotationDegrees = 0.0f; // x = tilt forward/backward
-	YrotationDegrees = 0.0f; // y = spin left/right
-	ZrotationDegrees = 0.0f; // z = lean left/right
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(-2.0f, 3.75f, 1.5f); // right , downward , forward
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderColor(0.0, 0.0, 0.0, 1.0); // BLACK
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawPlaneMesh();
-
-	// iMAC (keyboard key #2)
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(0.2f, 0.3f, 0.2f); // wide , tall , deep
-
-	XrotationDegrees = 0.0f; // x = tilt forward/backward
-	YrotationDegrees = 0.0f; // y = spin left/right
-	ZrotationDegrees = 0.0f; // z = lean left/right
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(-2.0f, 3.55f, 1.5f); // right , downward , forward
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderColor(1.0, 1.0, 1.0, 1.0); // WHITE
-	SetShaderTexture("metallic");
-	SetShaderMaterial("glass");
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawBoxMesh();
-
-	// iMAC (key letter #3)
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(0.03f, 0.03f, 0.03f); // wide , tall , deep
-
-	XrotationDegrees = 0.0f; // x = tilt forward/backward
-	YrotationDegrees = 0.0f; // y = spin left/right
-	ZrotationDegrees = 0.0f; // z = lean left/right
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(-1.6f, 3.75f, 1.5f); // right , downward , forward
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderColor(0.0, 0.0, 0.0, 1.0); // BLACK
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawPlaneMesh();
-
-	// iMAC (keyboard key #3)
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(0.2f, 0.3f, 0.2f); // wide , tall , deep
-
-	XrotationDegrees = 0.0f; // x = tilt forward/backward
-	YrotationDegrees = 0.0f; // y = spin left/right
-	ZrotationDegrees = 0.0f; // z = lean left/right
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(-1.6f, 3.55f, 1.5f); // right , downward , forward
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderColor(1.0, 1.0, 1.0, 1.0); // WHITE
-	SetShaderTexture("metallic");
-	SetShaderMaterial("glass");
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawBoxMesh();
-
-	// iMAC (key letter #4)
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(0.03f, 0.03f, 0.03f); // wide , tall , deep
-
-	XrotationDegrees = 0.0f; // x = tilt forward/backward
-	YrotationDegrees = 0.0f; // y = spin left/right
-	ZrotationDegrees = 0.0f; // z = lean left/right
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(-1.2f, 3.75f, 1.5f); // right , downward , forward
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderColor(0.0, 0.0, 0.0, 1.0); // BLACK
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawPlaneMesh();
-
-	// iMAC (keyboard key #4)
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(0.2f, 0.3f, 0.2f); // wide , tall , deep
-
-	XrotationDegrees = 0.0f; // x = tilt forward/backward
-	YrotationDegrees = 0.0f; // y = spin left/right
-	ZrotationDegrees = 0.0f; // z = lean left/right
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(-1.2f, 3.55f, 1.5f); // right , downward , forward
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderColor(1.0, 1.0, 1.0, 1.0); // WHITE
-	SetShaderTexture("metallic");
-	SetShaderMaterial("glass");
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawBoxMesh();
-
-	// iMAC (key letter #5)
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(0.03f, 0.03f, 0.03f); // wide , tall , deep
-
-	XrotationDegrees = 0.0f; // x = tilt forward/backward
-	YrotationDegrees = 0.0f; // y = spin left/right
-	ZrotationDegrees = 0.0f; // z = lean left/right
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(-0.8f, 3.75f, 1.5f); // right , downward , forward
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderColor(0.0, 0.0, 0.0, 1.0); // BLACK
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawPlaneMesh();
-
-	// iMAC (keyboard key #5)
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(0.2f, 0.3f, 0.2f); // wide , tall , deep
-
-	XrotationDegrees = 0.0f; // x = tilt forward/backward
-	YrotationDegrees = 0.0f; // y = spin left/right
-	ZrotationDegrees = 0.0f; // z = lean left/right
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(-0.8f, 3.55f, 1.5f); // right , downward , forward
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderColor(1.0, 1.0, 1.0, 1.0); // WHITE
-	SetShaderTexture("metallic");
-	SetShaderMaterial("glass");
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawBoxMesh();
-
-	// iMAC (key letter #6)
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(0.03f, 0.03f, 0.03f); // wide , tall , deep
-
-	XrotationDegrees = 0.0f; // x = tilt forward/backward
-	YrotationDegrees = 0.0f; // y = spin left/right
-	ZrotationDegrees = 0.0f; // z = lean left/right
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(-0.4f, 3.75f, 1.5f); // right , downward , forward
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderColor(0.0, 0.0, 0.0, 1.0); // BLACK
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawPlaneMesh();
-
-	// iMAC (keyboard key #6)
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(0.2f, 0.3f, 0.2f); // wide , tall , deep
-
-	XrotationDegrees = 0.0f; // x = tilt forward/backward
-	YrotationDegrees = 0.0f; // y = spin left/right
-	ZrotationDegrees = 0.0f; // z = lean left/right
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(-0.4f, 3.55f, 1.5f); // right , downward , forward
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderColor(1.0, 1.0, 1.0, 1.0); // WHITE
-	SetShaderTexture("metallic");
-	SetShaderMaterial("glass");
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawBoxMesh();
-
-	// iMAC (key letter #7)
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(0.03f, 0.03f, 0.03f); // wide , tall , deep
-
-	XrotationDegrees = 0.0f; // x = tilt forward/backward
-	YrotationDegrees = 0.0f; // y = spin left/right
-	ZrotationDegrees = 0.0f; // z = lean left/right
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(0.0f, 3.75f, 1.5f); // right , downward , forward
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderColor(0.0, 0.0, 0.0, 1.0); // BLACK
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawPlaneMesh();
-
-	// iMAC (keyboard key #7)
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(0.2f, 0.3f, 0.2f); // wide , tall , deep
-
-	XrotationDegrees = 0.0f; // x = tilt forward/backward
-	YrotationDegrees = 0.0f; // y = spin left/right
-	ZrotationDegrees = 0.0f; // z = lean left/right
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(0.0f, 3.55f, 1.5f); // right , downward , forward
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderColor(1.0, 1.0, 1.0, 1.0); // WHITE
-	SetShaderTexture("metallic");
-	SetShaderMaterial("glass");
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawBoxMesh();
-
-	// iMAC (key letter #8)
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(0.03f, 0.03f, 0.03f); // wide , tall , deep
-
-	XrotationDegrees = 0.0f; // x = tilt forward/backward
-	YrotationDegrees = 0.0f; // y = spin left/right
-	ZrotationDegrees = 0.0f; // z = lean left/right
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(0.4f, 3.75f, 1.5f); // right , downward , forward
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderColor(0.0, 0.0, 0.0, 1.0); // BLACK
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawPlaneMesh();
-
-	// iMAC (keyboard key #8)
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(0.2f, 0.3f, 0.2f); // wide , tall , deep
-
-	XrotationDegrees = 0.0f; // x = tilt forward/backward
-	YrotationDegrees = 0.0f; // y = spin left/right
-	ZrotationDegrees = 0.0f; // z = lean left/right
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(0.4f, 3.55f, 1.5f); // right , downward , forward
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderColor(1.0, 1.0, 1.0, 1.0); // WHITE
-	SetShaderTexture("metallic");
-	SetShaderMaterial("glass");
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawBoxMesh();
-
-	// iMAC (key letter #9)
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(0.03f, 0.03f, 0.03f); // wide , tall , deep
-
-	XrotationDegrees = 0.0f; // x = tilt forward/backward
-	YrotationDegrees = 0.0f; // y = spin left/right
-	ZrotationDegrees = 0.0f; // z = lean left/right
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(0.8f, 3.75f, 1.5f); // right , downward , forward
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderColor(0.0, 0.0, 0.0, 1.0); // BLACK
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawPlaneMesh();
-
-	// iMAC (keyboard key #9)
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(0.2f, 0.3f, 0.2f); // wide , tall , deep
-
-	XrotationDegrees = 0.0f; // x = tilt forward/backward
-	YrotationDegrees = 0.0f; // y = spin left/right
-	ZrotationDegrees = 0.0f; // z = lean left/right
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(0.8f, 3.55f, 1.5f); // right , downward , forward
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderColor(1.0, 1.0, 1.0, 1.0); // WHITE
-	SetShaderTexture("metallic");
-	SetShaderMaterial("glass");
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawBoxMesh();
-
-	// iMAC (key letter #10)
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(0.03f, 0.03f, 0.03f); // wide , tall , deep
-
-	XrotationDegrees = 0.0f; // x = tilt forward/backward
-	YrotationDegrees = 0.0f; // y = spin left/right
-	ZrotationDegrees = 0.0f; // z = lean left/right
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(1.2f, 3.75f, 1.5f); // right , downward , forward
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderColor(0.0, 0.0, 0.0, 1.0); // BLACK
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawPlaneMesh();
-
-	// iMAC (keyboard key #10)
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(0.2f, 0.3f, 0.2f); // wide , tall , deep
-
-	XrotationDegrees = 0.0f; // x = tilt forward/backward
-	YrotationDegrees = 0.0f; // y = spin left/right
-	ZrotationDegrees = 0.0f; // z = lean left/right
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(1.2f, 3.55f, 1.5f); // right , downward , forward
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderColor(1.0, 1.0, 1.0, 1.0); // WHITE
-	SetShaderTexture("metallic");
-	SetShaderMaterial("glass");
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawBoxMesh();
-
-	/******************************************************************/
-
-	// KEYBOARD ROW #2
-
-	/******************************************************************/
-
-	// iMAC (key letter #1)
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(0.03f, 0.03f, 0.03f); // wide , tall , deep
-
-	XrotationDegrees = 0.0f; // x = tilt forward/backward
-	YrotationDegrees = 0.0f; // y = spin left/right
-	ZrotationDegrees = 0.0f; // z = lean left/right
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(-2.4f, 3.75f, 2.0f); // right , downward , forward
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderColor(0.0, 0.0, 0.0, 1.0); // BLACK
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawPlaneMesh();
-
-	// iMAC (keyboard key #1)
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(0.2f, 0.3f, 0.2f); // wide , tall , deep
-
-	XrotationDegrees = 0.0f; // x = tilt forward/backward
-	YrotationDegrees = 0.0f; // y = spin left/right
-	ZrotationDegrees = 0.0f; // z = lean left/right
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(-2.4f, 3.55f, 2.0f); // right , downward , forward
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderColor(1.0, 1.0, 1.0, 1.0); // WHITE
-	SetShaderTexture("metallic");
-	SetShaderMaterial("glass");
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawBoxMesh();
-
-	// iMAC (key letter #2)
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(0.03f, 0.03f, 0.03f); // wide , tall , deep
-
-	XrotationDegrees = 0.0f; // x = tilt forward/backward
-	YrotationDegrees = 0.0f; // y = spin left/right
-	ZrotationDegrees = 0.0f; // z = lean left/right
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(-2.0f, 3.75f, 2.0f); // right , downward , forward
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderColor(0.0, 0.0, 0.0, 1.0); // BLACK
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawPlaneMesh();
-
-	// iMAC (keyboard key #2)
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(0.2f, 0.3f, 0.2f); // wide , tall , deep
-
-	XrotationDegrees = 0.0f; // x = tilt forward/backward
-	YrotationDegrees = 0.0f; // y = spin left/right
-	ZrotationDegrees = 0.0f; // z = lean left/right
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(-2.0f, 3.55f, 2.0f); // right , downward , forward
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderColor(1.0, 1.0, 1.0, 1.0); // WHITE
-	SetShaderTexture("metallic");
-	SetShaderMaterial("glass");
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawBoxMesh();
-
-	// iMAC (key letter #3)
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(0.03f, 0.03f, 0.03f); // wide , tall , deep
-
-	XrotationDegrees = 0.0f; // x = tilt forward/backward
-	YrotationDegrees = 0.0f; // y = spin left/right
-	ZrotationDegrees = 0.0f; // z = lean left/right
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(-1.6f, 3.75f, 2.0f); // right , downward , forward
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderColor(0.0, 0.0, 0.0, 1.0); // BLACK
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawPlaneMesh();
-
-	// iMAC (keyboard key #3)
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(0.2f, 0.3f, 0.2f); // wide , tall , deep
-
-	XrotationDegrees = 0.0f; // x = tilt forward/backward
-	YrotationDegrees = 0.0f; // y = spin left/right
-	ZrotationDegrees = 0.0f; // z = lean left/right
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(-1.6f, 3.55f, 2.0f); // right , downward , forward
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderColor(1.0, 1.0, 1.0, 1.0); // WHITE
-	SetShaderTexture("metallic");
-	SetShaderMaterial("glass");
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawBoxMesh();
-
-	// iMAC (key letter #4)
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(0.03f, 0.03f, 0.03f); // wide , tall , deep
-
-	XrotationDegrees = 0.0f; // x = tilt forward/backward
-	YrotationDegrees = 0.0f; // y = spin left/right
-	ZrotationDegrees = 0.0f; // z = lean left/right
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(-1.2f, 3.75f, 2.0f); // right , downward , forward
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderColor(0.0, 0.0, 0.0, 1.0); // BLACK
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawPlaneMesh();
-
-	// iMAC (keyboard key #4)
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(0.2f, 0.3f, 0.2f); // wide , tall , deep
-
-	XrotationDegrees = 0.0f; // x = tilt forward/backward
-	YrotationDegrees = 0.0f; // y = spin left/right
-	ZrotationDegrees = 0.0f; // z = lean left/right
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(-1.2f, 3.55f, 2.0f); // right , downward , forward
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderColor(1.0, 1.0, 1.0, 1.0); // WHITE
-	SetShaderTexture("metallic");
-	SetShaderMaterial("glass");
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawBoxMesh();
-
-	// iMAC (key letter #5)
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(0.03f, 0.03f, 0.03f); // wide , tall , deep
-
-	XrotationDegrees = 0.0f; // x = tilt forward/backward
-	YrotationDegrees = 0.0f; // y = spin left/right
-	ZrotationDegrees = 0.0f; // z = lean left/right
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(-0.8f, 3.75f, 2.0f); // right , downward , forward
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderColor(0.0, 0.0, 0.0, 1.0); // BLACK
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawPlaneMesh();
-
-	// iMAC (keyboard key #5)
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(0.2f, 0.3f, 0.2f); // wide , tall , deep
-
-	XrotationDegrees = 0.0f; // x = tilt forward/backward
-	YrotationDegrees = 0.0f; // y = spin left/right
-	ZrotationDegrees = 0.0f; // z = lean left/right
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(-0.8f, 3.55f, 2.0f); // right , downward , forward
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderColor(1.0, 1.0, 1.0, 1.0); // WHITE
-	SetShaderTexture("metallic");
-	SetShaderMaterial("glass");
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawBoxMesh();
-
-	// iMAC (key letter #6)
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(0.03f, 0.03f, 0.03f); // wide , tall , deep
-
-	XrotationDegrees = 0.0f; // x = tilt forward/backward
-	YrotationDegrees = 0.0f; // y = spin left/right
-	ZrotationDegrees = 0.0f; // z = lean left/right
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(-0.4f, 3.75f, 2.0f); // right , downward , forward
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderColor(0.0, 0.0, 0.0, 1.0); // BLACK
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawPlaneMesh();
-
-	// iMAC (keyboard key #6)
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(0.2f, 0.3f, 0.2f); // wide , tall , deep
-
-	XrotationDegrees = 0.0f; // x = tilt forward/backward
-	YrotationDegrees = 0.0f; // y = spin left/right
-	ZrotationDegrees = 0.0f; // z = lean left/right
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(-0.4f, 3.55f, 2.0f); // right , downward , forward
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderColor(1.0, 1.0, 1.0, 1.0); // WHITE
-	SetShaderTexture("metallic");
-	SetShaderMaterial("glass");
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawBoxMesh();
-
-	// iMAC (key letter #7)
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(0.03f, 0.03f, 0.03f); // wide , tall , deep
-
-	XrotationDegrees = 0.0f; // x = tilt forward/backward
-	YrotationDegrees = 0.0f; // y = spin left/right
-	ZrotationDegrees = 0.0f; // z = lean left/right
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(0.0f, 3.75f, 2.0f); // right , downward , forward
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderColor(0.0, 0.0, 0.0, 1.0); // BLACK
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawPlaneMesh();
-
-	// iMAC (keyboard key #7)
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(0.2f, 0.3f, 0.2f); // wide , tall , deep
-
-	XrotationDegrees = 0.0f; // x = tilt forward/backward
-	YrotationDegrees = 0.0f; // y = spin left/right
-	ZrotationDegrees = 0.0f; // z = lean left/right
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(0.0f, 3.55f, 2.0f); // right , downward , forward
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderColor(1.0, 1.0, 1.0, 1.0); // WHITE
-	SetShaderTexture("metallic");
-	SetShaderMaterial("glass");
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawBoxMesh();
-
-	// iMAC (key letter #8)
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(0.03f, 0.03f, 0.03f); // wide , tall , deep
-
-	XrotationDegrees = 0.0f; // x = tilt forward/backward
-	YrotationDegrees = 0.0f; // y = spin left/right
-	ZrotationDegrees = 0.0f; // z = lean left/right
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(0.4f, 3.75f, 2.0f); // right , downward , forward
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderColor(0.0, 0.0, 0.0, 1.0); // BLACK
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawPlaneMesh();
-
-	// iMAC (keyboard key #8)
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(0.2f, 0.3f, 0.2f); // wide , tall , deep
-
-	XrotationDegrees = 0.0f; // x = tilt forward/backward
-	YrotationDegrees = 0.0f; // y = spin left/right
-	ZrotationDegrees = 0.0f; // z = lean left/right
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(0.4f, 3.55f, 2.0f); // right , downward , forward
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderColor(1.0, 1.0, 1.0, 1.0); // WHITE
-	SetShaderTexture("metallic");
-	SetShaderMaterial("glass");
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawBoxMesh();
-
-	// iMAC (key letter #9)
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(0.03f, 0.03f, 0.03f); // wide , tall , deep
-
-	XrotationDegrees = 0.0f; // x = tilt forward/backward
-	YrotationDegrees = 0.0f; // y = spin left/right
-	ZrotationDegrees = 0.0f; // z = lean left/right
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(0.8f, 3.75f, 2.0f); // right , downward , forward
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderColor(0.0, 0.0, 0.0, 1.0); // BLACK
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawPlaneMesh();
-
-	// iMAC (keyboard key #9)
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(0.2f, 0.3f, 0.2f); // wide , tall , deep
-
-	XrotationDegrees = 0.0f; // x = tilt forward/backward
-	YrotationDegrees = 0.0f; // y = spin left/right
-	ZrotationDegrees = 0.0f; // z = lean left/right
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(0.8f, 3.55f, 2.0f); // right , downward , forward
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderColor(1.0, 1.0, 1.0, 1.0); // WHITE
-	SetShaderTexture("metallic");
-	SetShaderMaterial("glass");
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawBoxMesh();
-
-	// iMAC (key letter #10)
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(0.03f, 0.03f, 0.03f); // wide , tall , deep
-
-	XrotationDegrees = 0.0f; // x = tilt forward/backward
-	YrotationDegrees = 0.0f; // y = spin left/right
-	ZrotationDegrees = 0.0f; // z = lean left/right
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(1.2f, 3.75f, 2.0f); // right , downward , forward
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderColor(0.0, 0.0, 0.0, 1.0); // BLACK
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawPlaneMesh();
-
-	// iMAC (keyboard key #10)
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(0.2f, 0.3f, 0.2f); // wide , tall , deep
-
-	XrotationDegrees = 0.0f; // x = tilt forward/backward
-	YrotationDegrees = 0.0f; // y = spin left/right
-	ZrotationDegrees = 0.0f; // z = lean left/right
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(1.2f, 3.55f, 2.0f); // right , downward , forward
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderColor(1.0, 1.0, 1.0, 1.0); // WHITE
-	SetShaderTexture("metallic");
-	SetShaderMaterial("glass");
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawBoxMesh();
-
-	/******************************************************************/
-
-	// KEYBOARD ROW #3
-
-	/******************************************************************/
-
-	// iMAC (key letter #1)
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(0.03f, 0.03f, 0.03f); // wide , tall , deep
-
-	XrotationDegrees = 0.0f; // x = tilt forward/backward
-	YrotationDegrees = 0.0f; // y = spin left/right
-	ZrotationDegrees = 0.0f; // z = lean left/right
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(-2.4f, 3.75f, 2.5f); // right , downward , forward
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderColor(0.0, 0.0, 0.0, 1.0); // BLACK
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawPlaneMesh();
-
-	// iMAC (keyboard key #1)
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(0.2f, 0.3f, 0.2f); // wide , tall , deep
-
-	XrotationDegrees = 0.0f; // x = tilt forward/backward
-	YrotationDegrees = 0.0f; // y = spin left/right
-	ZrotationDegrees = 0.0f; // z = lean left/right
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(-2.4f, 3.55f, 2.5f); // right , downward , forward
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderColor(1.0, 1.0, 1.0, 1.0); // WHITE
-	SetShaderTexture("metallic");
-	SetShaderMaterial("glass");
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawBoxMesh();
-
-	// iMAC (key letter #2)
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(0.03f, 0.03f, 0.03f); // wide , tall , deep
-
-	XrotationDegrees = 0.0f; // x = tilt forward/backward
-	YrotationDegrees = 0.0f; // y = spin left/right
-	ZrotationDegrees = 0.0f; // z = lean left/right
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(-2.0f, 3.75f, 2.5f); // right , downward , forward
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderColor(0.0, 0.0, 0.0, 1.0); // BLACK
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawPlaneMesh();
-
-	// iMAC (keyboard key #2)
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(0.2f, 0.3f, 0.2f); // wide , tall , deep
-
-	XrotationDegrees = 0.0f; // x = tilt forward/backward
-	YrotationDegrees = 0.0f; // y = spin left/right
-	ZrotationDegrees = 0.0f; // z = lean left/right
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(-2.0f, 3.55f, 2.5f); // right , downward , forward
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderColor(1.0, 1.0, 1.0, 1.0); // WHITE
-	SetShaderTexture("metallic");
-	SetShaderMaterial("glass");
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawBoxMesh();
-
-	// iMAC (key letter #3)
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(0.03f, 0.03f, 0.03f); // wide , tall , deep
-
-	XrotationDegrees = 0.0f; // x = tilt forward/backward
-	YrotationDegrees = 0.0f; // y = spin left/right
-	ZrotationDegrees = 0.0f; // z = lean left/right
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(-1.6f, 3.75f, 2.5f); // right , downward , forward
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderColor(0.0, 0.0, 0.0, 1.0); // BLACK
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawPlaneMesh();
-
-	// iMAC (keyboard key #3)
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(0.2f, 0.3f, 0.2f); // wide , tall , deep
-
-	XrotationDegrees = 0.0f; // x = tilt forward/backward
-	YrotationDegrees = 0.0f; // y = spin left/right
-	ZrotationDegrees = 0.0f; // z = lean left/right
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(-1.6f, 3.55f, 2.5f); // right , downward , forward
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderColor(1.0, 1.0, 1.0, 1.0); // WHITE
-	SetShaderTexture("metallic");
-	SetShaderMaterial("glass");
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawBoxMesh();
-
-	// iMAC (key letter #4)
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(0.03f, 0.03f, 0.03f); // wide , tall , deep
-
-	XrotationDegrees = 0.0f; // x = tilt forward/backward
-	YrotationDegrees = 0.0f; // y = spin left/right
-	ZrotationDegrees = 0.0f; // z = lean left/right
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(-1.2f, 3.75f, 2.5f); // right , downward , forward
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderColor(0.0, 0.0, 0.0, 1.0); // BLACK
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawPlaneMesh();
-
-	// iMAC (keyboard key #4)
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(0.2f, 0.3f, 0.2f); // wide , tall , deep
-
-	XrotationDegrees = 0.0f; // x = tilt forward/backward
-	YrotationDegrees = 0.0f; // y = spin left/right
-	ZrotationDegrees = 0.0f; // z = lean left/right
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(-1.2f, 3.55f, 2.5f); // right , downward , forward
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderColor(1.0, 1.0, 1.0, 1.0); // WHITE
-	SetShaderTexture("metallic");
-	SetShaderMaterial("glass");
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawBoxMesh();
-
-	// iMAC (key letter #5)
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(0.03f, 0.03f, 0.03f); // wide , tall , deep
-
-	XrotationDegrees = 0.0f; // x = tilt forward/backward
-	YrotationDegrees = 0.0f; // y = spin left/right
-	ZrotationDegrees = 0.0f; // z = lean left/right
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(-0.8f, 3.75f, 2.5f); // right , downward , forward
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderColor(0.0, 0.0, 0.0, 1.0); // BLACK
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawPlaneMesh();
-
-	// iMAC (keyboard key #5)
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(0.2f, 0.3f, 0.2f); // wide , tall , deep
-
-	XrotationDegrees = 0.0f; // x = tilt forward/backward
-	YrotationDegrees = 0.0f; // y = spin left/right
-	ZrotationDegrees = 0.0f; // z = lean left/right
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(-0.8f, 3.55f, 2.5f); // right , downward , forward
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderColor(1.0, 1.0, 1.0, 1.0); // WHITE
-	SetShaderTexture("metallic");
-	SetShaderMaterial("glass");
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawBoxMesh();
-
-	// iMAC (key letter #6)
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(0.03f, 0.03f, 0.03f); // wide , tall , deep
-
-	XrotationDegrees = 0.0f; // x = tilt forward/backward
-	YrotationDegrees = 0.0f; // y = spin left/right
-	ZrotationDegrees = 0.0f; // z = lean left/right
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(-0.4f, 3.75f, 2.5f); // right , downward , forward
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderColor(0.0, 0.0, 0.0, 1.0); // BLACK
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawPlaneMesh();
-
-	// iMAC (keyboard key #6)
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(0.2f, 0.3f, 0.2f); // wide , tall , deep
-
-	XrotationDegrees = 0.0f; // x = tilt forward/backward
-	YrotationDegrees = 0.0f; // y = spin left/right
-	ZrotationDegrees = 0.0f; // z = lean left/right
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(-0.4f, 3.55f, 2.5f); // right , downward , forward
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderColor(1.0, 1.0, 1.0, 1.0); // WHITE
-	SetShaderTexture("metallic");
-	SetShaderMaterial("glass");
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawBoxMesh();
-
-	// iMAC (key letter #7)
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(0.03f, 0.03f, 0.03f); // wide , tall , deep
-
-	XrotationDegrees = 0.0f; // x = tilt forward/backward
-	YrotationDegrees = 0.0f; // y = spin left/right
-	ZrotationDegrees = 0.0f; // z = lean left/right
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(0.0f, 3.75f, 2.5f); // right , downward , forward
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderColor(0.0, 0.0, 0.0, 1.0); // BLACK
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawPlaneMesh();
-
-	// iMAC (keyboard key #7)
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(0.2f, 0.3f, 0.2f); // wide , tall , deep
-
-	XrotationDegrees = 0.0f; // x = tilt forward/backward
-	YrotationDegrees = 0.0f; // y = spin left/right
-	ZrotationDegrees = 0.0f; // z = lean left/right
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(0.0f, 3.55f, 2.5f); // right , downward , forward
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderColor(1.0, 1.0, 1.0, 1.0); // WHITE
-	SetShaderTexture("metallic");
-	SetShaderMaterial("glass");
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawBoxMesh();
-
-	// iMAC (key letter #8)
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(0.03f, 0.03f, 0.03f); // wide , tall , deep
-
-	XrotationDegrees = 0.0f; // x = tilt forward/backward
-	YrotationDegrees = 0.0f; // y = spin left/right
-	ZrotationDegrees = 0.0f; // z = lean left/right
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(0.4f, 3.75f, 2.5f); // right , downward , forward
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderColor(0.0, 0.0, 0.0, 1.0); // BLACK
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawPlaneMesh();
-
-	// iMAC (keyboard key #8)
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(0.2f, 0.3f, 0.2f); // wide , tall , deep
-
-	XrotationDegrees = 0.0f; // x = tilt forward/backward
-	YrotationDegrees = 0.0f; // y = spin left/right
-	ZrotationDegrees = 0.0f; // z = lean left/right
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(0.4f, 3.55f, 2.5f); // right , downward , forward
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderColor(1.0, 1.0, 1.0, 1.0); // WHITE
-	SetShaderTexture("metallic");
-	SetShaderMaterial("glass");
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawBoxMesh();
-
-	// iMAC (key letter #9)
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(0.03f, 0.03f, 0.03f); // wide , tall , deep
-
-	XrotationDegrees = 0.0f; // x = tilt forward/backward
-	YrotationDegrees = 0.0f; // y = spin left/right
-	ZrotationDegrees = 0.0f; // z = lean left/right
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(0.8f, 3.75f, 2.5f); // right , downward , forward
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderColor(0.0, 0.0, 0.0, 1.0); // BLACK
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawPlaneMesh();
-
-	// iMAC (keyboard key #9)
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(0.2f, 0.3f, 0.2f); // wide , tall , deep
-
-	XrotationDegrees = 0.0f; // x = tilt forward/backward
-	YrotationDegrees = 0.0f; // y = spin left/right
-	ZrotationDegrees = 0.0f; // z = lean left/right
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(0.8f, 3.55f, 2.5f); // right , downward , forward
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderColor(1.0, 1.0, 1.0, 1.0); // WHITE
-	SetShaderTexture("metallic");
-	SetShaderMaterial("glass");
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawBoxMesh();
-
-	// iMAC (key letter #10)
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(0.03f, 0.03f, 0.03f); // wide , tall , deep
-
-	XrotationDegrees = 0.0f; // x = tilt forward/backward
-	YrotationDegrees = 0.0f; // y = spin left/right
-	ZrotationDegrees = 0.0f; // z = lean left/right
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(1.2f, 3.75f, 2.5f); // right , downward , forward
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderColor(0.0, 0.0, 0.0, 1.0); // BLACK
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawPlaneMesh();
-
-	// iMAC (keyboard key #10)
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(0.2f, 0.3f, 0.2f); // wide , tall , deep
-
-	XrotationDegrees = 0.0f; // x = tilt forward/backward
-	YrotationDegrees = 0.0f; // y = spin left/right
-	ZrotationDegrees = 0.0f; // z = lean left/right
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(1.2f, 3.55f, 2.5f); // right , downward , forward
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderColor(1.0, 1.0, 1.0, 1.0); // WHITE
-	SetShaderTexture("metallic");
-	SetShaderMaterial("glass");
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawBoxMesh();
-
-	// iMAC (keyboard spacebar)
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(3.8f, 0.3f, 0.2f); // wide , tall , deep
-
-	XrotationDegrees = 0.0f; // x = tilt forward/backward
-	YrotationDegrees = 0.0f; // y = spin left/right
-	ZrotationDegrees = 0.0f; // z = lean left/right
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(-0.60f, 3.55f, 2.9f); // right , downward , forward
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderColor(1.0, 1.0, 1.0, 1.0); // WHITE
-	SetShaderTexture("metallic");
-	SetShaderMaterial("glass");
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawBoxMesh();
-
-	// iMAC (keyboard spacebar)
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(1.0f, 0.3f, 0.2f); // wide , tall , deep
-
-	XrotationDegrees = 0.0f; // x = tilt forward/backward
-	YrotationDegrees = 0.0f; // y = spin left/right
-	ZrotationDegrees = 0.0f; // z = lean left/right
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(2.4f, 3.55f, 2.9f); // right , downward , forward
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderColor(1.0, 1.0, 1.0, 1.0); // WHITE
-	SetShaderTexture("metallic");
-	SetShaderMaterial("glass");
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawBoxMesh();
-
-	/******************************************************************/
-
-	// KEYBOARD ROW #1 NUMBERS
-
-	/******************************************************************/
-
-	// iMAC (key number #1)
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(0.03f, 0.03f, 0.03f); // wide , tall , deep
-
-	XrotationDegrees = 0.0f; // x = tilt forward/backward
-	YrotationDegrees = 0.0f; // y = spin left/right
-	ZrotationDegrees = 0.0f; // z = lean left/right
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(2.0f, 3.75f, 1.5f); // right , downward , forward
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderColor(0.0, 0.0, 0.0, 1.0); // BLACK
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawPlaneMesh();
-
-	// iMAC (keyboard number #1)
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(0.2f, 0.3f, 0.2f); // wide , tall , deep
-
-	XrotationDegrees = 0.0f; // x = tilt forward/backward
-	YrotationDegrees = 0.0f; // y = spin left/right
-	ZrotationDegrees = 0.0f; // z = lean left/right
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(2.0f, 3.55f, 1.5f); // right , downward , forward
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderColor(1.0, 1.0, 1.0, 1.0); // WHITE
-	SetShaderTexture("metallic");
-	SetShaderMaterial("glass");
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawBoxMesh();
-
-	// iMAC (key number #2)
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(0.03f, 0.03f, 0.03f); // wide , tall , deep
-
-	XrotationDegrees = 0.0f; // x = tilt forward/backward
-	YrotationDegrees = 0.0f; // y = spin left/right
-	ZrotationDegrees = 0.0f; // z = lean left/right
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(2.4f, 3.75f, 1.5f); // right , downward , forward
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderColor(0.0, 0.0, 0.0, 1.0); // BLACK
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawPlaneMesh();
-
-	// iMAC (keyboard number #2)
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(0.2f, 0.3f, 0.2f); // wide , tall , deep
-
-	XrotationDegrees = 0.0f; // x = tilt forward/backward
-	YrotationDegrees = 0.0f; // y = spin left/right
-	ZrotationDegrees = 0.0f; // z = lean left/right
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(2.4f, 3.55f, 1.5f); // right , downward , forward
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderColor(1.0, 1.0, 1.0, 1.0); // WHITE
-	SetShaderTexture("metallic");
-	SetShaderMaterial("glass");
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawBoxMesh();
-
-	// iMAC (key number #3)
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(0.03f, 0.03f, 0.03f); // wide , tall , deep
-
-	XrotationDegrees = 0.0f; // x = tilt forward/backward
-	YrotationDegrees = 0.0f; // y = spin left/right
-	ZrotationDegrees = 0.0f; // z = lean left/right
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(2.8f, 3.75f, 1.5f); // right , downward , forward
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderColor(0.0, 0.0, 0.0, 1.0); // BLACK
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawPlaneMesh();
-
-	// iMAC (keyboard number #3)
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(0.2f, 0.3f, 0.2f); // wide , tall , deep
-
-	XrotationDegrees = 0.0f; // x = tilt forward/backward
-	YrotationDegrees = 0.0f; // y = spin left/right
-	ZrotationDegrees = 0.0f; // z = lean left/right
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(2.8f, 3.55f, 1.5f); // right , downward , forward
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderColor(1.0, 1.0, 1.0, 1.0); // WHITE
-	SetShaderTexture("metallic");
-	SetShaderMaterial("glass");
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawBoxMesh();
-
-	// iMAC (key letter #1)
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(0.03f, 0.03f, 0.03f); // wide , tall , deep
-
-	XrotationDegrees = 0.0f; // x = tilt forward/backward
-	YrotationDegrees = 0.0f; // y = spin left/right
-	ZrotationDegrees = 0.0f; // z = lean left/right
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(2.8f, 3.75f, 2.0f); // right , downward , forward
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderColor(0.0, 0.0, 0.0, 1.0); // BLACK
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawPlaneMesh();
-
-	/******************************************************************/
-
-	// KEYBOARD ROW #2 NUMBERS
-
-	/******************************************************************/
-
-	// iMAC (key letter #1)
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(0.03f, 0.03f, 0.03f); // wide , tall , deep
-
-	XrotationDegrees = 0.0f; // x = tilt forward/backward
-	YrotationDegrees = 0.0f; // y = spin left/right
-	ZrotationDegrees = 0.0f; // z = lean left/right
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(2.0f, 3.75f, 2.0f); // right , downward , forward
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderColor(0.0, 0.0, 0.0, 1.0); // BLACK
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawPlaneMesh();
-
-	// iMAC (keyboard key #1)
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(0.2f, 0.3f, 0.2f); // wide , tall , deep
-
-	XrotationDegrees = 0.0f; // x = tilt forward/backward
-	YrotationDegrees = 0.0f; // y = spin left/right
-	ZrotationDegrees = 0.0f; // z = lean left/right
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(2.0f, 3.55f, 2.0f); // right , downward , forward
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderColor(1.0, 1.0, 1.0, 1.0); // WHITE
-	SetShaderTexture("metallic");
-	SetShaderMaterial("glass");
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawBoxMesh();
-
-	// iMAC (key letter #2)
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(0.03f, 0.03f, 0.03f); // wide , tall , deep
-
-	XrotationDegrees = 0.0f; // x = tilt forward/backward
-	YrotationDegrees = 0.0f; // y = spin left/right
-	ZrotationDegrees = 0.0f; // z = lean left/right
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(2.4f, 3.75f, 2.0f); // right , downward , forward
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderColor(0.0, 0.0, 0.0, 1.0); // BLACK
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawPlaneMesh();
-
-	// iMAC (keyboard key #2)
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(0.2f, 0.3f, 0.2f); // wide , tall , deep
-
-	XrotationDegrees = 0.0f; // x = tilt forward/backward
-	YrotationDegrees = 0.0f; // y = spin left/right
-	ZrotationDegrees = 0.0f; // z = lean left/right
+	// the cache is only valid for the same static objects
+	uint32_t objectsHash = StaticGeometry::HashObjects(bakeObjects);
+	if ((g_UseBakedCache == false) ||
+		(staticGeometry.ReadCache(g_BakedCacheFile, objectsHash,
+			m_textureArrays.GetTextureCount(), std::min((int)m_objectMaterials.size(), g_MaxMaterials)) == false))
+	{
+		staticGeometry.Bake(*m_meshArena, bakeObjects);
+		if ((g_UseBakedCache == true) &&
+			(staticGeometry.WriteCache(g_BakedCacheFile, objectsHash) == false))
+		{
+			std::cout << "Could not write baked geometry cache:" << g_BakedCacheFile << std::endl;
+		}
+	}
 
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(2.4f, 3.55f, 2.0f); // right , downward , forward
+	// the culling boxes of the baked meshes follow the ones
+	// of the scene objects
+	const std::vector<StaticGeometry::BAKED_MESH>& meshes = staticGeometry.GetMeshes();
+	m_frustumCuller.Resize((int)(m_sceneObjects.size() + meshes.size()));
 
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
+	for (const StaticGeometry::BAKED_MESH& mesh : meshes)
+	{
+		BAKED_DRAW draw;
+		draw.meshID = m_meshArena->AddMesh(mesh.vertices, mesh.indices);
+		draw.textureID = mesh.textureID;
+		draw.materialID = mesh.materialID;
+		draw.color = mesh.color;
+		draw.bTransparent = IsTransparent(mesh.textureID, mesh.color);
+
+		// the baked vertices are in world space already
+		glm::vec3 boundsMin(0.0f);
+		glm::vec3 boundsMax(0.0f);
+		for (size_t v = 0; v + MeshArena::VERTEX_STRIDE <= mesh.vertices.size(); v += MeshArena::VERTEX_STRIDE)
+		{
+			glm::vec3 position(mesh.vertices[v], mesh.vertices[v + 1], mesh.vertices[v + 2]);
+			boundsMin = (v == 0) ? position : glm::min(boundsMin, position);
+			boundsMax = (v == 0) ? position : glm::max(boundsMax, position);
+		}
+		draw.boundsCenter = (boundsMin + boundsMax) * 0.5f;
+		draw.boundsExtents = (boundsMax - boundsMin) * 0.5f;
+		SetCullingBounds((int)(m_sceneObjects.size() + m_bakedDraws.size()), draw.boundsCenter, draw.boundsExtents);
 
-	SetShaderColor(1.0, 1.0, 1.0, 1.0); // WHITE
-	SetShaderTexture("metallic");
-	SetShaderMaterial("glass");
+		m_bakedDraws.push_back(draw);
+	}
 
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawBoxMesh();
+	for (SCENE_OBJECT& object : m_sceneObjects)
+	{
+		object.bBaked = object.bStatic;
+	}
+	for (SCENE_NODE& node : m_sceneNodes)
+	{
+		node.bBaked = node.bStatic;
+	}
+}
 
-	// iMAC (key letter #3)
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(0.03f, 0.03f, 0.03f); // wide , tall , deep
+/***********************************************************
+ *  BuildInstanceBatches()
+ *
+ *  This method is used for grouping the box and plane
+ *  objects that share the same texture, material and UV
+ *  scale into instance batches.  Each batch is drawn with
+ *  one instanced draw call, the objects in it can differ
+ *  in their transformations and color.
+ ***********************************************************/
+void SceneManager::BuildInstanceBatches()
+{
+	std::vector<INSTANCE_BATCH> batches;
 
-	XrotationDegrees = 0.0f; // x = tilt forward/backward
-	YrotationDegrees = 0.0f; // y = spin left/right
-	ZrotationDegrees = 0.0f; // z = lean left/right
+	m_instanceBatches.clear();
 
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(2.8f, 3.75f, 2.0f); // right , downward , forward
+	for (int index = 0; index < (int)m_sceneObjects.size(); index++)
+	{
+		const SCENE_OBJECT& object = m_sceneObjects[index];
+		if (((object.meshID != MESH_BOX) && (object.meshID != MESH_PLANE)) ||
+			(object.bBaked == true))
+		{
+			continue;
+		}
 
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
+		// find the batch that matches the object state
+		size_t batch = 0;
+		while ((batch < batches.size()) &&
+			((batches[batch].meshID != object.meshID) ||
+			(batches[batch].textureID != object.textureID) ||
+			(batches[batch].materialID != object.materialID) ||
+			(batches[batch].bTransparent != object.bTransparent) ||
+			((object.textureID >= 0) && (batches[batch].uvScale != object.uvScale))))
+		{
+			batch++;
+		}
 
-	SetShaderColor(0.0, 0.0, 0.0, 1.0); // BLACK
+		if (batch == batches.size())
+		{
+			INSTANCE_BATCH newBatch;
+			newBatch.meshID = object.meshID;
+			newBatch.textureID = object.textureID;
+			newBatch.materialID = object.materialID;
+			newBatch.uvScale = object.uvScale;
+			newBatch.bTransparent = object.bTransparent;
+			newBatch.instancesID = -1;
+			newBatch.bDirty = true;
+			batches.push_back(newBatch);
+		}
+		batches[batch].objectIndices.push_back(index);
+	}
 
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawPlaneMesh();
-
-	// iMAC (keyboard key #3)
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(0.2f, 0.3f, 0.2f); // wide , tall , deep
+	// only the batches with enough objects are worth drawing
+	// instanced, the others stay as single draw calls
+	for (INSTANCE_BATCH& batch : batches)
+	{
+		if ((int)batch.objectIndices.size() < g_MinInstanceCount)
+		{
+			continue;
+		}
 
-	XrotationDegrees = 0.0f; // x = tilt forward/backward
-	YrotationDegrees = 0.0f; // y = spin left/right
-	ZrotationDegrees = 0.0f; // z = lean left/right
+		int batchID = (int)m_instanceBatches.size();
+		for (int index : batch.objectIndices)
+		{
+			m_sceneObjects[index].batchID = batchID;
+		}
 
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(2.8f, 3.55f, 2.0f); // right , downward , forward
+		// multi-draw reads the instances from the per-draw data
+		if (m_bUseMultiDraw == true)
+		{
+			batch.instancesID = -1;
+		}
+		else if (batch.meshID == MESH_BOX)
+		{
+			batch.instancesID = m_instancedMeshes->CreateBoxInstances((int)batch.objectIndices.size());
+		}
+		else
+		{
+			batch.instancesID = m_instancedMeshes->CreatePlaneInstances((int)batch.objectIndices.size());
+		}
 
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
+		m_instanceBatches.push_back(batch);
+	}
+}
 
-	SetShaderColor(1.0, 1.0, 1.0, 1.0); // WHITE
-	SetShaderTexture("metallic");
-	SetShaderMaterial("glass");
+/***********************************************************
+ *  UpdateInstanceBatches()
+ *
+ *  This method is used for uploading the instance data of
+ *  the batches whose objects changed since the last frame.
+ ***********************************************************/
+void SceneManager::UpdateInstanceBatches()
+{
+	for (INSTANCE_BATCH& batch : m_instanceBatches)
+	{
+		if ((batch.bDirty == false) || (batch.instancesID < 0))
+		{
+			continue;
+		}
 
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawBoxMesh();
+		// the data is uploaded right away, so it only has to
+		// live for the frame
+		const int instanceCount = (int)batch.objectIndices.size();
+		InstancedMeshes::INSTANCE_DATA* instances =
+			m_frameArena.AllocateArray<InstancedMeshes::INSTANCE_DATA>(JobSystem::GetWorkerIndex(), instanceCount);
+		for (int i = 0; i < instanceCount; i++)
+		{
+			const SCENE_OBJECT& object = m_sceneObjects[batch.objectIndices[i]];
+			instances[i].model = object.modelMatrix;
+			instances[i].color = object.color;
+		}
+		m_instancedMeshes->UpdateInstances(batch.instancesID, instances, instanceCount);
+		batch.bDirty = false;
+	}
+}
 
-	/******************************************************************/
-
-	// KEYBOARD ROW #3 NUMBERS
+/***********************************************************
+ *  DrawMesh()
+ *
+ *  This method is used for drawing the basic shape mesh
+ *  associated with the passed in mesh ID.
+ ***********************************************************/
+void SceneManager::DrawMesh(int meshID)
+{
+	switch (meshID)
+	{
+	case MESH_BOX:
+		m_basicMeshes->DrawBoxMesh();
+		break;
+	case MESH_PLANE:
+		m_basicMeshes->DrawPlaneMesh();
+		break;
+	case MESH_CYLINDER:
+		m_basicMeshes->DrawCylinderMesh();
+		break;
+	case MESH_CONE:
+		m_basicMeshes->DrawConeMesh();
+		break;
+	case MESH_PRISM:
+		m_basicMeshes->DrawPrismMesh();
+		break;
+	case MESH_PYRAMID4:
+		m_basicMeshes->DrawPyramid4Mesh();
+		break;
+	case MESH_SPHERE:
+		m_basicMeshes->DrawSphereMesh();
+		break;
+	case MESH_TAPERED_CYLINDER:
+		m_basicMeshes->DrawTaperedCylinderMesh();
+		break;
+	case MESH_TORUS:
+		m_basicMeshes->DrawTorusMesh();
+		break;
+	}
+}
 
-	/******************************************************************/
+/***********************************************************
+ *  QueueSceneObjects()
+ *
+ *  This method is used for adding a draw packet for every
+ *  scene object and instance batch into the render queue.
+ *  Opaque packets are sorted by state and then front to
+ *  back, so the depth test rejects more of the hidden
+ *  pixels.  Transparent packets come after them and are
+ *  sorted back to front only, so they blend over what is
+ *  behind them.  The scene objects are recorded as jobs of
+ *  a range each, and their lists are appended in range order
+ *  so the queue is the one a single thread would record.
+ ***********************************************************/
+void SceneManager::QueueSceneObjects()
+{
+	const int objectCount = (int)m_sceneObjects.size();
+	const int listCount = (objectCount + g_RecordGrain - 1) / g_RecordGrain;
 
-	// iMAC (key letter #1)
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(0.03f, 0.03f, 0.03f); // wide , tall , deep
+	m_renderQueue.Clear();
+	if ((int)m_recordLists.size() < listCount)
+	{
+		m_recordLists.resize(listCount);
+	}
 
-	XrotationDegrees = 0.0f; // x = tilt forward/backward
-	YrotationDegrees = 0.0f; // y = spin left/right
-	ZrotationDegrees = 0.0f; // z = lean left/right
+	m_jobSystem.ParallelFor(objectCount, g_RecordGrain, [this](int firstObject, int lastObject)
+	{
+		RecordObjectPackets(firstObject, lastObject, m_recordLists[firstObject / g_RecordGrain]);
+	});
 
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(2.0f, 3.75f, 2.5f); // right , downward , forward
+	for (int listIndex = 0; listIndex < listCount; listIndex++)
+	{
+		const RECORD_LIST& list = m_recordLists[listIndex];
+		m_renderQueue.Append(list.packets.data(), (int)list.packets.size());
+		m_frameStats.objectsVisible += list.stats.objectsVisible;
+		m_frameStats.objectsCulled += list.stats.objectsCulled;
+		m_frameStats.transparentDraws += list.stats.transparentDraws;
+		m_frameStats.objectsReduced += list.stats.objectsReduced;
+	}
 
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderColor(0.0, 0.0, 0.0, 1.0); // BLACK
+	// instanced draws use their own vertex arrays, so they
+	// are keyed as meshes of their own after the basic ones
+	for (int batchID = 0; batchID < (int)m_instanceBatches.size(); batchID++)
+	{
+		const INSTANCE_BATCH& batch = m_instanceBatches[batchID];
+		int meshKey = (m_bUseMultiDraw == true) ? 0 : MESH_COUNT + batch.meshID;
+
+		// a batch is drawn when any of its objects is visible,
+		// multi-draw leaves the culled objects out of its
+		// instances - it is sorted by its nearest object
+		int visibleCount = 0;
+		uint32_t depth = g_MaxSortDepth;
+		for (int index : batch.objectIndices)
+		{
+			if (IsBoundsVisible(index) == true)
+			{
+				visibleCount++;
+				depth = std::min(depth, GetSortDepth(glm::vec3(m_sceneObjects[index].boundingSphere)));
+			}
+		}
+		m_frameStats.objectsVisible += visibleCount;
+		m_frameStats.objectsCulled += (int)batch.objectIndices.size() - visibleCount;
+		if (visibleCount == 0)
+		{
+			continue;
+		}
 
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawPlaneMesh();
+		if (batch.bTransparent == true)
+		{
+			m_renderQueue.Add(
+				RenderQueue::MakeDepthSortKey(g_TransparentPass, g_MaxSortDepth - depth),
+				g_BatchPayloadFlag | (uint32_t)batchID,
+				RenderQueue::MakeSortKey(g_TransparentPass, 0, meshKey, GetTextureKey(batch.textureID), batch.materialID));
+			m_frameStats.transparentDraws++;
+		}
+		else
+		{
+			m_renderQueue.Add(
+				RenderQueue::MakeSortKey(g_OpaquePass, 0, meshKey, GetTextureKey(batch.textureID), batch.materialID, depth),
+				g_BatchPayloadFlag | (uint32_t)batchID);
+		}
+	}
 
-	// iMAC (keyboard key #1)
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(0.2f, 0.3f, 0.2f); // wide , tall , deep
+	// baked meshes are only drawn with multi-draw, where the
+	// mesh is not part of the key
+	for (int bakedID = 0; bakedID < (int)m_bakedDraws.size(); bakedID++)
+	{
+		const BAKED_DRAW& baked = m_bakedDraws[bakedID];
 
-	XrotationDegrees = 0.0f; // x = tilt forward/backward
-	YrotationDegrees = 0.0f; // y = spin left/right
-	ZrotationDegrees = 0.0f; // z = lean left/right
+		if (IsBoundsVisible((int)m_sceneObjects.size() + bakedID) == false)
+		{
+			m_frameStats.objectsCulled++;
+			continue;
+		}
+		m_frameStats.objectsVisible++;
 
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(2.0f, 3.55f, 2.5f); // right , downward , forward
+		glm::vec3 center;
+		glm::vec3 extents;
+		m_frustumCuller.GetBounds((int)m_sceneObjects.size() + bakedID, center, extents);
+		const uint32_t depth = GetSortDepth(center);
 
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
+		if (baked.bTransparent == true)
+		{
+			m_renderQueue.Add(
+				RenderQueue::MakeDepthSortKey(g_TransparentPass, g_MaxSortDepth - depth),
+				g_BakedPayloadFlag | (uint32_t)bakedID,
+				RenderQueue::MakeSortKey(g_TransparentPass, 0, 0, GetTextureKey(baked.textureID), baked.materialID));
+			m_frameStats.transparentDraws++;
+		}
+		else
+		{
+			m_renderQueue.Add(
+				RenderQueue::MakeSortKey(g_OpaquePass, 0, 0, GetTextureKey(baked.textureID), baked.materialID, depth),
+				g_BakedPayloadFlag | (uint32_t)bakedID);
+		}
+	}
+}
 
-	SetShaderColor(1.0, 1.0, 1.0, 1.0); // WHITE
-	SetShaderTexture("metallic");
-	SetShaderMaterial("glass");
+/***********************************************************
+ *  RecordObjectPackets()
+ *
+ *  This method is used for recording the draw packets of a
+ *  range of scene objects into a list of its own, and picking
+ *  the tessellation level of the visible objects when they
+ *  are drawn with multi-draw.  Only the objects of the range
+ *  are written, so the ranges can be recorded together.
+ ***********************************************************/
+void SceneManager::RecordObjectPackets(int firstObject, int lastObject, RECORD_LIST& list)
+{
+	list.packets.clear();
+	list.stats = FRAME_STATS();
 
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawBoxMesh();
+	for (int index = firstObject; index < lastObject; index++)
+	{
+		SCENE_OBJECT& object = m_sceneObjects[index];
 
-	// iMAC (key letter #2)
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(0.03f, 0.03f, 0.03f); // wide , tall , deep
+		// objects in an instance batch or a baked mesh are
+		// drawn by the batch or the mesh
+		if ((object.batchID >= 0) || (object.bBaked == true))
+		{
+			continue;
+		}
+		if (IsBoundsVisible(index) == false)
+		{
+			list.stats.objectsCulled++;
+			continue;
+		}
+		list.stats.objectsVisible++;
 
-	XrotationDegrees = 0.0f; // x = tilt forward/backward
-	YrotationDegrees = 0.0f; // y = spin left/right
-	ZrotationDegrees = 0.0f; // z = lean left/right
+		// the coarser levels only live in the mesh arena
+		if (m_bUseMultiDraw == true)
+		{
+			object.lodLevel = SelectLevelOfDetail(object);
+			list.stats.objectsReduced += (object.lodLevel > 0) ? 1 : 0;
+		}
 
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(2.4f, 3.75f, 2.5f); // right , downward , forward
+		// every mesh shares one vertex array with multi-draw,
+		// so only the texture array splits the packets into
+		// calls
+		int meshKey = (m_bUseMultiDraw == true) ? 0 : object.meshID;
+		const uint32_t depth = GetSortDepth(glm::vec3(object.boundingSphere));
 
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderColor(0.0, 0.0, 0.0, 1.0); // BLACK
+		RenderQueue::DRAW_PACKET packet;
+		packet.payload = (uint32_t)index;
+		if (object.bTransparent == true)
+		{
+			packet.sortKey = RenderQueue::MakeDepthSortKey(g_TransparentPass, g_MaxSortDepth - depth);
+			packet.stateKey = RenderQueue::MakeSortKey(g_TransparentPass, 0, meshKey, GetTextureKey(object.textureID), object.materialID);
+			list.stats.transparentDraws++;
+		}
+		else
+		{
+			packet.sortKey = RenderQueue::MakeSortKey(g_OpaquePass, 0, meshKey, GetTextureKey(object.textureID), object.materialID, depth);
+			packet.stateKey = packet.sortKey;
+		}
+		list.packets.push_back(packet);
+	}
+}
 
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawPlaneMesh();
-
-	// iMAC (keyboard key #2)
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(0.2f, 0.3f, 0.2f); // wide , tall , deep
+/***********************************************************
+ *  IsTransparent()
+ *
+ *  This method is used for checking if a draw with the
+ *  passed in state is see-through.  Textured draws take
+ *  their alpha from the texture, the others from the alpha
+ *  of their color.  The material does not make a draw
+ *  see-through, it only changes the lighting.
+ ***********************************************************/
+bool SceneManager::IsTransparent(int textureID, const glm::vec4& color) const
+{
+	if (textureID >= 0)
+	{
+		return(m_textureArrays.IsTranslucent(textureID));
+	}
 
-	XrotationDegrees = 0.0f; // x = tilt forward/backward
-	YrotationDegrees = 0.0f; // y = spin left/right
-	ZrotationDegrees = 0.0f; // z = lean left/right
+	return(color.a < 1.0f);
+}
 
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(2.4f, 3.55f, 2.5f); // right , downward , forward
+/***********************************************************
+ *  GetSortDepth()
+ *
+ *  This method is used for getting the depth of a point
+ *  as seen by the camera, scaled to the depth field of the
+ *  sort keys.  The projected depth is used, so it follows
+ *  the view direction for both projections.
+ ***********************************************************/
+uint32_t SceneManager::GetSortDepth(const glm::vec3& position) const
+{
+	const glm::vec4 clip = m_viewProjection * glm::vec4(position, 1.0f);
+	if (clip.w <= 0.0f)
+	{
+		return(0);
+	}
 
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
+	const float depth = glm::clamp(clip.z / clip.w * 0.5f + 0.5f, 0.0f, 1.0f);
+	return((uint32_t)(depth * (float)g_MaxSortDepth));
+}
 
-	SetShaderColor(1.0, 1.0, 1.0, 1.0); // WHITE
-	SetShaderTexture("metallic");
-	SetShaderMaterial("glass");
+/***********************************************************
+ *  SetPassState()
+ *
+ *  This method is used for setting the GL state a render
+ *  pass is drawn with.  Only the transparent pass blends,
+ *  and it keeps the depth of the opaque objects without
+ *  writing its own, so blended objects never hide each
+ *  other.  After a depth pre-pass the opaque pass only
+ *  shades the fragments whose depth is the one laid down.
+ ***********************************************************/
+void SceneManager::SetPassState(int pass)
+{
+	const bool bPrepassDepth = (pass == g_OpaquePass) && (IsDepthPrepassActive() == true);
 
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawBoxMesh();
+	m_pRenderState->SetBlending(pass == g_TransparentPass);
+	m_pRenderState->SetDepthWrite((pass != g_TransparentPass) && (bPrepassDepth == false));
+	m_pRenderState->SetDepthFunc((bPrepassDepth == true) ? GL_EQUAL : GL_LESS);
+}
 
-	// iMAC (key letter #3)
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(0.03f, 0.03f, 0.03f); // wide , tall , deep
+/***********************************************************
+ *  SubmitRenderQueue()
+ *
+ *  This method is used for drawing the packets in the render
+ *  queue in their sorted order.  The texture, UV scale,
+ *  material and instancing state is only passed into the
+ *  shader when it differs from the previous packet.
+ ***********************************************************/
+void SceneManager::SubmitRenderQueue()
+{
+	// the state is unknown at the start of the frame
+	bool bFirstPacket = true;
+	bool bInstancing = false;
+	int currentPass = g_OpaquePass;
+	int currentTextureID = -1;
+	int currentMaterialID = -1;
+	glm::vec2 currentUVScale;
+
+	for (const RenderQueue::DRAW_PACKET& packet : m_renderQueue.GetPackets())
+	{
+		const bool bBatch = (packet.payload & g_BatchPayloadFlag) != 0;
+		const uint32_t index = packet.payload & g_PayloadIndexMask;
+		const int pass = RenderQueue::GetPass(packet.sortKey);
 
-	XrotationDegrees = 0.0f; // x = tilt forward/backward
-	YrotationDegrees = 0.0f; // y = spin left/right
-	ZrotationDegrees = 0.0f; // z = lean left/right
+		if ((bFirstPacket == true) || (pass != currentPass))
+		{
+			SetPassState(pass);
+			currentPass = pass;
+		}
 
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(2.8f, 3.75f, 2.5f); // right , downward , forward
+		int textureID;
+		int materialID;
+		glm::vec2 uvScale;
+		const SCENE_OBJECT* pObject = NULL;
 
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
+		if (bBatch == true)
+		{
+			const INSTANCE_BATCH& batch = m_instanceBatches[index];
+			textureID = batch.textureID;
+			materialID = batch.materialID;
+			uvScale = batch.uvScale;
+		}
+		else
+		{
+			pObject = &m_sceneObjects[index];
+			textureID = pObject->textureID;
+			materialID = pObject->materialID;
+			uvScale = pObject->uvScale;
+		}
 
-	SetShaderColor(0.0, 0.0, 0.0, 1.0); // BLACK
+		if ((bFirstPacket == true) || (bInstancing != bBatch))
+		{
+			m_pShaderUniforms->setBoolValue(m_shaderHandles.useInstancing, bBatch);
+			bInstancing = bBatch;
+		}
 
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawPlaneMesh();
+		if (textureID >= 0)
+		{
+			if ((bFirstPacket == true) || (textureID != currentTextureID))
+			{
+				SetShaderTextureSlot(textureID);
+			}
+			if ((bFirstPacket == true) || (currentTextureID < 0) || (uvScale != currentUVScale))
+			{
+				SetTextureUVScale(uvScale.x, uvScale.y);
+				currentUVScale = uvScale;
+			}
+		}
+		else if (pObject != NULL)
+		{
+			// the color changes from object to object
+			SetShaderColor(
+				pObject->color.r,
+				pObject->color.g,
+				pObject->color.b,
+				pObject->color.a);
+		}
+		else if ((bFirstPacket == true) || (currentTextureID >= 0))
+		{
+			// instanced colors come from the instance data
+			m_pShaderUniforms->setIntValue(m_shaderHandles.useTexture, false);
+		}
+		currentTextureID = textureID;
 
-	// iMAC (keyboard key #3)
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(0.2f, 0.3f, 0.2f); // wide , tall , deep
+		if ((materialID >= 0) && ((bFirstPacket == true) || (materialID != currentMaterialID)))
+		{
+			SetShaderMaterialID(materialID);
+			currentMaterialID = materialID;
+		}
 
-	XrotationDegrees = 0.0f; // x = tilt forward/backward
-	YrotationDegrees = 0.0f; // y = spin left/right
-	ZrotationDegrees = 0.0f; // z = lean left/right
+		if (bBatch == true)
+		{
+			m_instancedMeshes->DrawMeshInstanced(m_instanceBatches[index].instancesID);
+		}
+		else
+		{
+			SetModelMatrix(pObject->modelMatrix);
+			DrawMesh(pObject->meshID);
+		}
+		m_frameStats.drawCalls++;
 
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(2.8f, 3.55f, 2.5f); // right , downward , forward
+		bFirstPacket = false;
+	}
 
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
+	// the basic shape meshes are drawn without instancing
+	if (bInstancing == true)
+	{
+		m_pShaderUniforms->setBoolValue(m_shaderHandles.useInstancing, false);
+	}
+}
 
-	SetShaderColor(1.0, 1.0, 1.0, 1.0); // WHITE
-	SetShaderTexture("metallic");
-	SetShaderMaterial("glass");
+/***********************************************************
+ *  SelectLevelOfDetail()
+ *
+ *  This method is used for picking the tessellation level
+ *  of a visible object.  The level follows the fraction of
+ *  the screen height its bounding sphere covers, and only
+ *  changes once the size is well past a threshold.  Shapes
+ *  without coarser levels keep the finest one.
+ ***********************************************************/
+int SceneManager::SelectLevelOfDetail(const SCENE_OBJECT& object) const
+{
+	if (m_meshArena->HasLods(object.meshID) == false)
+	{
+		return(object.lodLevel);
+	}
 
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawBoxMesh();
+	// distance of a point along the view direction is its w
+	const glm::vec4 depthRow(m_viewProjection[0][3], m_viewProjection[1][3], m_viewProjection[2][3], m_viewProjection[3][3]);
+	const float radius = object.boundingSphere.w;
+	const float distance = glm::dot(glm::vec3(depthRow), glm::vec3(object.boundingSphere)) + depthRow.w;
 
-	// iMAC (iMac keyboard)
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(3.0f, 0.1f, 1.0f); // wide , tall , deep
+	// the camera is inside the sphere
+	if (distance <= radius)
+	{
+		return(0);
+	}
 
-	XrotationDegrees = 0.0f; // x = tilt forward/backward
-	YrotationDegrees = 0.0f; // y = spin left/right
-	ZrotationDegrees = 0.0f; // z = lean left/right
+	const float screenSize = radius * m_projectionScale / distance;
+	int lodLevel = object.lodLevel;
+	while ((lodLevel > 0) && (screenSize > g_LodScreenSizes[lodLevel - 1] * (1.0f + g_LodHysteresis)))
+	{
+		lodLevel--;
+	}
+	while ((lodLevel < MeshArena::LOD_COUNT - 1) && (screenSize < g_LodScreenSizes[lodLevel] * (1.0f - g_LodHysteresis)))
+	{
+		lodLevel++;
+	}
 
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(0.1f, 3.55f, 2.2f); // right , downward , forward
+	return(lodLevel);
+}
 
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
+/***********************************************************
+ *  IsBoundsVisible()
+ *
+ *  This method is used for checking if a culling box, of a
+ *  scene object or of a baked mesh after the objects, is
+ *  inside the view frustum of the frame.
+ ***********************************************************/
+bool SceneManager::IsBoundsVisible(int boundsIndex) const
+{
+	if ((boundsIndex < (int)m_occluded.size()) && (m_occluded[boundsIndex] != 0))
+	{
+		return(false);
+	}
+	return((g_UseFrustumCulling == false) || (m_frustumCuller.IsVisible(boundsIndex) == true));
+}
 
-	//SetShaderColor(0.7, 0.7, 0.7, 1.0); // LIGHT GREY
+/***********************************************************
+ *  CullOccludedObjects()
+ *
+ *  This method is used for drawing the occluder objects in
+ *  the view into the occlusion depth buffer, and hiding the
+ *  culling boxes that passed the frustum test but are behind
+ *  them.  Only boxes and planes are drawn as occluders, the
+ *  other shapes do not fill their bounds.  The tiles and the
+ *  box tests run as jobs.
+ ***********************************************************/
+void SceneManager::CullOccludedObjects()
+{
+	const int boundsCount = m_frustumCuller.GetCount();
 
-	SetShaderTexture("metallic");
-	SetShaderMaterial("cement");
-	//SetTextureUVScale(1.0, 1.0);
+	// the frustum result alone decides the occluders
+	m_occluded.assign(boundsCount, 0);
 
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawPlaneMesh();
+	m_occlusionCuller.BeginFrame(m_viewProjection, m_frameArena);
+	for (int index = 0; index < (int)m_sceneObjects.size(); index++)
+	{
+		const SCENE_OBJECT& object = m_sceneObjects[index];
+		// see-through objects hide nothing
+		if ((object.bOccluder == false) || (object.bTransparent == true) ||
+			(IsBoundsVisible(index) == false))
+		{
+			continue;
+		}
 
+		if (object.meshID == MESH_BOX)
+		{
+			m_occlusionCuller.AddBoxOccluder(object.modelMatrix);
+		}
+		else if (object.meshID == MESH_PLANE)
+		{
+			m_occlusionCuller.AddPlaneOccluder(object.modelMatrix);
+		}
+	}
+	if (m_occlusionCuller.GetTriangleCount() == 0)
+	{
+		return;
+	}
+	m_occlusionCuller.Rasterize(&m_jobSystem);
 
+	// every job only marks the boxes of its range
+	std::atomic<int> occludedCount(0);
+	m_jobSystem.ParallelFor(boundsCount, g_OcclusionGrain, [this, &occludedCount](int firstBounds, int lastBounds)
+	{
+		int rangeOccluded = 0;
+		for (int index = firstBounds; index < lastBounds; index++)
+		{
+			// objects in a baked mesh are tested with the mesh
+			if (((index < (int)m_sceneObjects.size()) && (m_sceneObjects[index].bBaked == true)) ||
+				(IsBoundsVisible(index) == false))
+			{
+				continue;
+			}
+
+			glm::vec3 center;
+			glm::vec3 extents;
+			m_frustumCuller.GetBounds(index, center, extents);
+			if (m_occlusionCuller.IsOccluded(center, extents) == true)
+			{
+				m_occluded[index] = 1;
+				rangeOccluded++;
+			}
+		}
+		occludedCount.fetch_add(rangeOccluded);
+	});
+	m_frameStats.objectsOccluded += occludedCount.load();
+}
 
-	/******************************************************************/
+/***********************************************************
+ *  SetCullingBounds()
+ *
+ *  This method is used for setting the world-space box of a
+ *  scene object, which also goes into the object hierarchy,
+ *  or of a baked mesh after the objects.
+ ***********************************************************/
+void SceneManager::SetCullingBounds(int boundsIndex, const glm::vec3& center, const glm::vec3& extents)
+{
+	m_frustumCuller.SetBounds(boundsIndex, center, extents);
+	if (boundsIndex < (int)m_sceneObjects.size())
+	{
+		m_sceneHierarchy.SetBounds(boundsIndex, center - extents, center + extents);
+	}
+}
 
-	// iMAC (iMac base)
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(1.5f, 10.0f, 3.0f); // wide , tall , deep
+/***********************************************************
+ *  AddDrawData()
+ *
+ *  This method is used for adding the per-draw data of a
+ *  scene object to a list of the multi-draw frame.
+ ***********************************************************/
+void SceneManager::AddDrawData(const SCENE_OBJECT& object, std::vector<MeshArena::DRAW_DATA>& drawData) const
+{
+	MeshArena::DRAW_DATA objectData;
 
-	XrotationDegrees = 90.0f; // x = tilt forward/backward
-	YrotationDegrees = 0.0f; // y = spin left/right
-	ZrotationDegrees = 0.0f; // z = lean left/right
+	objectData.model = object.modelMatrix;
+	objectData.color = object.color;
+	objectData.uvScale = object.uvScale;
+	// objects without a material use the first one
+	objectData.materialIndex = (object.materialID >= 0) ? object.materialID : 0;
+	objectData.textureLayer = (object.textureID >= 0) ? m_textureArrays.GetLayer(object.textureID).layer : 0;
 
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(0.5f, 3.0f, -1.8f); // right , downward , forward
+	drawData.push_back(objectData);
+}
 
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
+/***********************************************************
+ *  RecordDrawCommands()
+ *
+ *  This method is used for turning a range of the sorted
+ *  packets into per-draw data, indirect draw commands and
+ *  runs in a list of its own.  Every packet is one command, an
+ *  instance batch draws all its visible objects as instances
+ *  of its command.  The base instances and first commands
+ *  are counted from the start of the list, they are moved
+ *  to the frame when the lists are merged.
+ ***********************************************************/
+void SceneManager::RecordDrawCommands(int firstPacket, int lastPacket, RECORD_LIST& list) const
+{
+	const std::vector<RenderQueue::DRAW_PACKET>& packets = m_renderQueue.GetPackets();
 
-	//SetShaderColor(0.5, 0.5, 0.5, 1.0); // GREY
+	list.drawData.clear();
+	list.commands.clear();
+	list.runs.clear();
+	list.stats = FRAME_STATS();
 
-	SetShaderTexture("metallic");
-	SetShaderMaterial("cement");
-	//SetTextureUVScale(2.0, 2.0);
+	for (int packetIndex = firstPacket; packetIndex < lastPacket; packetIndex++)
+	{
+		const RenderQueue::DRAW_PACKET& packet = packets[packetIndex];
+		const bool bBatch = (packet.payload & g_BatchPayloadFlag) != 0;
+		const bool bBaked = (packet.payload & g_BakedPayloadFlag) != 0;
+		const uint32_t index = packet.payload & g_PayloadIndexMask;
 
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawPlaneMesh();
+		MeshArena::DRAW_COMMAND command;
+		int meshID;
+		int textureID;
 
-	/******************************************************************/
+		command.baseInstance = (GLuint)list.drawData.size();
+		if (bBaked == true)
+		{
+			// baked vertices are already in world space
+			const BAKED_DRAW& baked = m_bakedDraws[index];
+			MeshArena::DRAW_DATA drawData;
+			drawData.model = glm::mat4(1.0f);
+			drawData.color = baked.color;
+			drawData.uvScale = glm::vec2(1.0f, 1.0f);
+			drawData.materialIndex = (baked.materialID >= 0) ? baked.materialID : 0;
+			drawData.textureLayer = (baked.textureID >= 0) ? m_textureArrays.GetLayer(baked.textureID).layer : 0;
+			list.drawData.push_back(drawData);
+			meshID = baked.meshID;
+			textureID = baked.textureID;
+		}
+		else if (bBatch == true)
+		{
+			const INSTANCE_BATCH& batch = m_instanceBatches[index];
+			for (int objectIndex : batch.objectIndices)
+			{
+				if (IsBoundsVisible(objectIndex) == true)
+				{
+					AddDrawData(m_sceneObjects[objectIndex], list.drawData);
+				}
+			}
+			meshID = batch.meshID;
+			textureID = batch.textureID;
+		}
+		else
+		{
+			const SCENE_OBJECT& object = m_sceneObjects[index];
+			AddDrawData(object, list.drawData);
+			meshID = m_meshArena->GetLodMesh(object.meshID, object.lodLevel);
+			textureID = object.textureID;
+		}
+		command.instanceCount = (GLuint)list.drawData.size() - command.baseInstance;
+
+		const MeshArena::MESH_RANGE& mesh = m_meshArena->GetMesh(meshID);
+		command.count = mesh.indexCount;
+		command.firstIndex = mesh.firstIndex;
+		command.baseVertex = mesh.baseVertex;
+		list.stats.indicesDrawn += (int)(command.count * command.instanceCount);
+
+		// the pass and the texture array are the only state
+		// left between commands
+		const int pass = RenderQueue::GetPass(packet.sortKey);
+		const int textureArray = GetTextureKey(textureID);
+		if ((list.runs.empty() == true) ||
+			(list.runs.back().pass != pass) ||
+			(list.runs.back().textureArray != textureArray))
+		{
+			DRAW_RUN run;
+			run.firstCommand = (int)list.commands.size();
+			run.commandCount = 0;
+			run.pass = pass;
+			run.textureArray = textureArray;
+			list.runs.push_back(run);
+		}
+		list.runs.back().commandCount++;
+		list.commands.push_back(command);
+	}
+}
 
-	// table top
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(22.0f, 1.0f, 10.0f); // wide , tall , deep
+/***********************************************************
+ *  SubmitMultiDraw()
+ *
+ *  This method is used for turning the sorted render queue
+ *  into indirect draw commands and drawing them.  The per-
+ *  draw data carries everything that differs between the
+ *  commands, including the texture layer, so the packets
+ *  that share a texture array are drawn with a single
+ *  multi-draw call.  The packets are recorded as jobs of a
+ *  range each, and this thread only places their lists one
+ *  after the other in this frame's region of the arena
+ *  rings, joining the runs that meet, and draws them.
+ ***********************************************************/
+void SceneManager::SubmitMultiDraw()
+{
+	const int packetCount = (int)m_renderQueue.GetPackets().size();
+	const int listCount = (packetCount + g_RecordGrain - 1) / g_RecordGrain;
 
-	XrotationDegrees = 0.0f; // x = tilt forward/backward
-	YrotationDegrees = 0.0f; // y = spin left/right
-	ZrotationDegrees = 0.0f; // z = lean left/right
+	m_drawRuns.clear();
 
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(0.0f, 3.0f, 0.0f); // right , downward , forward
+	if (packetCount == 0)
+	{
+		return;
+	}
 
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
+	if ((int)m_recordLists.size() < listCount)
+	{
+		m_recordLists.resize(listCount);
+	}
 
-	//SetShaderColor(1.0, 0.5, 0.0, 1.0); // ORANGE
+	// every object and baked mesh is drawn at most once
+	m_meshArena->BeginFrame((int)(m_sceneObjects.size() + m_bakedDraws.size()), packetCount);
 
-	SetShaderTexture("marble");
-	SetShaderMaterial("gold");
-	//SetTextureUVScale(1.0, 1.0);
+	m_jobSystem.BeginStage();
+	m_jobSystem.ParallelFor(packetCount, g_RecordGrain, [this](int firstPacket, int lastPacket)
+	{
+		RecordDrawCommands(firstPacket, lastPacket, m_recordLists[firstPacket / g_RecordGrain]);
+	});
+	m_jobSystem.EndStage(m_stageStats[STAGE_COMMANDS]);
+
+	const GLuint drawBase = m_meshArena->GetDrawDataBase();
+	int drawCount = 0;
+	int commandCount = 0;
+	for (int listIndex = 0; listIndex < listCount; listIndex++)
+	{
+		RECORD_LIST& list = m_recordLists[listIndex];
 
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawBoxMesh();
+		for (MeshArena::DRAW_COMMAND& command : list.commands)
+		{
+			command.baseInstance += drawBase + (GLuint)drawCount;
+		}
+		m_meshArena->UpdateDrawData(list.drawData.data(), (int)list.drawData.size(), drawCount);
+		m_meshArena->UpdateCommands(list.commands.data(), (int)list.commands.size(), commandCount);
 
-	// table top (bottom)
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(22.0f, 5.0f, 10.0f); // wide , tall , deep
+		for (const DRAW_RUN& run : list.runs)
+		{
+			if ((m_drawRuns.empty() == false) &&
+				(m_drawRuns.back().pass == run.pass) &&
+				(m_drawRuns.back().textureArray == run.textureArray))
+			{
+				m_drawRuns.back().commandCount += run.commandCount;
+			}
+			else
+			{
+				m_drawRuns.push_back(run);
+				m_drawRuns.back().firstCommand += commandCount;
+			}
+		}
 
-	XrotationDegrees = 0.0f; // x = tilt forward/backward
-	YrotationDegrees = 0.0f; // y = spin left/right
-	ZrotationDegrees = 0.0f; // z = lean left/right
+		drawCount += (int)list.drawData.size();
+		commandCount += (int)list.commands.size();
+		m_frameStats.indicesDrawn += list.stats.indicesDrawn;
+	}
+	// the opaque commands come first, so the pre-pass draws
+	// all of them with one call whatever their texture
+	if (IsDepthPrepassActive() == true)
+	{
+		int opaqueCount = 0;
+		for (const DRAW_RUN& run : m_drawRuns)
+		{
+			opaqueCount += (run.pass == g_OpaquePass) ? run.commandCount : 0;
+		}
+		if (opaqueCount > 0)
+		{
+			m_pRenderState->SetBlending(false);
+			m_pRenderState->SetDepthWrite(true);
+			m_pRenderState->SetDepthFunc(GL_LESS);
+			m_pRenderState->SetColorWrite(false);
+			m_depthPrepass.Begin(m_view, m_projection);
+			m_meshArena->MultiDraw(0, opaqueCount, true);
+			m_depthPrepass.End();
+			m_pRenderState->SetColorWrite(true);
+			m_frameStats.drawCalls++;
+			m_frameStats.prepassCommands = opaqueCount;
+		}
+	}
 
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(0.0f, 0.0f, 0.0f); // right , downward , forward
+	// the model matrix, color, UV scale, material and texture
+	// layer all come from the per-draw data
+	m_pShaderUniforms->setBoolValue(m_shaderHandles.useInstancing, true);
+	m_pShaderUniforms->setBoolValue(m_shaderHandles.useDrawData, true);
 
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
+	if (m_shadingQuery != 0)
+	{
+		glBeginQuery(GL_SAMPLES_PASSED, m_shadingQuery);
+	}
+	for (const DRAW_RUN& run : m_drawRuns)
+	{
+		SetPassState(run.pass);
+		if (run.textureArray >= 0)
+		{
+			m_pShaderUniforms->setIntValue(m_shaderHandles.useTexture, true);
+			m_pShaderUniforms->setSampler2DArrayValue(m_shaderHandles.objectTexture, run.textureArray);
+		}
+		else
+		{
+			m_pShaderUniforms->setIntValue(m_shaderHandles.useTexture, false);
+		}
 
-	//SetShaderColor(0.2, 0.2, 0.2, 1.0); // DARK GREY
-	
-	SetShaderTexture("plank");
-	SetShaderMaterial("clay");
+		m_meshArena->MultiDraw(run.firstCommand, run.commandCount);
+		m_frameStats.drawCalls++;
+	}
+	if (m_shadingQuery != 0)
+	{
+		glEndQuery(GL_SAMPLES_PASSED);
+	}
+	m_meshArena->EndFrame();
+	m_frameStats.drawCommands = commandCount;
 
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawBoxMesh();
+	m_pShaderUniforms->setBoolValue(m_shaderHandles.useDrawData, false);
+	m_pShaderUniforms->setBoolValue(m_shaderHandles.useInstancing, false);
+}
 
-	/******************************************************************/
+/***********************************************************
+ *  RenderScene()
+ *
+ *  This method is used for rendering the 3D scene by
+ *  queueing, sorting and drawing the objects in the scene
+ *  table
+ ***********************************************************/
+void SceneManager::RenderScene()
+{
+	// the transient data of the last frame is no longer used
+	m_frameArena.Reset();
 
-	/*
-	// BACKGROUND
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(20.0f, 1.0f, 10.0f);
+	// reset the statistics for this frame
+	m_frameStats = FRAME_STATS();
+	for (JobSystem::STAGE_STATS& stageStats : m_stageStats)
+	{
+		stageStats.seconds = 0.0;
+		stageStats.workers.assign(m_jobSystem.GetWorkerCount(), JobSystem::WORKER_STATS());
+	}
 
-	// set the XYZ rotation for the mesh
-	XrotationDegrees = 0.0f;
-	YrotationDegrees = 0.0f;
-	ZrotationDegrees = 0.0f;
+	// only the changed lights are uploaded again
+	m_lightBuffer.Upload();
 
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(0.0f, 0.0f, 0.0f);
+	// objects added or removed since the last frame move the
+	// others, which rebuilds all the world matrices and boxes
+	const bool bObjectsChanged = m_bObjectsChanged;
+	if (bObjectsChanged == true)
+	{
+		RebuildObjectLayout();
+		m_bObjectsChanged = false;
+	}
 
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
+	// only the moved objects need their model matrix rebuilt
+	m_jobSystem.BeginStage();
+	UpdateTransformations();
+	m_jobSystem.EndStage(m_stageStats[STAGE_TRANSFORMS]);
+	if (bObjectsChanged == true)
+	{
+		BuildSceneHierarchy();
+	}
+	else
+	{
+		m_sceneHierarchy.Refit();
+	}
+	if ((g_UseFrustumCulling == true) && ((int)m_sceneObjects.size() >= g_HierarchyCullingMinimum))
+	{
+		m_frustumCuller.Cull(m_viewProjection, m_sceneHierarchy, (int)m_sceneObjects.size());
+	}
+	else if (g_UseFrustumCulling == true)
+	{
+		m_frustumCuller.Cull(m_viewProjection);
+	}
+	if (g_UseOcclusionCulling == true)
+	{
+		m_jobSystem.BeginStage();
+		CullOccludedObjects();
+		m_jobSystem.EndStage(m_stageStats[STAGE_OCCLUSION]);
+	}
+	if (m_bUseMultiDraw == false)
+	{
+		UpdateInstanceBatches();
+	}
 
-	SetShaderColor(1, 1, 1, 1);
+	// collect the draw packets in authoring order, then sort
+	// them so that packets sharing the same state are adjacent -
+	// the tessellation levels are picked while recording
+	m_jobSystem.BeginStage();
+	QueueSceneObjects();
+	m_jobSystem.EndStage(m_stageStats[STAGE_QUEUE]);
+	m_frameStats.stateChangesUnsorted = m_renderQueue.CountStateChanges();
+	m_renderQueue.Sort();
+	m_frameStats.stateChanges = m_renderQueue.CountStateChanges();
+
+	if (m_bUseMultiDraw == true)
+	{
+		SubmitMultiDraw();
+	}
+	else
+	{
+		SubmitRenderQueue();
+	}
 
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawPlaneMesh();
-	*/
+	// the depth buffer is only cleared with depth writes on
+	m_pRenderState->SetBlending(false);
+	m_pRenderState->SetDepthWrite(true);
+	m_pRenderState->SetDepthFunc(GL_LESS);
+}
 
-	/****************************************************************/
+/***********************************************************
+ *  GetStageName()
+ *
+ *  This method is used for getting the name of a per-frame
+ *  stage, for the statistics.
+ ***********************************************************/
+const char* SceneManager::GetStageName(int stage)
+{
+	return(((stage >= 0) && (stage < STAGE_COUNT)) ? g_StageNames[stage] : "");
 }
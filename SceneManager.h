@@ -10,9 +10,27 @@
 #pragma once
 
 #include "ShaderManager.h"
+#include "ShaderUniforms.h"
 #include "ShapeMeshes.h"
+#include "InstancedMeshes.h"
+#include "MeshArena.h"
+#include "StaticGeometry.h"
+#include "RenderQueue.h"
+#include "RenderState.h"
+#include "SceneFile.h"
+#include "SceneGraph.h"
+#include "UniformBuffer.h"
+#include "LightBuffer.h"
+#include "TextureArrays.h"
+#include "FrustumCuller.h"
+#include "OcclusionCuller.h"
+#include "DepthPrepass.h"
+#include "JobSystem.h"
+#include "HandlePool.h"
+#include "TransformArrays.h"
 
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 /***********************************************************
@@ -25,16 +43,10 @@ class SceneManager
 {
 public:
 	// constructor
-	SceneManager(ShaderManager *pShaderManager);
+	SceneManager(ShaderManager *pShaderManager, ShaderUniforms* pShaderUniforms, RenderState* pRenderState);
 	// destructor
 	~SceneManager();
 
-	struct TEXTURE_INFO
-	{
-		std::string tag;
-		uint32_t ID;
-	};
-
 	struct OBJECT_MATERIAL
 	{
 		float ambientStrength;
@@ -45,38 +57,280 @@ public:
 		std::string tag;
 	};
 
+	// std140 layout of a material in the material uniform block
+	struct MATERIAL_DATA
+	{
+		// rgb ambient color, w ambient strength
+		glm::vec4 ambientColorStrength;
+		// rgb diffuse color, w shininess
+		glm::vec4 diffuseColorShininess;
+		// rgb specular color, w unused
+		glm::vec4 specularColor;
+	};
+
+	// transform-only node that scene objects are placed in
+	struct SCENE_NODE
+	{
+		std::string name;
+		// set when the local matrix needs to be rebuilt
+		bool bTransformDirty;
+		// set when the node and its parents never move
+		bool bStatic;
+		// set when static objects below the node are baked
+		bool bBaked;
+	};
+
+	struct SCENE_OBJECT
+	{
+		// SCENE_MESH of the basic shape to draw
+		int meshID;
+		// index into the defined materials, -1 for none
+		int materialID;
+		// loaded texture index, -1 when drawn with the color
+		int textureID;
+		glm::vec4 color;
+		glm::vec2 uvScale;
+		// cached world matrix of the object in the scene graph
+		glm::mat4 modelMatrix;
+		// set when the local matrix needs to be rebuilt
+		bool bTransformDirty;
+		// instance batch that draws the object, -1 if drawn alone
+		int batchID;
+		// set when the object and its parents never move
+		bool bStatic;
+		// set when the object is drawn as part of a baked mesh
+		bool bBaked;
+		// set when the object hides the objects behind it
+		bool bOccluder;
+		// set when the object is drawn in the blended pass
+		bool bTransparent;
+		// world-space bounding sphere, xyz center and w radius
+		glm::vec4 boundingSphere;
+		// tessellation level the object is drawn with
+		int lodLevel;
+		// scene node the object is placed in, -1 at the root
+		int parentIndex;
+	};
+
+	// names a scene object for as long as it is in the scene,
+	// its index in the table changes when objects are removed
+	typedef HandlePool<SCENE_OBJECT>::HANDLE OBJECT_HANDLE;
+
+	struct BAKED_DRAW
+	{
+		// baked mesh in the mesh arena
+		int meshID;
+		int textureID;
+		int materialID;
+		glm::vec4 color;
+		// set when the mesh is drawn in the blended pass
+		bool bTransparent;
+		// world-space culling box of the baked vertices
+		glm::vec3 boundsCenter;
+		glm::vec3 boundsExtents;
+	};
+
+	struct INSTANCE_BATCH
+	{
+		// state shared by all the objects in the batch
+		int meshID;
+		int textureID;
+		int materialID;
+		glm::vec2 uvScale;
+		bool bTransparent;
+		// scene objects drawn by the batch
+		std::vector<int> objectIndices;
+		// instance buffer in the instanced meshes
+		int instancesID;
+		// set when the instance data needs to be uploaded
+		bool bDirty;
+	};
+
+	// run of draw commands that share a pass and a texture
+	// array and are drawn with one multi-draw call
+	struct DRAW_RUN
+	{
+		int firstCommand;
+		int commandCount;
+		// render queue pass of the run
+		int pass;
+		// texture array of the run, -1 when untextured
+		int textureArray;
+	};
+
+	// handles of the uniforms set while rendering
+	struct SHADER_HANDLES
+	{
+		int model = -1;
+		int objectColor = -1;
+		int objectTexture = -1;
+		int textureLayer = -1;
+		int useTexture = -1;
+		int useInstancing = -1;
+		int useDrawData = -1;
+		int uvScale = -1;
+		int materialIndex = -1;
+	};
+
+	struct FRAME_STATS
+	{
+		// model matrices rebuilt during the frame
+		int matricesRecomputed = 0;
+		// draw calls issued during the frame
+		int drawCalls = 0;
+		// indirect draw commands in the multi-draw calls
+		int drawCommands = 0;
+		// render state changes in authoring order
+		int stateChangesUnsorted = 0;
+		// render state changes in the submitted, sorted order
+		int stateChanges = 0;
+		// objects and baked meshes inside and outside the view
+		// frustum
+		int objectsVisible = 0;
+		int objectsCulled = 0;
+		// culled objects and baked meshes that were inside the
+		// frustum but hidden behind the occluders
+		int objectsOccluded = 0;
+		// draws in the blended pass, after the opaque ones
+		int transparentDraws = 0;
+		// opaque commands drawn again by the depth pre-pass
+		int prepassCommands = 0;
+		// objects drawn below the finest tessellation level
+		int objectsReduced = 0;
+		// indices drawn by the multi-draw commands
+		int indicesDrawn = 0;
+	};
+
+	// per-frame stages run as jobs, each with the statistics
+	// of the workers while it ran
+	enum FRAME_STAGE
+	{
+		STAGE_TRANSFORMS,
+		STAGE_OCCLUSION,
+		STAGE_QUEUE,
+		STAGE_COMMANDS,
+		STAGE_COUNT
+	};
+
+	// what one job records for its range of the scene table,
+	// or of the sorted packets with multi-draw - the lists are
+	// merged in range order on the GL thread
+	struct RECORD_LIST
+	{
+		std::vector<RenderQueue::DRAW_PACKET> packets;
+		// per-draw data, commands and runs, the first command
+		// and base instance are counted from the list start
+		std::vector<MeshArena::DRAW_DATA> drawData;
+		std::vector<MeshArena::DRAW_COMMAND> commands;
+		std::vector<DRAW_RUN> runs;
+		// counts of the recorded range only
+		FRAME_STATS stats;
+	};
+
 private:
 	// pointer to shader manager object
 	ShaderManager* m_pShaderManager;
+	// pointer to the reflected shader uniforms
+	ShaderUniforms* m_pShaderUniforms;
+	// pointer to the shadowed GL state, for the pass state
+	RenderState* m_pRenderState;
+	// handles of the uniforms set while rendering
+	SHADER_HANDLES m_shaderHandles;
 	// pointer to basic shapes object
 	ShapeMeshes* m_basicMeshes;
-	// total number of loaded textures
-	int m_loadedTextures;
-	// loaded textures info
-	TEXTURE_INFO m_textureIDs[16];
-	// defined object materials
+	// pointer to the instanced shapes object
+	InstancedMeshes* m_instancedMeshes;
+	// pointer to the shared mesh buffers drawn with multi-draw
+	MeshArena* m_meshArena;
+	// set when the scene is drawn with multi-draw indirect
+	bool m_bUseMultiDraw;
+	// loaded textures, stored as layers of texture arrays
+	TextureArrays m_textureArrays;
+	// defined object materials, and the index of every tag
 	std::vector<OBJECT_MATERIAL> m_objectMaterials;
+	std::unordered_map<std::string, int> m_materialIDs;
+	// uniform buffer holding every defined material
+	UniformBuffer m_materialBuffer;
+	// uniform buffer holding the scene light sources
+	LightBuffer m_lightBuffer;
+	// nodes that group the scene objects
+	std::vector<SCENE_NODE> m_sceneNodes;
+	// flat table of the objects drawn in the 3D scene, kept
+	// packed, and the handles that find an object in it
+	std::vector<SCENE_OBJECT> m_sceneObjects;
+	HandlePool<SCENE_OBJECT> m_objectHandles;
+	// set when objects were added or removed since the last
+	// frame, the scene graph and hierarchy are then rebuilt
+	bool m_bObjectsChanged;
+	// transformations relative to the parent node of the
+	// scene nodes, followed by the ones of the scene objects
+	TransformArrays m_localTransforms;
+	// world matrices of the scene nodes, followed by the ones
+	// of the scene objects
+	SceneGraph m_sceneGraph;
+	// batches of scene objects drawn instanced
+	std::vector<INSTANCE_BATCH> m_instanceBatches;
+	// baked meshes of the static scene objects
+	std::vector<BAKED_DRAW> m_bakedDraws;
+	// draw packets of the frame being rendered
+	RenderQueue m_renderQueue;
+	// statistics of the last rendered frame
+	FRAME_STATS m_frameStats;
+	// world-space boxes of the scene objects, followed by the
+	// boxes of the baked meshes
+	FrustumCuller m_frustumCuller;
+	// hierarchy over the scene object boxes, for culling large
+	// scenes and for the spatial queries
+	SceneBVH m_sceneHierarchy;
+	// depth buffer of the occluders, and 1 for every culling
+	// box hidden behind them in the frame being rendered
+	OcclusionCuller m_occlusionCuller;
+	std::vector<uint8_t> m_occluded;
+	// camera matrices of the frame being rendered
+	glm::mat4 m_view;
+	glm::mat4 m_projection;
+	glm::mat4 m_viewProjection;
+	// view space length that covers the screen height at a
+	// distance of 1, taken from the projection
+	float m_projectionScale;
+	// lists of the recording jobs, one per range, kept
+	// between frames so their memory is reused
+	std::vector<RECORD_LIST> m_recordLists;
+	// workers of the per-frame stages, and what they did in
+	// every stage of the last frame
+	JobSystem m_jobSystem;
+	JobSystem::STAGE_STATS m_stageStats[STAGE_COUNT];
+	// transient data of the frame, a sub-arena per worker
+	FrameArena m_frameArena;
+	// merged runs of the multi-draw frame
+	std::vector<DRAW_RUN> m_drawRuns;
+	// depth-only program, and set when the opaque objects
+	// get a depth pre-pass before they are shaded
+	DepthPrepass m_depthPrepass;
+	bool m_bDepthPrepass;
+	// samples passed query around the shading passes, 0 for
+	// none
+	GLuint m_shadingQuery;
 
-	// load texture images and convert to OpenGL texture data
-	bool CreateGLTexture(const char* filename, std::string tag);
-	// bind loaded OpenGL textures to slots in memory
+	// load texture images to be stored in the texture arrays
+	bool CreateGLTexture(const char* filename, const std::string& tag);
+	// build the texture arrays and bind them to texture units
 	void BindGLTextures();
 	// free the loaded OpenGL textures
 	void DestroyGLTextures();
 	// find a loaded texture by tag
-	int FindTextureID(std::string tag);
-	int FindTextureSlot(std::string tag);
-	// find a defined material by tag
-	bool FindMaterial(std::string tag, OBJECT_MATERIAL& material);
-
-	// set the transformation values 
-	// into the transform buffer
-	void SetTransformations(
-		glm::vec3 scaleXYZ,
-		float XrotationDegrees,
-		float YrotationDegrees,
-		float ZrotationDegrees,
-		glm::vec3 positionXYZ);
+	int FindTextureSlot(const std::string& tag) const;
+	// render queue key of a loaded texture, its texture array
+	int GetTextureKey(int textureSlot) const;
+	// find the index of a defined material by tag, -1 when
+	// it is not defined
+	int FindMaterialID(const std::string& tag) const;
+
+	// set a built model matrix into the transform buffer
+	void SetModelMatrix(const glm::mat4& modelView);
+	// rebuild the model matrices of the moved scene nodes
+	// and objects
+	void UpdateTransformations();
 
 	// set the color values into the shader
 	void SetShaderColor(
@@ -86,21 +340,81 @@ private:
 		float alphaValue);
 
 	// set the texture data into the shader
-	void SetShaderTexture(
-		std::string textureTag);
+	void SetShaderTextureSlot(
+		int textureSlot);
 
 	// set the UV scale for the texture mapping
 	void SetTextureUVScale(
 		float u, float v);
 
 	// set the object material into the shader
-	void SetShaderMaterial(
-		std::string materialTag);
+	void SetShaderMaterialID(
+		int materialID);
+
+	// get the handles of the uniforms set while rendering
+	void GetShaderHandles();
+	// upload the defined materials into the material buffer
+	void UploadObjectMaterials();
+	// load the scene description into the scene object table
+	bool LoadSceneObjects();
+	// draw the basic shape mesh for a SCENE_MESH
+	void DrawMesh(int meshID);
+	// merge the static scene objects into baked meshes
+	void BakeStaticObjects();
+	// build the object hierarchy over every scene object
+	void BuildSceneHierarchy();
+	// rebuild the scene graph and the culling boxes after
+	// objects were added or removed
+	void RebuildObjectLayout();
+	// group the repeated scene objects into instance batches
+	void BuildInstanceBatches();
+	// upload the instance data of the changed batches
+	void UpdateInstanceBatches();
+	// check if a draw with the passed in state is blended
+	bool IsTransparent(int textureID, const glm::vec4& color) const;
+	// depth of a world-space point for the sort keys, 0 at
+	// the near plane and growing away from the camera
+	uint32_t GetSortDepth(const glm::vec3& position) const;
+	// set the blending and depth writes of a render pass
+	void SetPassState(int pass);
+	// add the draw packets of the frame to the render queue
+	void QueueSceneObjects();
+	// record the packets of a range of scene objects, run as
+	// a job
+	void RecordObjectPackets(int firstObject, int lastObject, RECORD_LIST& list);
+	// draw the sorted render queue, skipping redundant state
+	void SubmitRenderQueue();
+	// add the per-draw data of a scene object for multi-draw
+	void AddDrawData(const SCENE_OBJECT& object, std::vector<MeshArena::DRAW_DATA>& drawData) const;
+	// record the commands of a range of sorted packets, run
+	// as a job
+	void RecordDrawCommands(int firstPacket, int lastPacket, RECORD_LIST& list) const;
+	// pick the tessellation level of a visible object
+	int SelectLevelOfDetail(const SCENE_OBJECT& object) const;
+	// hide the culling boxes that are behind the occluders
+	void CullOccludedObjects();
+	// check if a culling box passed the last frustum and
+	// occlusion tests
+	bool IsBoundsVisible(int boundsIndex) const;
+	// set the world-space box of a scene object or baked mesh
+	void SetCullingBounds(int boundsIndex, const glm::vec3& center, const glm::vec3& extents);
+	// draw the sorted render queue with multi-draw indirect
+	void SubmitMultiDraw();
 
 public:
 
 	// prepare the 3D scene for rendering
 	void PrepareScene();
+	// set the camera the next frame is culled against and
+	// drawn with
+	void SetViewProjection(const glm::mat4& view, const glm::mat4& projection);
+	// lay down the depth of the opaque objects before they
+	// are shaded, only with multi-draw
+	void SetDepthPrepass(bool bEnabled) { m_bDepthPrepass = bEnabled; }
+	bool IsDepthPrepassActive() const;
+	// count the samples passed by the shading passes into a
+	// query object, 0 to stop counting
+	void SetShadingQuery(GLuint query) { m_shadingQuery = query; }
 	// render the objects in the 3D scene
 	void RenderScene();
 
@@ -111,4 +425,70 @@ public:
 	// add and define the light sources before rendering
 	void SetupSceneLights();
 
+	// add a scene object below a scene node, -1 for the root,
+	// drawn from the next frame on - the tags may be empty
+	OBJECT_HANDLE AddSceneObject(
+		int meshID,
+		const std::string& textureTag,
+		const std::string& materialTag,
+		const glm::vec4& color,
+		int parentNode,
+		glm::vec3 scaleXYZ,
+		glm::vec3 rotationXYZ,
+		glm::vec3 positionXYZ);
+	// remove a scene object, false for a stale handle - baked
+	// static objects cannot be removed
+	bool RemoveSceneObject(OBJECT_HANDLE objectHandle);
+	// check that a handle still names a scene object
+	bool IsObjectValid(OBJECT_HANDLE objectHandle) const { return m_objectHandles.IsValid(objectHandle); }
+	// the scene objects in table order
+	int GetObjectCount() const { return m_objectHandles.GetCount(); }
+	OBJECT_HANDLE GetObjectHandle(int objectIndex) const { return m_objectHandles.GetHandle(objectIndex); }
+
+	// move a scene object, its model matrix is rebuilt
+	// before the next frame is rendered - baked static
+	// objects cannot be moved
+	void SetObjectTransformations(
+		OBJECT_HANDLE objectHandle,
+		glm::vec3 scaleXYZ,
+		glm::vec3 rotationXYZ,
+		glm::vec3 positionXYZ);
+
+	// find a scene node by name, -1 if not defined
+	int FindSceneNode(const std::string& name) const;
+	// move a scene node, the objects and nodes below it
+	// move with it - baked static nodes cannot be moved
+	void SetNodeTransformations(
+		int nodeIndex,
+		glm::vec3 scaleXYZ,
+		glm::vec3 rotationXYZ,
+		glm::vec3 positionXYZ);
+
+	// change a scene light source, only the changed lights
+	// are uploaded before the next frame is rendered
+	void SetLightSource(
+		int lightIndex,
+		const LightBuffer::LIGHT_SOURCE& light);
+
+	// get the statistics of the last rendered frame
+	const FRAME_STATS& GetFrameStats() const { return m_frameStats; }
+	// get what the workers did in a stage of the last frame
+	const JobSystem::STAGE_STATS& GetStageStats(int stage) const { return m_stageStats[stage]; }
+	static const char* GetStageName(int stage);
+	// get the transient memory of the frames
+	const FrameArena& GetFrameArena() const { return m_frameArena; }
+
+	// find the scene object whose box a ray hits first, or
+	// the one whose box is closest to a point, an invalid
+	// handle if none - the boxes are the ones of the last
+	// rendered frame, and nothing is found from adding or
+	// removing objects until the next frame
+	OBJECT_HANDLE RaycastObjects(
+		const glm::vec3& origin,
+		const glm::vec3& direction,
+		float& hitDistance) const;
+	OBJECT_HANDLE FindNearestObject(
+		const glm::vec3& point,
+		float& distance) const;
+
 };
\ No newline at end of file
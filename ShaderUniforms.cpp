@@ -0,0 +1,320 @@
+///////////////////////////////////////////////////////////////////////////////
+// shaderuniforms.cpp
+// ============
+// look up the active shader uniforms once and set them through handles
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "ShaderUniforms.h"
+
+#include <glm/gtc/type_ptr.hpp>
+
+#include <cstring>
+#include <iostream>
+
+/***********************************************************
+ *  ShaderUniforms()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+ShaderUniforms::ShaderUniforms()
+{
+	m_programID = 0;
+}
+
+/***********************************************************
+ *  ReflectUniforms()
+ *
+ *  This method is used for reading the name, location and
+ *  type of every active uniform in the shader program that
+ *  is currently in use.  Arrays of basic types are reported
+ *  by GL as "name[0]", so they can also be found by the
+ *  name without the index.
+ ***********************************************************/
+void ShaderUniforms::ReflectUniforms()
+{
+	GLint programID = 0;
+	GLint uniformCount = 0;
+	GLint maxNameLength = 0;
+
+	glGetIntegerv(GL_CURRENT_PROGRAM, &programID);
+	m_programID = (GLuint)programID;
+	m_uniforms.clear();
+	m_values.clear();
+
+	if (m_programID == 0)
+	{
+		std::cout << "No shader program in use to read the uniforms from" << std::endl;
+		return;
+	}
+
+	glGetProgramiv(m_programID, GL_ACTIVE_UNIFORMS, &uniformCount);
+	glGetProgramiv(m_programID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxNameLength);
+
+	std::vector<GLchar> nameBuffer(maxNameLength + 1);
+	for (GLint i = 0; i < uniformCount; i++)
+	{
+		GLsizei nameLength = 0;
+		GLint arraySize = 0;
+		UNIFORM_INFO uniform;
+
+		glGetActiveUniform(m_programID, (GLuint)i, (GLsizei)nameBuffer.size(), &nameLength, &arraySize, &uniform.type, nameBuffer.data());
+		uniform.name.assign(nameBuffer.data(), nameLength);
+		uniform.location = glGetUniformLocation(m_programID, uniform.name.c_str());
+
+		// uniforms inside uniform blocks have no location
+		if (uniform.location < 0)
+		{
+			continue;
+		}
+
+		UNIFORM_VALUE value;
+		std::memset(value.bits, 0, sizeof(value.bits));
+		value.bWritten = false;
+		uniform.valueID = (int)m_values.size();
+		m_values.push_back(value);
+
+		m_uniforms.push_back(uniform);
+
+		if ((uniform.name.size() > 3) && (uniform.name.compare(uniform.name.size() - 3, 3, "[0]") == 0))
+		{
+			uniform.name.erase(uniform.name.size() - 3);
+			m_uniforms.push_back(uniform);
+		}
+	}
+
+	std::cout << "INFO: Shader uniforms reflected: " << m_uniforms.size() << std::endl;
+}
+
+/***********************************************************
+ *  GetHandle()
+ *
+ *  This method is used for getting the handle of the active
+ *  uniform with the passed in name.  It is meant to be
+ *  called once while preparing, never while rendering.
+ ***********************************************************/
+int ShaderUniforms::GetHandle(const char* name) const
+{
+	for (size_t i = 0; i < m_uniforms.size(); i++)
+	{
+		if (m_uniforms[i].name.compare(name) == 0)
+		{
+			return((int)i);
+		}
+	}
+
+	std::cout << "Shader uniform is not active:" << name << std::endl;
+	return(-1);
+}
+
+/***********************************************************
+ *  BindUniformBlock()
+ *
+ *  This method is used for assigning the uniform block with
+ *  the passed in name to a uniform buffer binding point.
+ *  GLSL 330 has no binding layout qualifier, so the block
+ *  is bound from here once after the shaders are loaded.
+ ***********************************************************/
+bool ShaderUniforms::BindUniformBlock(const char* blockName, GLuint bindingPoint) const
+{
+	GLuint blockIndex = GL_INVALID_INDEX;
+
+	if (m_programID != 0)
+	{
+		blockIndex = glGetUniformBlockIndex(m_programID, blockName);
+	}
+
+	if (blockIndex == GL_INVALID_INDEX)
+	{
+		std::cout << "Shader uniform block is not active:" << blockName << std::endl;
+		return(false);
+	}
+
+	glUniformBlockBinding(m_programID, blockIndex, bindingPoint);
+	return(true);
+}
+
+/***********************************************************
+ *  CheckType()
+ *
+ *  This method is used for checking, in debug builds, that
+ *  a uniform is set with the type it was declared with.
+ ***********************************************************/
+bool ShaderUniforms::CheckType(int handle, GLenum type) const
+{
+	if (handle < 0)
+	{
+		return(false);
+	}
+
+#ifdef _DEBUG
+	if (m_uniforms[handle].type != type)
+	{
+		std::cout << "Shader uniform set with the wrong type:" << m_uniforms[handle].name << std::endl;
+		return(false);
+	}
+#endif
+
+	return(true);
+}
+
+/***********************************************************
+ *  UpdateValue()
+ *
+ *  This method is used for comparing a value about to be
+ *  written with the last value written to the uniform.  The
+ *  new value is kept and the write counted as issued when
+ *  they differ, otherwise it is counted as elided.
+ ***********************************************************/
+bool ShaderUniforms::UpdateValue(int handle, const void* value, size_t size) const
+{
+	UNIFORM_VALUE& lastValue = m_values[m_uniforms[handle].valueID];
+
+	if ((lastValue.bWritten == true) && (std::memcmp(lastValue.bits, value, size) == 0))
+	{
+		m_stats.elided++;
+		return(false);
+	}
+
+	std::memcpy(lastValue.bits, value, size);
+	lastValue.bWritten = true;
+	m_stats.issued++;
+	return(true);
+}
+
+/***********************************************************
+ *  InvalidateValues()
+ *
+ *  This method is used for forgetting the last written
+ *  values, so that the next write to every uniform reaches
+ *  GL.  It is needed after the uniforms of the program were
+ *  set by name or the program was linked again.
+ ***********************************************************/
+void ShaderUniforms::InvalidateValues()
+{
+	for (UNIFORM_VALUE& value : m_values)
+	{
+		value.bWritten = false;
+	}
+}
+
+/***********************************************************
+ *  setBoolValue()
+ *
+ *  Set a bool uniform through its handle.
+ ***********************************************************/
+void ShaderUniforms::setBoolValue(int handle, bool value) const
+{
+	GLint intValue = (GLint)value;
+	if (CheckType(handle, GL_BOOL) && UpdateValue(handle, &intValue, sizeof(intValue)))
+	{
+		glUniform1i(m_uniforms[handle].location, intValue);
+	}
+}
+
+/***********************************************************
+ *  setIntValue()
+ *
+ *  Set an int uniform through its handle.  The scene
+ *  code also sets booleans as integers, so both types
+ *  are accepted.
+ ***********************************************************/
+void ShaderUniforms::setIntValue(int handle, int value) const
+{
+	if ((handle >= 0) && ((m_uniforms[handle].type == GL_BOOL) || CheckType(handle, GL_INT)) &&
+		UpdateValue(handle, &value, sizeof(value)))
+	{
+		glUniform1i(m_uniforms[handle].location, value);
+	}
+}
+
+/***********************************************************
+ *  setSampler2DValue()
+ *
+ *  Set a sampler2D uniform through its handle.
+ ***********************************************************/
+void ShaderUniforms::setSampler2DValue(int handle, int value) const
+{
+	if (CheckType(handle, GL_SAMPLER_2D) && UpdateValue(handle, &value, sizeof(value)))
+	{
+		glUniform1i(m_uniforms[handle].location, value);
+	}
+}
+
+/***********************************************************
+ *  setSampler2DArrayValue()
+ *
+ *  Set a sampler2DArray uniform through its handle.
+ ***********************************************************/
+void ShaderUniforms::setSampler2DArrayValue(int handle, int value) const
+{
+	if (CheckType(handle, GL_SAMPLER_2D_ARRAY) && UpdateValue(handle, &value, sizeof(value)))
+	{
+		glUniform1i(m_uniforms[handle].location, value);
+	}
+}
+
+/***********************************************************
+ *  setFloatValue()
+ *
+ *  Set a float uniform through its handle.
+ ***********************************************************/
+void ShaderUniforms::setFloatValue(int handle, float value) const
+{
+	if (CheckType(handle, GL_FLOAT) && UpdateValue(handle, &value, sizeof(value)))
+	{
+		glUniform1f(m_uniforms[handle].location, value);
+	}
+}
+
+/***********************************************************
+ *  setVec2Value()
+ *
+ *  Set a vec2 uniform through its handle.
+ ***********************************************************/
+void ShaderUniforms::setVec2Value(int handle, const glm::vec2& value) const
+{
+	if (CheckType(handle, GL_FLOAT_VEC2) && UpdateValue(handle, glm::value_ptr(value), sizeof(value)))
+	{
+		glUniform2f(m_uniforms[handle].location, value.x, value.y);
+	}
+}
+
+/***********************************************************
+ *  setVec3Value()
+ *
+ *  Set a vec3 uniform through its handle.
+ ***********************************************************/
+void ShaderUniforms::setVec3Value(int handle, const glm::vec3& value) const
+{
+	if (CheckType(handle, GL_FLOAT_VEC3) && UpdateValue(handle, glm::value_ptr(value), sizeof(value)))
+	{
+		glUniform3f(m_uniforms[handle].location, value.x, value.y, value.z);
+	}
+}
+
+/***********************************************************
+ *  setVec4Value()
+ *
+ *  Set a vec4 uniform through its handle.
+ ***********************************************************/
+void ShaderUniforms::setVec4Value(int handle, const glm::vec4& value) const
+{
+	if (CheckType(handle, GL_FLOAT_VEC4) && UpdateValue(handle, glm::value_ptr(value), sizeof(value)))
+	{
+		glUniform4f(m_uniforms[handle].location, value.x, value.y, value.z, value.w);
+	}
+}
+
+/***********************************************************
+ *  setMat4Value()
+ *
+ *  Set a mat4 uniform through its handle.
+ ***********************************************************/
+void ShaderUniforms::setMat4Value(int handle, const glm::mat4& value) const
+{
+	if (CheckType(handle, GL_FLOAT_MAT4) && UpdateValue(handle, glm::value_ptr(value), sizeof(value)))
+	{
+		glUniformMatrix4fv(m_uniforms[handle].location, 1, GL_FALSE, glm::value_ptr(value));
+	}
+}
@@ -0,0 +1,102 @@
+///////////////////////////////////////////////////////////////////////////////
+// shaderuniforms.h
+// ============
+// look up the active shader uniforms once and set them through handles
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include <string>
+#include <vector>
+
+/***********************************************************
+ *  ShaderUniforms
+ *
+ *  This class reflects the active uniforms of the shader
+ *  program in use right after the shaders are loaded.  The
+ *  uniforms are then set through integer handles, so no
+ *  uniform name is looked up while rendering.  A handle of
+ *  -1 is returned for uniforms that are not active and is
+ *  ignored by the setters, the same as location -1 in GL.
+ *  The last value written to every uniform is kept, so a
+ *  set with the value the uniform already has never
+ *  reaches GL.
+ ***********************************************************/
+class ShaderUniforms
+{
+public:
+	// constructor
+	ShaderUniforms();
+
+	struct UNIFORM_STATS
+	{
+		// uniform writes passed on to GL
+		int issued = 0;
+		// uniform writes dropped as no-ops
+		int elided = 0;
+	};
+
+	// read the active uniforms of the shader program in use
+	void ReflectUniforms();
+	// get the handle for a uniform name, -1 if not active
+	int GetHandle(const char* name) const;
+	// assign a uniform block of the program to a binding point
+	bool BindUniformBlock(const char* blockName, GLuint bindingPoint) const;
+
+	// set uniform values through their handles
+	void setBoolValue(int handle, bool value) const;
+	void setIntValue(int handle, int value) const;
+	void setSampler2DValue(int handle, int value) const;
+	void setSampler2DArrayValue(int handle, int value) const;
+	void setFloatValue(int handle, float value) const;
+	void setVec2Value(int handle, const glm::vec2& value) const;
+	void setVec3Value(int handle, const glm::vec3& value) const;
+	void setVec4Value(int handle, const glm::vec4& value) const;
+	void setMat4Value(int handle, const glm::mat4& value) const;
+
+	// forget the last written values, for when the uniforms
+	// were changed without going through the handles
+	void InvalidateValues();
+	// get and reset the counts of issued and elided writes
+	const UNIFORM_STATS& GetStats() const { return m_stats; }
+	void ResetStats() { m_stats = UNIFORM_STATS(); }
+
+private:
+	struct UNIFORM_INFO
+	{
+		std::string name;
+		GLint location;
+		GLenum type;
+		// last written value, shared by the "name[0]" and
+		// "name" handles of an array
+		int valueID;
+	};
+
+	struct UNIFORM_VALUE
+	{
+		// raw bytes of up to a mat4
+		GLuint bits[16];
+		// set once a value has been written
+		bool bWritten;
+	};
+
+	// shader program the uniforms were read from
+	GLuint m_programID;
+	// the active uniforms, indexed by handle
+	std::vector<UNIFORM_INFO> m_uniforms;
+	// last written value of every uniform, written from
+	// the const setters
+	mutable std::vector<UNIFORM_VALUE> m_values;
+	// counts of issued and elided writes
+	mutable UNIFORM_STATS m_stats;
+
+	// check that a handle refers to a uniform of the given type
+	bool CheckType(int handle, GLenum type) const;
+	// record a write, returns false when the uniform already
+	// has the value and the write can be skipped
+	bool UpdateValue(int handle, const void* value, size_t size) const;
+};
@@ -0,0 +1,64 @@
+///////////////////////////////////////////////////////////////////////////////
+// snapshotbuffer.cpp
+// ============
+// hand the newest frame snapshot from the update thread to the render
+// thread without locks
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "SnapshotBuffer.h"
+
+// declare the global variables
+namespace
+{
+	// the shared slot index and the flag set when it holds a
+	// snapshot the render thread has not taken
+	const int g_SlotMask = 0x3;
+	const int g_PublishedFlag = 0x4;
+}
+
+/***********************************************************
+ *  SnapshotBuffer()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+SnapshotBuffer::SnapshotBuffer()
+{
+	m_writeSlot = 0;
+	m_sharedSlot.store(1);
+	m_readSlot = 2;
+}
+
+/***********************************************************
+ *  Publish()
+ *
+ *  This method is used for handing the filled snapshot to
+ *  the render thread.  The update thread gets the shared
+ *  slot back to fill next, which holds either a snapshot the
+ *  render thread skipped or one it has moved on from.
+ ***********************************************************/
+void SnapshotBuffer::Publish()
+{
+	const int previous = m_sharedSlot.exchange(m_writeSlot | g_PublishedFlag, std::memory_order_acq_rel);
+	m_writeSlot = previous & g_SlotMask;
+}
+
+/***********************************************************
+ *  Acquire()
+ *
+ *  This method is used for taking the newest published
+ *  snapshot, giving the one the render thread was reading
+ *  back to the update thread.
+ ***********************************************************/
+bool SnapshotBuffer::Acquire()
+{
+	if ((m_sharedSlot.load(std::memory_order_acquire) & g_PublishedFlag) == 0)
+	{
+		return(false);
+	}
+
+	const int previous = m_sharedSlot.exchange(m_readSlot, std::memory_order_acq_rel);
+	m_readSlot = previous & g_SlotMask;
+
+	return(true);
+}
@@ -0,0 +1,74 @@
+///////////////////////////////////////////////////////////////////////////////
+// snapshotbuffer.h
+// ============
+// hand the newest frame snapshot from the update thread to the render
+// thread without locks
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <atomic>
+#include <cstdint>
+
+/***********************************************************
+ *  SnapshotBuffer
+ *
+ *  This class holds three frame snapshots.  The update
+ *  thread fills one of them and publishes it, the render
+ *  thread takes the newest published one, and the third is
+ *  the one passed between them.  Publishing and taking swap
+ *  the passed slot with a single atomic exchange, so neither
+ *  thread waits for the other.  Snapshots the render thread
+ *  did not get to are replaced by newer ones.
+ *
+ *  A published snapshot is not written again until the
+ *  render thread has moved on from it.
+ ***********************************************************/
+class SnapshotBuffer
+{
+public:
+	// everything the render thread needs to draw a frame
+	struct FRAME_SNAPSHOT
+	{
+		// update tick the snapshot was taken at, and the
+		// time it was taken at, in seconds
+		uint64_t updateNumber = 0;
+		double updateTime = 0.0;
+		// camera of the frame
+		glm::mat4 view = glm::mat4(1.0f);
+		glm::mat4 projection = glm::mat4(1.0f);
+		glm::vec3 viewPosition = glm::vec3(0.0f);
+		// size of the window framebuffer, for the viewport
+		int framebufferWidth = 0;
+		int framebufferHeight = 0;
+		// set when the scene is drawn with a depth pre-pass
+		bool bDepthPrepass = false;
+	};
+
+	// constructor
+	SnapshotBuffer();
+
+	// update thread - the snapshot to fill, and handing it
+	// over once it is filled
+	FRAME_SNAPSHOT& GetWriteSnapshot() { return m_snapshots[m_writeSlot]; }
+	void Publish();
+
+	// render thread - move on to the newest published
+	// snapshot, false when none was published since the last
+	// call and the current one is kept
+	bool Acquire();
+	const FRAME_SNAPSHOT& GetReadSnapshot() const { return m_snapshots[m_readSlot]; }
+
+private:
+	FRAME_SNAPSHOT m_snapshots[3];
+	// slot owned by the update thread
+	int m_writeSlot;
+	// slot owned by the render thread
+	int m_readSlot;
+	// slot passed between the threads, with a flag set when
+	// it was published and not taken yet
+	std::atomic<int> m_sharedSlot;
+};
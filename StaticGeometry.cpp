@@ -0,0 +1,316 @@
+///////////////////////////////////////////////////////////////////////////////
+// staticgeometry.cpp
+// ============
+// bake the static scene objects into pre-transformed merged meshes
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "StaticGeometry.h"
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+// declare the global variables
+namespace
+{
+	// cache file identification, the version changes along
+	// with the vertex layout or the basic shape geometry
+	const char g_CacheMagic[4] = { 'B', 'A', 'K', 'E' };
+	const uint32_t g_CacheVersion = 1;
+
+	struct CACHE_HEADER
+	{
+		char magic[4];
+		uint32_t version;
+		uint32_t objectsHash;
+		uint32_t meshCount;
+	};
+
+	struct CACHE_MESH
+	{
+		int32_t textureID;
+		int32_t materialID;
+		float color[4];
+		uint32_t vertexFloatCount;
+		uint32_t indexCount;
+	};
+
+	/***********************************************************
+	 *  HashBytes()
+	 *
+	 *  FNV-1a hash of a block of memory, continued from the
+	 *  passed in hash.
+	 ***********************************************************/
+	uint32_t HashBytes(uint32_t hash, const void* data, size_t size)
+	{
+		const unsigned char* bytes = (const unsigned char*)data;
+		for (size_t i = 0; i < size; i++)
+		{
+			hash ^= bytes[i];
+			hash *= 16777619u;
+		}
+		return(hash);
+	}
+}
+
+/***********************************************************
+ *  FindMesh()
+ *
+ *  This method is used for finding the baked mesh with the
+ *  same state as the passed in object.  The color only
+ *  matters for objects drawn without a texture.
+ ***********************************************************/
+int StaticGeometry::FindMesh(const BAKE_OBJECT& object) const
+{
+	for (size_t i = 0; i < m_meshes.size(); i++)
+	{
+		const BAKED_MESH& mesh = m_meshes[i];
+		if ((mesh.textureID == object.textureID) &&
+			(mesh.materialID == object.materialID) &&
+			((object.textureID >= 0) || (mesh.color == object.color)))
+		{
+			return((int)i);
+		}
+	}
+
+	return(-1);
+}
+
+/***********************************************************
+ *  Bake()
+ *
+ *  This method is used for merging the passed in objects
+ *  into baked meshes.  Every object is a copy of its basic
+ *  shape mesh, moved into world space.
+ ***********************************************************/
+void StaticGeometry::Bake(const MeshArena& meshArena, const std::vector<BAKE_OBJECT>& objects)
+{
+	const int stride = MeshArena::VERTEX_STRIDE;
+	std::vector<GLfloat> vertices;
+	std::vector<GLuint> indices;
+
+	m_meshes.clear();
+
+	for (const BAKE_OBJECT& object : objects)
+	{
+		int meshIndex = FindMesh(object);
+		if (meshIndex < 0)
+		{
+			BAKED_MESH mesh;
+			mesh.textureID = object.textureID;
+			mesh.materialID = object.materialID;
+			mesh.color = object.color;
+			m_meshes.push_back(mesh);
+			meshIndex = (int)m_meshes.size() - 1;
+		}
+		BAKED_MESH& mesh = m_meshes[meshIndex];
+
+		// normals are moved with the inverse transpose, so
+		// they stay perpendicular under non-uniform scaling
+		glm::mat3 normalMatrix = glm::mat3(glm::transpose(glm::inverse(object.modelMatrix)));
+		GLuint firstVertex = (GLuint)(mesh.vertices.size() / stride);
+
+		meshArena.GetMeshGeometry(object.meshID, vertices, indices);
+		for (size_t v = 0; v + stride <= vertices.size(); v += stride)
+		{
+			glm::vec4 position = object.modelMatrix * glm::vec4(vertices[v], vertices[v + 1], vertices[v + 2], 1.0f);
+			glm::vec3 normal = glm::normalize(normalMatrix * glm::vec3(vertices[v + 3], vertices[v + 4], vertices[v + 5]));
+
+			mesh.vertices.push_back(position.x);
+			mesh.vertices.push_back(position.y);
+			mesh.vertices.push_back(position.z);
+			mesh.vertices.push_back(normal.x);
+			mesh.vertices.push_back(normal.y);
+			mesh.vertices.push_back(normal.z);
+			mesh.vertices.push_back(vertices[v + 6] * object.uvScale.x);
+			mesh.vertices.push_back(vertices[v + 7] * object.uvScale.y);
+		}
+		for (GLuint index : indices)
+		{
+			mesh.indices.push_back(firstVertex + index);
+		}
+	}
+
+	std::cout << "Baked static objects:" << objects.size() << " into meshes:" << m_meshes.size() << std::endl;
+}
+
+/***********************************************************
+ *  HashObjects()
+ *
+ *  This method is used for hashing everything about the
+ *  objects that ends up in the baked meshes.
+ ***********************************************************/
+uint32_t StaticGeometry::HashObjects(const std::vector<BAKE_OBJECT>& objects)
+{
+	uint32_t hash = 2166136261u;
+
+	for (const BAKE_OBJECT& object : objects)
+	{
+		hash = HashBytes(hash, &object.meshID, sizeof(object.meshID));
+		hash = HashBytes(hash, &object.textureID, sizeof(object.textureID));
+		hash = HashBytes(hash, &object.materialID, sizeof(object.materialID));
+		hash = HashBytes(hash, &object.color, sizeof(object.color));
+		hash = HashBytes(hash, &object.uvScale, sizeof(object.uvScale));
+		hash = HashBytes(hash, &object.modelMatrix, sizeof(object.modelMatrix));
+	}
+
+	return(hash);
+}
+
+/***********************************************************
+ *  ReadCache()
+ *
+ *  This method is used for reading the baked meshes from a
+ *  cache file.  The file is only accepted if it was written
+ *  for objects with the passed in hash, and only if every
+ *  count fits in the file and every ID and index is in
+ *  range - the hash does not cover the body of the file.
+ ***********************************************************/
+bool StaticGeometry::ReadCache(const char* filename, uint32_t objectsHash, int textureCount, int materialCount)
+{
+	std::ifstream file(filename, std::ios::binary);
+	if (!file.is_open())
+	{
+		return(false);
+	}
+
+	file.seekg(0, std::ios::end);
+	const uint64_t fileSize = (uint64_t)file.tellg();
+	file.seekg(0, std::ios::beg);
+
+	CACHE_HEADER header;
+	file.read((char*)&header, sizeof(header));
+	if (!file.good() ||
+		memcmp(header.magic, g_CacheMagic, sizeof(g_CacheMagic)) != 0 ||
+		header.version != g_CacheVersion ||
+		header.objectsHash != objectsHash)
+	{
+		return(false);
+	}
+
+	// counts that do not fit in the rest of the file are
+	// rejected before anything is allocated for them
+	uint64_t remainingSize = fileSize - sizeof(header);
+	bool bValid = (sizeof(CACHE_MESH) * (uint64_t)header.meshCount <= remainingSize);
+	if (bValid == true)
+	{
+		m_meshes.resize(header.meshCount);
+	}
+	for (size_t index = 0; (bValid == true) && (index < m_meshes.size()); index++)
+	{
+		BAKED_MESH& mesh = m_meshes[index];
+		CACHE_MESH record;
+		file.read((char*)&record, sizeof(record));
+		if (!file.good())
+		{
+			bValid = false;
+			break;
+		}
+		remainingSize -= sizeof(record);
+
+		const uint64_t dataSize = sizeof(GLfloat) * (uint64_t)record.vertexFloatCount + sizeof(GLuint) * (uint64_t)record.indexCount;
+		if (dataSize > remainingSize)
+		{
+			bValid = false;
+			break;
+		}
+		remainingSize -= dataSize;
+
+		mesh.textureID = record.textureID;
+		mesh.materialID = record.materialID;
+		mesh.color = glm::vec4(record.color[0], record.color[1], record.color[2], record.color[3]);
+		mesh.vertices.resize(record.vertexFloatCount);
+		mesh.indices.resize(record.indexCount);
+		file.read((char*)mesh.vertices.data(), sizeof(GLfloat) * record.vertexFloatCount);
+		file.read((char*)mesh.indices.data(), sizeof(GLuint) * record.indexCount);
+	}
+
+	if ((bValid == false) || !file.good() || (CheckMeshes(textureCount, materialCount) == false))
+	{
+		std::cout << "Invalid baked geometry cache:" << filename << std::endl;
+		m_meshes.clear();
+		return(false);
+	}
+
+	std::cout << "Successfully loaded baked geometry:" << filename << ", meshes:" << m_meshes.size() << std::endl;
+
+	return(true);
+}
+
+/***********************************************************
+ *  WriteCache()
+ *
+ *  This method is used for writing the baked meshes into a
+ *  cache file.
+ ***********************************************************/
+bool StaticGeometry::WriteCache(const char* filename, uint32_t objectsHash) const
+{
+	std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+	if (!file.is_open())
+	{
+		return(false);
+	}
+
+	CACHE_HEADER header;
+	memcpy(header.magic, g_CacheMagic, sizeof(g_CacheMagic));
+	header.version = g_CacheVersion;
+	header.objectsHash = objectsHash;
+	header.meshCount = (uint32_t)m_meshes.size();
+	file.write((const char*)&header, sizeof(header));
+
+	for (const BAKED_MESH& mesh : m_meshes)
+	{
+		CACHE_MESH record;
+		record.textureID = mesh.textureID;
+		record.materialID = mesh.materialID;
+		record.color[0] = mesh.color.r;
+		record.color[1] = mesh.color.g;
+		record.color[2] = mesh.color.b;
+		record.color[3] = mesh.color.a;
+		record.vertexFloatCount = (uint32_t)mesh.vertices.size();
+		record.indexCount = (uint32_t)mesh.indices.size();
+
+		file.write((const char*)&record, sizeof(record));
+		file.write((const char*)mesh.vertices.data(), sizeof(GLfloat) * mesh.vertices.size());
+		file.write((const char*)mesh.indices.data(), sizeof(GLuint) * mesh.indices.size());
+	}
+
+	return(file.good());
+}
+
+/***********************************************************
+ *  CheckMeshes()
+ *
+ *  This method is used for checking the meshes read from
+ *  the cache file before they are added to the arena.  The
+ *  vertices must be whole vertices, the indices must name
+ *  one of them, and the texture and material IDs must be
+ *  -1 or one of the loaded ones.
+ ***********************************************************/
+bool StaticGeometry::CheckMeshes(int textureCount, int materialCount) const
+{
+	for (size_t index = 0; index < m_meshes.size(); index++)
+	{
+		const BAKED_MESH& mesh = m_meshes[index];
+		if (((mesh.vertices.size() % MeshArena::VERTEX_STRIDE) != 0) ||
+			(mesh.textureID < -1) || (mesh.textureID >= textureCount) ||
+			(mesh.materialID < -1) || (mesh.materialID >= materialCount))
+		{
+			std::cout << "Baked mesh is out of range:" << index << std::endl;
+			return(false);
+		}
+
+		const GLuint vertexCount = (GLuint)(mesh.vertices.size() / MeshArena::VERTEX_STRIDE);
+		for (GLuint vertexIndex : mesh.indices)
+		{
+			if (vertexIndex >= vertexCount)
+			{
+				std::cout << "Baked mesh index is out of range:" << index << std::endl;
+				return(false);
+			}
+		}
+	}
+
+	return(true);
+}
@@ -0,0 +1,74 @@
+///////////////////////////////////////////////////////////////////////////////
+// staticgeometry.h
+// ============
+// bake the static scene objects into pre-transformed merged meshes
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "MeshArena.h"
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <vector>
+
+/***********************************************************
+ *  StaticGeometry
+ *
+ *  This class merges the static scene objects that share a
+ *  texture and material (and color, when untextured) into
+ *  one mesh each.  The vertices are transformed into world
+ *  space and the UV scale is applied to the texture
+ *  coordinates, so a baked mesh is drawn with the identity
+ *  model matrix and a UV scale of 1.  The baked meshes can
+ *  be written to a cache file and read back as long as the
+ *  objects they were baked from are unchanged.
+ ***********************************************************/
+class StaticGeometry
+{
+public:
+	// a static object to bake
+	struct BAKE_OBJECT
+	{
+		int meshID;
+		int textureID;
+		int materialID;
+		glm::vec4 color;
+		glm::vec2 uvScale;
+		glm::mat4 modelMatrix;
+	};
+
+	// a merged mesh and the state it is drawn with
+	struct BAKED_MESH
+	{
+		int textureID;
+		int materialID;
+		glm::vec4 color;
+		std::vector<GLfloat> vertices;
+		std::vector<GLuint> indices;
+	};
+
+	// bake the objects with the basic shape meshes of the arena
+	void Bake(const MeshArena& meshArena, const std::vector<BAKE_OBJECT>& objects);
+
+	// hash of the objects to bake, identifies a cache file
+	static uint32_t HashObjects(const std::vector<BAKE_OBJECT>& objects);
+	// read the baked meshes from a cache file made from the
+	// objects with the passed in hash, the IDs in it must be
+	// below the number of loaded textures and materials
+	bool ReadCache(const char* filename, uint32_t objectsHash, int textureCount, int materialCount);
+	// write the baked meshes into a cache file
+	bool WriteCache(const char* filename, uint32_t objectsHash) const;
+
+	const std::vector<BAKED_MESH>& GetMeshes() const { return m_meshes; }
+
+private:
+	std::vector<BAKED_MESH> m_meshes;
+
+	// find the baked mesh an object is merged into, -1 if none
+	int FindMesh(const BAKE_OBJECT& object) const;
+	// check that every ID and index in the meshes is in range
+	bool CheckMeshes(int textureCount, int materialCount) const;
+};
@@ -0,0 +1,270 @@
+///////////////////////////////////////////////////////////////////////////////
+// texturearrays.cpp
+// ============
+// group the scene textures of the same size into 2D texture arrays
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "TextureArrays.h"
+
+#include "stb_image.h"
+
+#include <iostream>
+
+/***********************************************************
+ *  TextureArrays()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+TextureArrays::TextureArrays()
+{
+}
+
+/***********************************************************
+ *  ~TextureArrays()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+TextureArrays::~TextureArrays()
+{
+	FreeImages();
+	Destroy();
+}
+
+/***********************************************************
+ *  LoadImage()
+ *
+ *  This method is used for loading a texture image from an
+ *  image file.  The texture gets its place in the arrays
+ *  when they are built.
+ ***********************************************************/
+bool TextureArrays::LoadImage(const char* filename, const std::string& tag)
+{
+	TEXTURE_INFO texture;
+	texture.tag = tag;
+	texture.location.arrayIndex = -1;
+	texture.location.layer = -1;
+	texture.width = 0;
+	texture.height = 0;
+	texture.colorChannels = 0;
+	texture.bTranslucent = false;
+
+	// indicate to always flip images vertically when loaded
+	stbi_set_flip_vertically_on_load(true);
+
+	// try to parse the image data from the specified image file
+	texture.pImage = stbi_load(
+		filename,
+		&texture.width,
+		&texture.height,
+		&texture.colorChannels,
+		0);
+
+	if (texture.pImage == nullptr)
+	{
+		std::cout << "Could not load image:" << filename << std::endl;
+		return(false);
+	}
+
+	std::cout << "Successfully loaded image:" << filename << ", width:" << texture.width << ", height:" << texture.height << ", channels:" << texture.colorChannels << std::endl;
+
+	// RGB and RGBA images are both stored as RGBA layers
+	if ((texture.colorChannels != 3) && (texture.colorChannels != 4))
+	{
+		std::cout << "Not implemented to handle image with " << texture.colorChannels << " channels" << std::endl;
+		stbi_image_free(texture.pImage);
+		return(false);
+	}
+
+	// draws with the texture are only blended when its alpha
+	// is not opaque everywhere
+	if (texture.colorChannels == 4)
+	{
+		const size_t pixelCount = (size_t)texture.width * (size_t)texture.height;
+		for (size_t pixel = 0; (pixel < pixelCount) && (texture.bTranslucent == false); pixel++)
+		{
+			texture.bTranslucent = (texture.pImage[pixel * 4 + 3] < 255);
+		}
+	}
+
+	m_textureIndices.emplace(tag, (int)m_textures.size());
+	m_textures.push_back(texture);
+
+	return(true);
+}
+
+/***********************************************************
+ *  Build()
+ *
+ *  This method is used for assigning every loaded texture a
+ *  layer in the array of its image size, then creating the
+ *  arrays, uploading the layers and generating the mipmaps.
+ *  An array that reaches the layer limit of the context is
+ *  continued in a new array of the same size.
+ ***********************************************************/
+void TextureArrays::Build()
+{
+	GLint maxLayers = 0;
+	glGetIntegerv(GL_MAX_ARRAY_TEXTURE_LAYERS, &maxLayers);
+
+	// assign the layers, in the order the textures were loaded
+	for (TEXTURE_INFO& texture : m_textures)
+	{
+		if (texture.pImage == nullptr)
+		{
+			continue;
+		}
+
+		int arrayIndex = -1;
+		for (size_t i = 0; (i < m_arrays.size()) && (arrayIndex < 0); i++)
+		{
+			if ((m_arrays[i].ID == 0) &&
+				(m_arrays[i].width == texture.width) &&
+				(m_arrays[i].height == texture.height) &&
+				(m_arrays[i].layerCount < maxLayers))
+			{
+				arrayIndex = (int)i;
+			}
+		}
+		if (arrayIndex < 0)
+		{
+			ARRAY_INFO newArray;
+			newArray.ID = 0;
+			newArray.width = texture.width;
+			newArray.height = texture.height;
+			newArray.layerCount = 0;
+			m_arrays.push_back(newArray);
+			arrayIndex = (int)m_arrays.size() - 1;
+		}
+
+		texture.location.arrayIndex = arrayIndex;
+		texture.location.layer = m_arrays[arrayIndex].layerCount;
+		m_arrays[arrayIndex].layerCount++;
+	}
+
+	// the rows of RGB images are not padded to four bytes
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+	for (size_t i = 0; i < m_arrays.size(); i++)
+	{
+		ARRAY_INFO& textureArray = m_arrays[i];
+		if (textureArray.ID != 0)
+		{
+			continue;
+		}
+
+		glGenTextures(1, &textureArray.ID);
+		glBindTexture(GL_TEXTURE_2D_ARRAY, textureArray.ID);
+
+		// set the texture wrapping parameters
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_REPEAT);
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_REPEAT);
+		// set texture filtering parameters
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+		glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA8,
+			textureArray.width, textureArray.height, textureArray.layerCount,
+			0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+
+		for (const TEXTURE_INFO& texture : m_textures)
+		{
+			if ((texture.pImage == nullptr) || (texture.location.arrayIndex != (int)i))
+			{
+				continue;
+			}
+
+			GLenum format = (texture.colorChannels == 4) ? GL_RGBA : GL_RGB;
+			glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0,
+				0, 0, texture.location.layer,
+				texture.width, texture.height, 1,
+				format, GL_UNSIGNED_BYTE, texture.pImage);
+		}
+
+		// generate the texture mipmaps for mapping textures to lower resolutions
+		glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+		glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+		std::cout << "Created texture array:" << i << ", width:" << textureArray.width << ", height:" << textureArray.height << ", layers:" << textureArray.layerCount << std::endl;
+	}
+
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+	// the image data only lives in the arrays from now on
+	FreeImages();
+
+	GLint maxUnits = 0;
+	glGetIntegerv(GL_MAX_TEXTURE_IMAGE_UNITS, &maxUnits);
+	if ((int)m_arrays.size() > maxUnits)
+	{
+		std::cout << "Texture arrays exceed the texture units:" << m_arrays.size() << " > " << maxUnits << std::endl;
+	}
+}
+
+/***********************************************************
+ *  Bind()
+ *
+ *  This method is used for binding the texture arrays to
+ *  the texture units with the same index.
+ ***********************************************************/
+void TextureArrays::Bind() const
+{
+	for (size_t i = 0; i < m_arrays.size(); i++)
+	{
+		glActiveTexture(GL_TEXTURE0 + (GLenum)i);
+		glBindTexture(GL_TEXTURE_2D_ARRAY, m_arrays[i].ID);
+	}
+	glActiveTexture(GL_TEXTURE0);
+}
+
+/***********************************************************
+ *  Destroy()
+ *
+ *  This method is used for freeing the texture arrays.
+ ***********************************************************/
+void TextureArrays::Destroy()
+{
+	for (ARRAY_INFO& textureArray : m_arrays)
+	{
+		if (textureArray.ID != 0)
+		{
+			glDeleteTextures(1, &textureArray.ID);
+			textureArray.ID = 0;
+		}
+	}
+	m_arrays.clear();
+	m_textures.clear();
+	m_textureIndices.clear();
+}
+
+/***********************************************************
+ *  FindTexture()
+ *
+ *  This method is used for getting the index of the loaded
+ *  texture associated with the passed in tag, with one hash
+ *  lookup.
+ ***********************************************************/
+int TextureArrays::FindTexture(const std::string& tag) const
+{
+	std::unordered_map<std::string, int>::const_iterator found = m_textureIndices.find(tag);
+
+	return((found != m_textureIndices.end()) ? found->second : -1);
+}
+
+/***********************************************************
+ *  FreeImages()
+ *
+ *  This method is used for freeing the decoded images that
+ *  have not been uploaded.
+ ***********************************************************/
+void TextureArrays::FreeImages()
+{
+	for (TEXTURE_INFO& texture : m_textures)
+	{
+		if (texture.pImage != nullptr)
+		{
+			stbi_image_free(texture.pImage);
+			texture.pImage = nullptr;
+		}
+	}
+}
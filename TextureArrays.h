@@ -0,0 +1,97 @@
+///////////////////////////////////////////////////////////////////////////////
+// texturearrays.h
+// ============
+// group the scene textures of the same size into 2D texture arrays
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <GL/glew.h>
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/***********************************************************
+ *  TextureArrays
+ *
+ *  This class loads the scene texture images and stores the
+ *  ones with the same size as the layers of one
+ *  GL_TEXTURE_2D_ARRAY.  Every array stays bound to its own
+ *  texture unit, so a texture is selected by the unit of its
+ *  array and its layer in it.  Textures that share an array
+ *  only differ by the layer, which the shaders read per
+ *  draw, so switching between them changes no GL state.
+ *
+ *  The number of textures is only limited by the number of
+ *  layers an array holds and the texture units needed for
+ *  the distinct image sizes.
+ ***********************************************************/
+class TextureArrays
+{
+public:
+	// constructor
+	TextureArrays();
+	// destructor
+	~TextureArrays();
+
+	// location of a texture in the arrays
+	struct TEXTURE_LAYER
+	{
+		// texture array, and the texture unit it is bound to
+		int arrayIndex;
+		// layer of the texture in its array
+		int layer;
+	};
+
+	// load a texture image and associate it with a tag, the
+	// image is kept in memory until Build()
+	bool LoadImage(const char* filename, const std::string& tag);
+	// create the texture arrays from the loaded images
+	void Build();
+	// bind every texture array to its texture unit
+	void Bind() const;
+	// free the texture arrays
+	void Destroy();
+
+	// find a loaded texture by tag, -1 if there is none
+	int FindTexture(const std::string& tag) const;
+	// get where a loaded texture is stored
+	const TEXTURE_LAYER& GetLayer(int textureIndex) const { return m_textures[textureIndex].location; }
+	// set when some of the texels of a loaded texture are
+	// not fully opaque
+	bool IsTranslucent(int textureIndex) const { return m_textures[textureIndex].bTranslucent; }
+	int GetTextureCount() const { return (int)m_textures.size(); }
+	int GetArrayCount() const { return (int)m_arrays.size(); }
+
+private:
+	struct TEXTURE_INFO
+	{
+		std::string tag;
+		TEXTURE_LAYER location;
+		// decoded image, only until Build()
+		int width;
+		int height;
+		int colorChannels;
+		unsigned char* pImage;
+		// set when an alpha value of the image is below 255
+		bool bTranslucent;
+	};
+
+	struct ARRAY_INFO
+	{
+		GLuint ID;
+		int width;
+		int height;
+		int layerCount;
+	};
+
+	std::vector<TEXTURE_INFO> m_textures;
+	std::vector<ARRAY_INFO> m_arrays;
+	// index of the first texture loaded with every tag
+	std::unordered_map<std::string, int> m_textureIndices;
+
+	// free the decoded images that are still in memory
+	void FreeImages();
+};
@@ -0,0 +1,416 @@
+///////////////////////////////////////////////////////////////////////////////
+// transformarrays.cpp
+// ============
+// scale, rotation and position of the scene nodes in one array per
+// component, composed into matrices several at a time
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "TransformArrays.h"
+
+#include <cmath>
+
+#if defined(__AVX2__)
+#define TRANSFORM_ARRAYS_AVX2
+#include <immintrin.h>
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define TRANSFORM_ARRAYS_SSE2
+#include <emmintrin.h>
+#endif
+
+// declare the global variables
+namespace
+{
+	// degrees to radians, as glm::radians() converts them
+	const float g_RadiansPerDegree = 0.01745329251994329576923690768489f;
+	// quarter turns per radian, and a quarter turn split in
+	// three parts so the reduced angle stays exact
+	const float g_QuartersPerRadian = 0.63661977236758134308f;
+	const float g_QuarterPart1 = 1.5703125f;
+	const float g_QuarterPart2 = 4.837512969970703125e-4f;
+	const float g_QuarterPart3 = 7.54978995489188216e-8f;
+	// polynomials of sin and cos over the reduced angle,
+	// between -pi/4 and pi/4
+	const float g_Sin3 = -1.6666654611e-1f;
+	const float g_Sin5 = 8.3321608736e-3f;
+	const float g_Sin7 = -1.9515295891e-4f;
+	const float g_Cos4 = 4.166664568298827e-2f;
+	const float g_Cos6 = -1.388731625493765e-3f;
+	const float g_Cos8 = 2.443315711809948e-5f;
+
+	/***********************************************************
+	 *  SinCos()
+	 *
+	 *  The sine and cosine of an angle in degrees.  The angle
+	 *  is reduced by whole quarter turns, and the quarter it
+	 *  is in swaps and negates the results of the polynomials.
+	 ***********************************************************/
+	void SinCos(float degrees, float& sine, float& cosine)
+	{
+		const float radians = degrees * g_RadiansPerDegree;
+		const float quarters = std::nearbyint(radians * g_QuartersPerRadian);
+		const int quadrant = (int)quarters;
+
+		const float r = ((radians - quarters * g_QuarterPart1) - quarters * g_QuarterPart2) - quarters * g_QuarterPart3;
+		const float r2 = r * r;
+		const float sinR = r + r * r2 * (g_Sin3 + r2 * (g_Sin5 + r2 * g_Sin7));
+		const float cosR = 1.0f - 0.5f * r2 + r2 * r2 * (g_Cos4 + r2 * (g_Cos6 + r2 * g_Cos8));
+
+		sine = ((quadrant & 1) != 0) ? cosR : sinR;
+		cosine = ((quadrant & 1) != 0) ? sinR : cosR;
+		sine = ((quadrant & 2) != 0) ? -sine : sine;
+		cosine = (((quadrant + 1) & 2) != 0) ? -cosine : cosine;
+	}
+
+#ifdef TRANSFORM_ARRAYS_SSE2
+	/***********************************************************
+	 *  SinCos4()
+	 *
+	 *  SinCos() of four angles in degrees.
+	 ***********************************************************/
+	void SinCos4(__m128 degrees, __m128& sine, __m128& cosine)
+	{
+		const __m128 radians = _mm_mul_ps(degrees, _mm_set1_ps(g_RadiansPerDegree));
+		const __m128i quadrant = _mm_cvtps_epi32(_mm_mul_ps(radians, _mm_set1_ps(g_QuartersPerRadian)));
+		const __m128 quarters = _mm_cvtepi32_ps(quadrant);
+
+		__m128 r = _mm_sub_ps(radians, _mm_mul_ps(quarters, _mm_set1_ps(g_QuarterPart1)));
+		r = _mm_sub_ps(r, _mm_mul_ps(quarters, _mm_set1_ps(g_QuarterPart2)));
+		r = _mm_sub_ps(r, _mm_mul_ps(quarters, _mm_set1_ps(g_QuarterPart3)));
+		const __m128 r2 = _mm_mul_ps(r, r);
+
+		__m128 sinR = _mm_add_ps(_mm_set1_ps(g_Sin5), _mm_mul_ps(r2, _mm_set1_ps(g_Sin7)));
+		sinR = _mm_add_ps(_mm_set1_ps(g_Sin3), _mm_mul_ps(r2, sinR));
+		sinR = _mm_add_ps(r, _mm_mul_ps(_mm_mul_ps(r, r2), sinR));
+		__m128 cosR = _mm_add_ps(_mm_set1_ps(g_Cos6), _mm_mul_ps(r2, _mm_set1_ps(g_Cos8)));
+		cosR = _mm_add_ps(_mm_set1_ps(g_Cos4), _mm_mul_ps(r2, cosR));
+		cosR = _mm_add_ps(
+			_mm_sub_ps(_mm_set1_ps(1.0f), _mm_mul_ps(_mm_set1_ps(0.5f), r2)),
+			_mm_mul_ps(_mm_mul_ps(r2, r2), cosR));
+
+		// odd quarters swap sin and cos, the sign bits come
+		// from the second bit of the quarter
+		const __m128 swap = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(quadrant, _mm_set1_epi32(1)), _mm_set1_epi32(1)));
+		const __m128 sinSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(quadrant, _mm_set1_epi32(2)), 30));
+		const __m128 cosSign = _mm_castsi128_ps(_mm_slli_epi32(
+			_mm_and_si128(_mm_add_epi32(quadrant, _mm_set1_epi32(1)), _mm_set1_epi32(2)), 30));
+
+		sine = _mm_or_ps(_mm_and_ps(swap, cosR), _mm_andnot_ps(swap, sinR));
+		cosine = _mm_or_ps(_mm_and_ps(swap, sinR), _mm_andnot_ps(swap, cosR));
+		sine = _mm_xor_ps(sine, sinSign);
+		cosine = _mm_xor_ps(cosine, cosSign);
+	}
+
+	/***********************************************************
+	 *  StoreColumn4()
+	 *
+	 *  Stores one column of four matrices, passed in as the
+	 *  rows of the column for all four.
+	 ***********************************************************/
+	void StoreColumn4(__m128 x, __m128 y, __m128 z, __m128 w, int column, glm::mat4* matrices)
+	{
+		_MM_TRANSPOSE4_PS(x, y, z, w);
+		_mm_storeu_ps(&matrices[0][column][0], x);
+		_mm_storeu_ps(&matrices[1][column][0], y);
+		_mm_storeu_ps(&matrices[2][column][0], z);
+		_mm_storeu_ps(&matrices[3][column][0], w);
+	}
+#endif
+
+#ifdef TRANSFORM_ARRAYS_AVX2
+	/***********************************************************
+	 *  SinCos8()
+	 *
+	 *  SinCos() of eight angles in degrees.
+	 ***********************************************************/
+	void SinCos8(__m256 degrees, __m256& sine, __m256& cosine)
+	{
+		const __m256 radians = _mm256_mul_ps(degrees, _mm256_set1_ps(g_RadiansPerDegree));
+		const __m256i quadrant = _mm256_cvtps_epi32(_mm256_mul_ps(radians, _mm256_set1_ps(g_QuartersPerRadian)));
+		const __m256 quarters = _mm256_cvtepi32_ps(quadrant);
+
+		__m256 r = _mm256_sub_ps(radians, _mm256_mul_ps(quarters, _mm256_set1_ps(g_QuarterPart1)));
+		r = _mm256_sub_ps(r, _mm256_mul_ps(quarters, _mm256_set1_ps(g_QuarterPart2)));
+		r = _mm256_sub_ps(r, _mm256_mul_ps(quarters, _mm256_set1_ps(g_QuarterPart3)));
+		const __m256 r2 = _mm256_mul_ps(r, r);
+
+		__m256 sinR = _mm256_add_ps(_mm256_set1_ps(g_Sin5), _mm256_mul_ps(r2, _mm256_set1_ps(g_Sin7)));
+		sinR = _mm256_add_ps(_mm256_set1_ps(g_Sin3), _mm256_mul_ps(r2, sinR));
+		sinR = _mm256_add_ps(r, _mm256_mul_ps(_mm256_mul_ps(r, r2), sinR));
+		__m256 cosR = _mm256_add_ps(_mm256_set1_ps(g_Cos6), _mm256_mul_ps(r2, _mm256_set1_ps(g_Cos8)));
+		cosR = _mm256_add_ps(_mm256_set1_ps(g_Cos4), _mm256_mul_ps(r2, cosR));
+		cosR = _mm256_add_ps(
+			_mm256_sub_ps(_mm256_set1_ps(1.0f), _mm256_mul_ps(_mm256_set1_ps(0.5f), r2)),
+			_mm256_mul_ps(_mm256_mul_ps(r2, r2), cosR));
+
+		const __m256 swap = _mm256_castsi256_ps(_mm256_cmpeq_epi32(
+			_mm256_and_si256(quadrant, _mm256_set1_epi32(1)), _mm256_set1_epi32(1)));
+		const __m256 sinSign = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(quadrant, _mm256_set1_epi32(2)), 30));
+		const __m256 cosSign = _mm256_castsi256_ps(_mm256_slli_epi32(
+			_mm256_and_si256(_mm256_add_epi32(quadrant, _mm256_set1_epi32(1)), _mm256_set1_epi32(2)), 30));
+
+		sine = _mm256_xor_ps(_mm256_blendv_ps(sinR, cosR, swap), sinSign);
+		cosine = _mm256_xor_ps(_mm256_blendv_ps(cosR, sinR, swap), cosSign);
+	}
+
+	/***********************************************************
+	 *  StoreColumn8()
+	 *
+	 *  Stores one column of eight matrices, passed in as the
+	 *  rows of the column for all eight.  Every 128-bit lane
+	 *  is transposed on its own, the low lanes hold the first
+	 *  four matrices and the high lanes the last four.
+	 ***********************************************************/
+	void StoreColumn8(__m256 x, __m256 y, __m256 z, __m256 w, int column, glm::mat4* matrices)
+	{
+		const __m256 xyLow = _mm256_unpacklo_ps(x, y);
+		const __m256 xyHigh = _mm256_unpackhi_ps(x, y);
+		const __m256 zwLow = _mm256_unpacklo_ps(z, w);
+		const __m256 zwHigh = _mm256_unpackhi_ps(z, w);
+		const __m256 columns[4] = {
+			_mm256_shuffle_ps(xyLow, zwLow, _MM_SHUFFLE(1, 0, 1, 0)),
+			_mm256_shuffle_ps(xyLow, zwLow, _MM_SHUFFLE(3, 2, 3, 2)),
+			_mm256_shuffle_ps(xyHigh, zwHigh, _MM_SHUFFLE(1, 0, 1, 0)),
+			_mm256_shuffle_ps(xyHigh, zwHigh, _MM_SHUFFLE(3, 2, 3, 2))
+		};
+
+		for (int i = 0; i < 4; i++)
+		{
+			_mm_storeu_ps(&matrices[i][column][0], _mm256_castps256_ps128(columns[i]));
+			_mm_storeu_ps(&matrices[i + 4][column][0], _mm256_extractf128_ps(columns[i], 1));
+		}
+	}
+#endif
+}
+
+/***********************************************************
+ *  TransformArrays()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+TransformArrays::TransformArrays()
+{
+	m_count = 0;
+}
+
+/***********************************************************
+ *  Resize()
+ *
+ *  This method is used for setting the number of transforms.
+ *  The ones past the old count scale by 1 and do not rotate
+ *  or move.
+ ***********************************************************/
+void TransformArrays::Resize(int count)
+{
+	m_count = count;
+	m_scaleX.resize(count, 1.0f);
+	m_scaleY.resize(count, 1.0f);
+	m_scaleZ.resize(count, 1.0f);
+	m_rotationX.resize(count, 0.0f);
+	m_rotationY.resize(count, 0.0f);
+	m_rotationZ.resize(count, 0.0f);
+	m_positionX.resize(count, 0.0f);
+	m_positionY.resize(count, 0.0f);
+	m_positionZ.resize(count, 0.0f);
+}
+
+/***********************************************************
+ *  Set()
+ *
+ *  This method is used for setting the transformation
+ *  values of a node.
+ ***********************************************************/
+void TransformArrays::Set(int index, const glm::vec3& scaleXYZ, const glm::vec3& rotationXYZ, const glm::vec3& positionXYZ)
+{
+	m_scaleX[index] = scaleXYZ.x;
+	m_scaleY[index] = scaleXYZ.y;
+	m_scaleZ[index] = scaleXYZ.z;
+	m_rotationX[index] = rotationXYZ.x;
+	m_rotationY[index] = rotationXYZ.y;
+	m_rotationZ[index] = rotationXYZ.z;
+	m_positionX[index] = positionXYZ.x;
+	m_positionY[index] = positionXYZ.y;
+	m_positionZ[index] = positionXYZ.z;
+}
+
+/***********************************************************
+ *  Move()
+ *
+ *  This method is used for copying the transformation
+ *  values of one node over the ones of another.
+ ***********************************************************/
+void TransformArrays::Move(int from, int to)
+{
+	Set(to, GetScale(from), GetRotation(from), GetPosition(from));
+}
+
+/***********************************************************
+ *  ComposeMatrices()
+ *
+ *  This method is used for building the matrices of a range
+ *  of nodes.  Whole groups of the SIMD width are built
+ *  together, the nodes after the last group one by one.
+ ***********************************************************/
+void TransformArrays::ComposeMatrices(int first, int count, glm::mat4* matrices) const
+{
+	int done = 0;
+
+#ifdef TRANSFORM_ARRAYS_AVX2
+	for (; done + 8 <= count; done += 8)
+	{
+		ComposeGroup8(first + done, matrices + done);
+	}
+#endif
+#ifdef TRANSFORM_ARRAYS_SSE2
+	for (; done + 4 <= count; done += 4)
+	{
+		ComposeGroup4(first + done, matrices + done);
+	}
+#endif
+
+	ComposeMatricesScalar(first + done, count - done, matrices + done);
+}
+
+/***********************************************************
+ *  ComposeMatricesScalar()
+ *
+ *  This method is used for building the matrices of a range
+ *  of nodes one at a time.  The rotation is the product
+ *  rotationX * rotationY * rotationZ written out, and every
+ *  column of it is scaled by the scale along its axis.
+ ***********************************************************/
+void TransformArrays::ComposeMatricesScalar(int first, int count, glm::mat4* matrices) const
+{
+	for (int i = 0; i < count; i++)
+	{
+		const int index = first + i;
+		float sinX, cosX, sinY, cosY, sinZ, cosZ;
+		SinCos(m_rotationX[index], sinX, cosX);
+		SinCos(m_rotationY[index], sinY, cosY);
+		SinCos(m_rotationZ[index], sinZ, cosZ);
+
+		const float scaleX = m_scaleX[index];
+		const float scaleY = m_scaleY[index];
+		const float scaleZ = m_scaleZ[index];
+		const float sinXsinY = sinX * sinY;
+		const float cosXsinY = cosX * sinY;
+
+		glm::mat4& matrix = matrices[i];
+		matrix[0] = glm::vec4(cosY * cosZ * scaleX, (cosX * sinZ + sinXsinY * cosZ) * scaleX, (sinX * sinZ - cosXsinY * cosZ) * scaleX, 0.0f);
+		matrix[1] = glm::vec4(-cosY * sinZ * scaleY, (cosX * cosZ - sinXsinY * sinZ) * scaleY, (sinX * cosZ + cosXsinY * sinZ) * scaleY, 0.0f);
+		matrix[2] = glm::vec4(sinY * scaleZ, -sinX * cosY * scaleZ, cosX * cosY * scaleZ, 0.0f);
+		matrix[3] = glm::vec4(m_positionX[index], m_positionY[index], m_positionZ[index], 1.0f);
+	}
+}
+
+/***********************************************************
+ *  ComposeGroup4()
+ *
+ *  This method is used for building the matrices of four
+ *  nodes with SSE2, one node per lane, the same way as
+ *  ComposeMatricesScalar().
+ ***********************************************************/
+void TransformArrays::ComposeGroup4(int first, glm::mat4* matrices) const
+{
+#ifdef TRANSFORM_ARRAYS_SSE2
+	__m128 sinX, cosX, sinY, cosY, sinZ, cosZ;
+	SinCos4(_mm_loadu_ps(&m_rotationX[first]), sinX, cosX);
+	SinCos4(_mm_loadu_ps(&m_rotationY[first]), sinY, cosY);
+	SinCos4(_mm_loadu_ps(&m_rotationZ[first]), sinZ, cosZ);
+
+	const __m128 scaleX = _mm_loadu_ps(&m_scaleX[first]);
+	const __m128 scaleY = _mm_loadu_ps(&m_scaleY[first]);
+	const __m128 scaleZ = _mm_loadu_ps(&m_scaleZ[first]);
+	const __m128 sinXsinY = _mm_mul_ps(sinX, sinY);
+	const __m128 cosXsinY = _mm_mul_ps(cosX, sinY);
+	const __m128 zero = _mm_setzero_ps();
+
+	StoreColumn4(
+		_mm_mul_ps(_mm_mul_ps(cosY, cosZ), scaleX),
+		_mm_mul_ps(_mm_add_ps(_mm_mul_ps(cosX, sinZ), _mm_mul_ps(sinXsinY, cosZ)), scaleX),
+		_mm_mul_ps(_mm_sub_ps(_mm_mul_ps(sinX, sinZ), _mm_mul_ps(cosXsinY, cosZ)), scaleX),
+		zero, 0, matrices);
+	StoreColumn4(
+		_mm_mul_ps(_mm_mul_ps(_mm_sub_ps(zero, cosY), sinZ), scaleY),
+		_mm_mul_ps(_mm_sub_ps(_mm_mul_ps(cosX, cosZ), _mm_mul_ps(sinXsinY, sinZ)), scaleY),
+		_mm_mul_ps(_mm_add_ps(_mm_mul_ps(sinX, cosZ), _mm_mul_ps(cosXsinY, sinZ)), scaleY),
+		zero, 1, matrices);
+	StoreColumn4(
+		_mm_mul_ps(sinY, scaleZ),
+		_mm_mul_ps(_mm_mul_ps(_mm_sub_ps(zero, sinX), cosY), scaleZ),
+		_mm_mul_ps(_mm_mul_ps(cosX, cosY), scaleZ),
+		zero, 2, matrices);
+	StoreColumn4(
+		_mm_loadu_ps(&m_positionX[first]),
+		_mm_loadu_ps(&m_positionY[first]),
+		_mm_loadu_ps(&m_positionZ[first]),
+		_mm_set1_ps(1.0f), 3, matrices);
+#else
+	ComposeMatricesScalar(first, 4, matrices);
+#endif
+}
+
+/***********************************************************
+ *  ComposeGroup8()
+ *
+ *  This method is used for building the matrices of eight
+ *  nodes with AVX2, one node per lane, the same way as
+ *  ComposeMatricesScalar().
+ ***********************************************************/
+void TransformArrays::ComposeGroup8(int first, glm::mat4* matrices) const
+{
+#ifdef TRANSFORM_ARRAYS_AVX2
+	__m256 sinX, cosX, sinY, cosY, sinZ, cosZ;
+	SinCos8(_mm256_loadu_ps(&m_rotationX[first]), sinX, cosX);
+	SinCos8(_mm256_loadu_ps(&m_rotationY[first]), sinY, cosY);
+	SinCos8(_mm256_loadu_ps(&m_rotationZ[first]), sinZ, cosZ);
+
+	const __m256 scaleX = _mm256_loadu_ps(&m_scaleX[first]);
+	const __m256 scaleY = _mm256_loadu_ps(&m_scaleY[first]);
+	const __m256 scaleZ = _mm256_loadu_ps(&m_scaleZ[first]);
+	const __m256 sinXsinY = _mm256_mul_ps(sinX, sinY);
+	const __m256 cosXsinY = _mm256_mul_ps(cosX, sinY);
+	const __m256 zero = _mm256_setzero_ps();
+
+	StoreColumn8(
+		_mm256_mul_ps(_mm256_mul_ps(cosY, cosZ), scaleX),
+		_mm256_mul_ps(_mm256_add_ps(_mm256_mul_ps(cosX, sinZ), _mm256_mul_ps(sinXsinY, cosZ)), scaleX),
+		_mm256_mul_ps(_mm256_sub_ps(_mm256_mul_ps(sinX, sinZ), _mm256_mul_ps(cosXsinY, cosZ)), scaleX),
+		zero, 0, matrices);
+	StoreColumn8(
+		_mm256_mul_ps(_mm256_mul_ps(_mm256_sub_ps(zero, cosY), sinZ), scaleY),
+		_mm256_mul_ps(_mm256_sub_ps(_mm256_mul_ps(cosX, cosZ), _mm256_mul_ps(sinXsinY, sinZ)), scaleY),
+		_mm256_mul_ps(_mm256_add_ps(_mm256_mul_ps(sinX, cosZ), _mm256_mul_ps(cosXsinY, sinZ)), scaleY),
+		zero, 1, matrices);
+	StoreColumn8(
+		_mm256_mul_ps(sinY, scaleZ),
+		_mm256_mul_ps(_mm256_mul_ps(_mm256_sub_ps(zero, sinX), cosY), scaleZ),
+		_mm256_mul_ps(_mm256_mul_ps(cosX, cosY), scaleZ),
+		zero, 2, matrices);
+	StoreColumn8(
+		_mm256_loadu_ps(&m_positionX[first]),
+		_mm256_loadu_ps(&m_positionY[first]),
+		_mm256_loadu_ps(&m_positionZ[first]),
+		_mm256_set1_ps(1.0f), 3, matrices);
+#else
+	ComposeMatricesScalar(first, 8, matrices);
+#endif
+}
+
+/***********************************************************
+ *  GetKernelName()
+ *
+ *  This method is used for getting the name of the widest
+ *  SIMD path the build composes the matrices with.
+ ***********************************************************/
+const char* TransformArrays::GetKernelName()
+{
+#if defined(TRANSFORM_ARRAYS_AVX2)
+	return("AVX2, 8 wide");
+#elif defined(TRANSFORM_ARRAYS_SSE2)
+	return("SSE2, 4 wide");
+#else
+	return("scalar");
+#endif
+}
@@ -0,0 +1,76 @@
+///////////////////////////////////////////////////////////////////////////////
+// transformarrays.h
+// ============
+// scale, rotation and position of the scene nodes in one array per
+// component, composed into matrices several at a time
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <vector>
+
+/***********************************************************
+ *  TransformArrays
+ *
+ *  This class keeps the transformation values of the scene
+ *  nodes, the scale, the rotation about X, Y and Z in
+ *  degrees and the position, with one array per component.
+ *  ComposeMatrices() builds the matrix
+ *
+ *      translation * rotationX * rotationY * rotationZ * scale
+ *
+ *  of a range of nodes in closed form, straight from the
+ *  sines and cosines of the angles.  With AVX2 eight nodes
+ *  are built at a time, with SSE2 four, and the nodes left
+ *  over one at a time.  The sines and cosines come from the
+ *  same polynomial in every path, so a node gets the same
+ *  matrix whichever path builds it.
+ ***********************************************************/
+class TransformArrays
+{
+public:
+	// constructor
+	TransformArrays();
+
+	// set the number of transforms, keeping the existing ones -
+	// the new ones are the identity
+	void Resize(int count);
+	int GetCount() const { return m_count; }
+
+	// set and get the transformation values of a node
+	void Set(int index, const glm::vec3& scaleXYZ, const glm::vec3& rotationXYZ, const glm::vec3& positionXYZ);
+	glm::vec3 GetScale(int index) const { return glm::vec3(m_scaleX[index], m_scaleY[index], m_scaleZ[index]); }
+	glm::vec3 GetRotation(int index) const { return glm::vec3(m_rotationX[index], m_rotationY[index], m_rotationZ[index]); }
+	glm::vec3 GetPosition(int index) const { return glm::vec3(m_positionX[index], m_positionY[index], m_positionZ[index]); }
+	// copy the values of one node over another, for moving
+	// the last node into the place of a removed one
+	void Move(int from, int to);
+
+	// build the matrices of count nodes from first on, with
+	// the widest SIMD path the build has
+	void ComposeMatrices(int first, int count, glm::mat4* matrices) const;
+	// same matrices one node at a time, without SIMD
+	void ComposeMatricesScalar(int first, int count, glm::mat4* matrices) const;
+	// name of the SIMD path ComposeMatrices() uses
+	static const char* GetKernelName();
+
+private:
+	int m_count;
+	std::vector<float> m_scaleX;
+	std::vector<float> m_scaleY;
+	std::vector<float> m_scaleZ;
+	// rotation about every axis in degrees
+	std::vector<float> m_rotationX;
+	std::vector<float> m_rotationY;
+	std::vector<float> m_rotationZ;
+	std::vector<float> m_positionX;
+	std::vector<float> m_positionY;
+	std::vector<float> m_positionZ;
+
+	// build the matrices of four or eight nodes at once
+	void ComposeGroup4(int first, glm::mat4* matrices) const;
+	void ComposeGroup8(int first, glm::mat4* matrices) const;
+};
@@ -0,0 +1,168 @@
+///////////////////////////////////////////////////////////////////////////////
+// transformbenchmark.cpp
+// ============
+// compare building local matrices with glm one object at a time against
+// the SIMD kernel over the transform arrays
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "TransformBenchmark.h"
+#include "TransformArrays.h"
+
+#include <glm/gtx/transform.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+// declare the global variables
+namespace
+{
+	// object counts the matrices are timed at
+	const int g_ObjectCounts[] = { 1000, 100000, 1000000 };
+	// every timing builds about this many matrices, so the
+	// small counts are repeated until they can be measured
+	const int g_MatricesPerTiming = 4000000;
+	// largest difference to the glm matrix, relative to the
+	// size of the element, that is not a mismatch
+	const float g_MatchTolerance = 1e-4f;
+
+	typedef std::chrono::high_resolution_clock BENCH_CLOCK;
+
+	// transformation values of an object, the way the scene
+	// objects kept them before the transform arrays
+	struct OBJECT_TRANSFORM
+	{
+		glm::vec3 scaleXYZ;
+		glm::vec3 rotationXYZ;
+		glm::vec3 positionXYZ;
+	};
+
+	/***********************************************************
+	 *  NanosecondsSince()
+	 *
+	 *  Nanoseconds passed since the passed in time.
+	 ***********************************************************/
+	double NanosecondsSince(const BENCH_CLOCK::time_point& start)
+	{
+		return(std::chrono::duration<double, std::nano>(BENCH_CLOCK::now() - start).count());
+	}
+
+	/***********************************************************
+	 *  ComposeWithGlm()
+	 *
+	 *  The reference matrix of an object - the translation
+	 *  times the rotations about X, Y and Z times the scale -
+	 *  built from one glm matrix per step, multiplied together.
+	 ***********************************************************/
+	glm::mat4 ComposeWithGlm(const OBJECT_TRANSFORM& transform)
+	{
+		return(glm::translate(transform.positionXYZ) *
+			glm::rotate(glm::radians(transform.rotationXYZ.x), glm::vec3(1.0f, 0.0f, 0.0f)) *
+			glm::rotate(glm::radians(transform.rotationXYZ.y), glm::vec3(0.0f, 1.0f, 0.0f)) *
+			glm::rotate(glm::radians(transform.rotationXYZ.z), glm::vec3(0.0f, 0.0f, 1.0f)) *
+			glm::scale(transform.scaleXYZ));
+	}
+
+	/***********************************************************
+	 *  CountMismatches()
+	 *
+	 *  The number of matrices that differ from the glm matrix
+	 *  of their object by more than the tolerance.
+	 ***********************************************************/
+	int CountMismatches(const std::vector<OBJECT_TRANSFORM>& transforms, const std::vector<glm::mat4>& matrices)
+	{
+		int mismatches = 0;
+		for (size_t i = 0; i < transforms.size(); i++)
+		{
+			const glm::mat4 expected = ComposeWithGlm(transforms[i]);
+			bool bMatch = true;
+			for (int column = 0; column < 4; column++)
+			{
+				for (int row = 0; row < 4; row++)
+				{
+					const float difference = std::fabs(matrices[i][column][row] - expected[column][row]);
+					bMatch = bMatch && (difference <= g_MatchTolerance * std::max(1.0f, std::fabs(expected[column][row])));
+				}
+			}
+			mismatches += (bMatch == false) ? 1 : 0;
+		}
+
+		return(mismatches);
+	}
+}
+
+/***********************************************************
+ *  RunTransformBenchmark()
+ *
+ *  Builds the local matrices of growing numbers of random
+ *  objects three ways - with glm from the values kept per
+ *  object, as the scene manager did, and with the scalar
+ *  and SIMD kernels of the transform arrays.  The matrices
+ *  of both kernels are checked against the glm ones.
+ ***********************************************************/
+void RunTransformBenchmark()
+{
+	std::mt19937 random(330);
+	std::uniform_real_distribution<float> scale(0.1f, 4.0f);
+	std::uniform_real_distribution<float> rotation(-360.0f, 360.0f);
+	std::uniform_real_distribution<float> position(-100.0f, 100.0f);
+
+	std::cout << "kernel: " << TransformArrays::GetKernelName() << std::endl;
+	std::cout << "objects  | glm / scalar / simd (ns per matrix)  | simd speedup  | mismatches scalar/simd" << std::endl;
+
+	for (int objectCount : g_ObjectCounts)
+	{
+		std::vector<OBJECT_TRANSFORM> transforms(objectCount);
+		TransformArrays transformArrays;
+		transformArrays.Resize(objectCount);
+		for (int i = 0; i < objectCount; i++)
+		{
+			OBJECT_TRANSFORM& transform = transforms[i];
+			transform.scaleXYZ = glm::vec3(scale(random), scale(random), scale(random));
+			transform.rotationXYZ = glm::vec3(rotation(random), rotation(random), rotation(random));
+			transform.positionXYZ = glm::vec3(position(random), position(random), position(random));
+			transformArrays.Set(i, transform.scaleXYZ, transform.rotationXYZ, transform.positionXYZ);
+		}
+
+		const int repeats = std::max(1, g_MatricesPerTiming / objectCount);
+		const double matrixCount = (double)repeats * objectCount;
+		std::vector<glm::mat4> matrices(objectCount);
+
+		BENCH_CLOCK::time_point start = BENCH_CLOCK::now();
+		for (int repeat = 0; repeat < repeats; repeat++)
+		{
+			for (int i = 0; i < objectCount; i++)
+			{
+				matrices[i] = ComposeWithGlm(transforms[i]);
+			}
+		}
+		const double glmTime = NanosecondsSince(start) / matrixCount;
+
+		start = BENCH_CLOCK::now();
+		for (int repeat = 0; repeat < repeats; repeat++)
+		{
+			transformArrays.ComposeMatricesScalar(0, objectCount, matrices.data());
+		}
+		const double scalarTime = NanosecondsSince(start) / matrixCount;
+		const int scalarMismatches = CountMismatches(transforms, matrices);
+
+		start = BENCH_CLOCK::now();
+		for (int repeat = 0; repeat < repeats; repeat++)
+		{
+			transformArrays.ComposeMatrices(0, objectCount, matrices.data());
+		}
+		const double simdTime = NanosecondsSince(start) / matrixCount;
+		const int simdMismatches = CountMismatches(transforms, matrices);
+
+		std::cout << std::fixed << std::setprecision(2)
+			<< std::setw(7) << objectCount << "  | "
+			<< std::setw(7) << glmTime << " / " << std::setw(6) << scalarTime << " / " << std::setw(6) << simdTime << "  | "
+			<< std::setw(11) << (glmTime / simdTime) << "x  | "
+			<< scalarMismatches << " / " << simdMismatches << std::endl;
+	}
+}
@@ -0,0 +1,13 @@
+///////////////////////////////////////////////////////////////////////////////
+// transformbenchmark.h
+// ============
+// compare building local matrices with glm one object at a time against
+// the SIMD kernel over the transform arrays
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+// run the benchmark and print the timings to the console,
+// started with the --transform-benchmark command line argument
+void RunTransformBenchmark();
@@ -0,0 +1,76 @@
+///////////////////////////////////////////////////////////////////////////////
+// uniformbuffer.cpp
+// ============
+// manage an OpenGL uniform buffer object bound to a uniform block
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "UniformBuffer.h"
+
+/***********************************************************
+ *  UniformBuffer()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+UniformBuffer::UniformBuffer()
+{
+	m_bufferID = 0;
+	m_bindingPoint = 0;
+	m_size = 0;
+}
+
+/***********************************************************
+ *  ~UniformBuffer()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+UniformBuffer::~UniformBuffer()
+{
+	if (m_bufferID != 0)
+	{
+		glDeleteBuffers(1, &m_bufferID);
+		m_bufferID = 0;
+	}
+}
+
+/***********************************************************
+ *  Create()
+ *
+ *  This method is used for creating the buffer storage,
+ *  optionally filled with the passed in data, and binding
+ *  the buffer to its uniform block binding point.
+ ***********************************************************/
+void UniformBuffer::Create(GLuint bindingPoint, GLsizeiptr size, const void* data)
+{
+	if (m_bufferID == 0)
+	{
+		glGenBuffers(1, &m_bufferID);
+	}
+
+	m_bindingPoint = bindingPoint;
+	m_size = size;
+
+	glBindBuffer(GL_UNIFORM_BUFFER, m_bufferID);
+	glBufferData(GL_UNIFORM_BUFFER, size, data, GL_DYNAMIC_DRAW);
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+	glBindBufferBase(GL_UNIFORM_BUFFER, m_bindingPoint, m_bufferID);
+}
+
+/***********************************************************
+ *  Update()
+ *
+ *  This method is used for uploading a byte range of the
+ *  buffer, the rest of the buffer keeps its contents.
+ ***********************************************************/
+void UniformBuffer::Update(GLintptr offset, GLsizeiptr size, const void* data)
+{
+	if ((m_bufferID == 0) || (size <= 0))
+	{
+		return;
+	}
+
+	glBindBuffer(GL_UNIFORM_BUFFER, m_bufferID);
+	glBufferSubData(GL_UNIFORM_BUFFER, offset, size, data);
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
@@ -0,0 +1,40 @@
+///////////////////////////////////////////////////////////////////////////////
+// uniformbuffer.h
+// ============
+// manage an OpenGL uniform buffer object bound to a uniform block
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <GL/glew.h>
+
+/***********************************************************
+ *  UniformBuffer
+ *
+ *  This class owns a uniform buffer object that is bound to
+ *  a fixed binding point, so every shader uniform block
+ *  assigned to that binding point reads from it.  The data
+ *  layout is up to the caller and has to follow std140.
+ ***********************************************************/
+class UniformBuffer
+{
+public:
+	// constructor
+	UniformBuffer();
+	// destructor
+	~UniformBuffer();
+
+	// create the buffer with a size in bytes and bind it
+	void Create(GLuint bindingPoint, GLsizeiptr size, const void* data);
+	// upload part of the buffer
+	void Update(GLintptr offset, GLsizeiptr size, const void* data);
+
+	GLuint GetBindingPoint() const { return m_bindingPoint; }
+	GLsizeiptr GetSize() const { return m_size; }
+
+private:
+	GLuint m_bufferID;
+	GLuint m_bindingPoint;
+	GLsizeiptr m_size;
+};
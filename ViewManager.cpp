@@ -24,6 +24,7 @@ namespace
     const int WINDOW_HEIGHT = 800;
     const char* g_ViewName = "view";
     const char* g_ProjectionName = "projection";
+    const char* g_ViewPositionName = "viewPosition";
 
     // Camera object used for viewing and interacting with the 3D scene
     Camera* g_pCamera = nullptr;
@@ -54,6 +55,13 @@ ViewManager::ViewManager(ShaderManager* pShaderManager)
 {
     // Initialize member variables
     m_pShaderManager = pShaderManager;
+    m_pShaderUniforms = nullptr;
+    m_viewHandle = -1;
+    m_projectionHandle = -1;
+    m_viewPositionHandle = -1;
+    m_view = glm::mat4(1.0f);
+    m_projection = glm::mat4(1.0f);
+    m_bDepthPrepass = false;
     m_pWindow = nullptr;
     g_pCamera = new Camera();
 
@@ -73,6 +81,7 @@ ViewManager::~ViewManager()
 {
     // Free up allocated memory
     m_pShaderManager = nullptr;
+    m_pShaderUniforms = nullptr;
     m_pWindow = nullptr;
 
     if (g_pCamera != nullptr)
@@ -106,22 +115,42 @@ GLFWwindow* ViewManager::CreateDisplayWindow(const char* windowTitle)
     glfwSetCursorPosCallback(window, ViewManager::Mouse_Position_Callback);
     glfwSetScrollCallback(window, ViewManager::Mouse_Scroll_Wheel_Callback);
 
-    // Enable blending for transparent rendering
-    glEnable(GL_BLEND);
+    // Blend function for transparent rendering, blending itself
+    // is only enabled by the scene for its transparent pass
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
     m_pWindow = window;
     return window;
 }
 
+/***********************************************************
+ *  SetShaderUniforms()
+ *
+ *  Sets the reflected shader uniforms and gets the handles
+ *  of the uniforms that are set for every frame.
+ ***********************************************************/
+void ViewManager::SetShaderUniforms(ShaderUniforms* pShaderUniforms)
+{
+    m_pShaderUniforms = pShaderUniforms;
+
+    m_viewHandle = m_pShaderUniforms->GetHandle(g_ViewName);
+    m_projectionHandle = m_pShaderUniforms->GetHandle(g_ProjectionName);
+    m_viewPositionHandle = m_pShaderUniforms->GetHandle(g_ViewPositionName);
+}
+
 /***********************************************************
  *  Window_Resize_Callback()
  *
  *  Callback function for handling window resize events.
+ *  When the context is owned by the render thread, the
+ *  viewport is set there from the framebuffer size.
  ***********************************************************/
 void ViewManager::Window_Resize_Callback(GLFWwindow* window, int width, int height)
 {
-    glViewport(0, 0, width, height);
+    if (glfwGetCurrentContext() == window)
+    {
+        glViewport(0, 0, width, height);
+    }
 }
 
 /***********************************************************
@@ -227,6 +256,16 @@ void ViewManager::ProcessKeyboardEvents()
     {
         bOrthographicProjection = true;
     }
+
+    // Toggle the depth pre-pass (Z to enable, X to disable)
+    if (glfwGetKey(m_pWindow, GLFW_KEY_Z) == GLFW_PRESS)
+    {
+        m_bDepthPrepass = true;
+    }
+    if (glfwGetKey(m_pWindow, GLFW_KEY_X) == GLFW_PRESS)
+    {
+        m_bDepthPrepass = false;
+    }
 }
 
 /***********************************************************
@@ -237,6 +276,19 @@ void ViewManager::ProcessKeyboardEvents()
  *  the chosen projection mode (perspective or orthographic).
  ***********************************************************/
 void ViewManager::PrepareSceneView()
+{
+    UpdateSceneView();
+    SetViewUniforms(m_view, m_projection, GetViewPosition());
+}
+
+/***********************************************************
+ *  UpdateSceneView()
+ *
+ *  Moves the camera with the input of the frame and
+ *  calculates the view and projection matrices, without
+ *  setting them into the shader.
+ ***********************************************************/
+void ViewManager::UpdateSceneView()
 {
     glm::mat4 view;
     glm::mat4 projection;
@@ -264,11 +316,34 @@ void ViewManager::PrepareSceneView()
         projection = glm::perspective(glm::radians(g_pCamera->Zoom), (GLfloat)WINDOW_WIDTH / (GLfloat)WINDOW_HEIGHT, 0.1f, 100.0f);
     }
 
-    // If the shader manager is valid, set the view and projection matrices in the shader
-    if (m_pShaderManager != nullptr)
+    // keep the matrices of the prepared scene view
+    m_view = view;
+    m_projection = projection;
+}
+
+/***********************************************************
+ *  SetViewUniforms()
+ *
+ *  Sets the view and projection matrices and the camera
+ *  position in the shader.
+ ***********************************************************/
+void ViewManager::SetViewUniforms(const glm::mat4& view, const glm::mat4& projection, const glm::vec3& viewPosition)
+{
+    // If the shader uniforms are valid, set the view and projection matrices in the shader
+    if (m_pShaderUniforms != nullptr)
     {
-        m_pShaderManager->setMat4Value(g_ViewName, view);
-        m_pShaderManager->setMat4Value(g_ProjectionName, projection);
-        m_pShaderManager->setVec3Value("viewPosition", g_pCamera->Position);
+        m_pShaderUniforms->setMat4Value(m_viewHandle, view);
+        m_pShaderUniforms->setMat4Value(m_projectionHandle, projection);
+        m_pShaderUniforms->setVec3Value(m_viewPositionHandle, viewPosition);
     }
+}
+
+/***********************************************************
+ *  GetViewPosition()
+ *
+ *  Gets the position of the camera.
+ ***********************************************************/
+glm::vec3 ViewManager::GetViewPosition() const
+{
+    return (g_pCamera != nullptr) ? g_pCamera->Position : glm::vec3(0.0f);
 }
\ No newline at end of file
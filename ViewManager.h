@@ -10,6 +10,7 @@
 #pragma once
 
 #include "ShaderManager.h"
+#include "ShaderUniforms.h"
 #include "camera.h"
 
 // GLFW library
@@ -34,6 +35,17 @@ public:
 private:
 	// pointer to shader manager object
 	ShaderManager* m_pShaderManager;
+	// pointer to the reflected shader uniforms
+	ShaderUniforms* m_pShaderUniforms;
+	// handles of the uniforms set for every frame
+	int m_viewHandle;
+	int m_projectionHandle;
+	int m_viewPositionHandle;
+	// view and projection matrices of the current frame
+	glm::mat4 m_view;
+	glm::mat4 m_projection;
+	// set when the scene is drawn with a depth pre-pass
+	bool m_bDepthPrepass;
 	// active OpenGL display window
 	GLFWwindow* m_pWindow;
 
@@ -44,6 +56,20 @@ public:
 	// create the initial OpenGL display window
 	GLFWwindow* CreateDisplayWindow(const char* windowTitle);
 
+	// set the reflected shader uniforms once the shaders are loaded
+	void SetShaderUniforms(ShaderUniforms* pShaderUniforms);
+
 	// prepare the conversion from 3D object display to 2D scene display
 	void PrepareSceneView();
+	// the two halves of PrepareSceneView() - moving the camera
+	// with the input, which makes no GL calls and runs on the
+	// update thread, and setting a camera into the shader
+	void UpdateSceneView();
+	void SetViewUniforms(const glm::mat4& view, const glm::mat4& projection, const glm::vec3& viewPosition);
+	// matrices of the last prepared scene view
+	const glm::mat4& GetViewMatrix() const { return m_view; }
+	const glm::mat4& GetProjectionMatrix() const { return m_projection; }
+	glm::vec3 GetViewPosition() const;
+	// check if the depth pre-pass was switched on with the keys
+	bool IsDepthPrepassEnabled() const { return m_bDepthPrepass; }
 };
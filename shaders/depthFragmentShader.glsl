@@ -0,0 +1,11 @@
+///////////////////////////////////////////////////////////////////////////////
+// depthFragmentShader.glsl
+// ============
+// depth pre-pass - the color writes are off, only the depth is kept
+///////////////////////////////////////////////////////////////////////////////
+
+#version 330 core
+
+void main()
+{
+}
@@ -0,0 +1,36 @@
+///////////////////////////////////////////////////////////////////////////////
+// depthVertexShader.glsl
+// ============
+// transform the scene vertices for the depth pre-pass - only the position
+// stream and the per-draw model matrix of the mesh arena are read. the
+// position is computed with exactly the statements of vertexShader.glsl,
+// keep the two the same
+///////////////////////////////////////////////////////////////////////////////
+
+#version 330 core
+
+layout (location = 0) in vec3 inVertexPosition;
+// per-draw model matrix, from the mesh arena draw data
+layout (location = 3) in mat4 inInstanceModel;
+
+// the shading pass tests its depth for equality against this
+// pass, invariance only holds when both reach the position
+// through the same data and control flow
+invariant gl_Position;
+
+uniform mat4 model;
+uniform mat4 view;
+uniform mat4 projection;
+uniform bool bUseInstancing = false;
+
+void main()
+{
+	mat4 modelMatrix = model;
+	if (bUseInstancing == true)
+	{
+		modelMatrix = inInstanceModel;
+	}
+
+	// transform the vertex into clip coordinates
+	gl_Position = projection * view * modelMatrix * vec4(inVertexPosition, 1.0f);
+}
@@ -0,0 +1,186 @@
+///////////////////////////////////////////////////////////////////////////////
+// fragmentShader.glsl
+// ============
+// shade the scene fragments with the object color or texture and the
+// Phong lighting from the scene light sources
+//
+// this shader replaces the course fragment shader that was loaded from
+// ../../Utilities/shaders, which is not part of this tree. the shading was
+// written again from the uniforms the scene sets, not copied, so it has
+// not been checked against the course shader. every light adds
+//     ambient  = light ambient * material ambient * ambientStrength
+//     diffuse  = max(N.L, 0) * light diffuse * material diffuse
+//     specular = specularIntensity * focalStrength * max(R.V, 0)^shininess
+//                * light specular * material specular
+// and the sum scales the rgb of the base color, its alpha is kept
+///////////////////////////////////////////////////////////////////////////////
+
+#version 330 core
+
+struct Material
+{
+	vec3 ambientColor;
+	float ambientStrength;
+	vec3 diffuseColor;
+	vec3 specularColor;
+	float shininess;
+};
+
+struct LightSource
+{
+	vec3 position;
+	vec3 ambientColor;
+	vec3 diffuseColor;
+	vec3 specularColor;
+	float focalStrength;
+	float specularIntensity;
+};
+
+#define MAX_LIGHTS 128
+#define MAX_MATERIALS 256
+
+// std140 copy of a LightSource, packed into four vec4 rows
+struct LightData
+{
+	vec4 positionFocalStrength;
+	vec4 ambientColorIntensity;
+	vec4 diffuseColor;
+	vec4 specularColor;
+};
+
+// std140 copy of a Material, packed into three vec4 rows
+struct MaterialData
+{
+	vec4 ambientColorStrength;
+	vec4 diffuseColorShininess;
+	vec4 specularColor;
+};
+
+in vec3 fragmentPosition;
+in vec3 fragmentVertexNormal;
+in vec2 fragmentTextureCoordinate;
+flat in vec4 fragmentInstanceColor;
+flat in vec2 fragmentUVScale;
+flat in int fragmentMaterialIndex;
+flat in int fragmentTextureLayer;
+
+out vec4 outFragmentColor;
+
+uniform bool bUseTexture = false;
+uniform bool bUseLighting = false;
+uniform bool bUseInstancing = false;
+uniform vec4 objectColor = vec4(1.0f);
+// texture array of the object texture, the layer comes with the vertices
+uniform sampler2DArray objectTexture;
+uniform vec3 viewPosition;
+
+// the scene light sources, only the changed lights are
+// uploaded again
+layout (std140) uniform LightBlock
+{
+	ivec4 lightCount;
+	LightData lights[MAX_LIGHTS];
+};
+
+// every defined material, uploaded once when the scene is prepared
+layout (std140) uniform MaterialBlock
+{
+	MaterialData materials[MAX_MATERIALS];
+};
+
+/***********************************************************
+ *  GetMaterial()
+ *
+ *  Unpack the material of the current draw from the
+ *  material block.
+ ***********************************************************/
+Material GetMaterial()
+{
+	MaterialData data = materials[fragmentMaterialIndex];
+	Material material;
+
+	material.ambientColor = data.ambientColorStrength.xyz;
+	material.ambientStrength = data.ambientColorStrength.w;
+	material.diffuseColor = data.diffuseColorShininess.xyz;
+	material.shininess = data.diffuseColorShininess.w;
+	material.specularColor = data.specularColor.xyz;
+
+	return(material);
+}
+
+/***********************************************************
+ *  GetLightSource()
+ *
+ *  Unpack a light source from the light block.
+ ***********************************************************/
+LightSource GetLightSource(int index)
+{
+	LightData data = lights[index];
+	LightSource light;
+
+	light.position = data.positionFocalStrength.xyz;
+	light.focalStrength = data.positionFocalStrength.w;
+	light.ambientColor = data.ambientColorIntensity.xyz;
+	light.specularIntensity = data.ambientColorIntensity.w;
+	light.diffuseColor = data.diffuseColor.xyz;
+	light.specularColor = data.specularColor.xyz;
+
+	return(light);
+}
+
+/***********************************************************
+ *  CalcLightSource()
+ *
+ *  Calculate the ambient, diffuse and specular contribution
+ *  of one light source.
+ ***********************************************************/
+vec3 CalcLightSource(LightSource light, Material material, vec3 lightNormal, vec3 vertexPosition, vec3 viewDirection)
+{
+	// ambient lighting
+	vec3 ambient = light.ambientColor * material.ambientColor * material.ambientStrength;
+
+	// diffuse lighting
+	vec3 lightDirection = normalize(light.position - vertexPosition);
+	float impact = max(dot(lightNormal, lightDirection), 0.0f);
+	vec3 diffuse = impact * light.diffuseColor * material.diffuseColor;
+
+	// specular lighting
+	vec3 reflectDirection = reflect(-lightDirection, lightNormal);
+	float specularComponent = pow(max(dot(viewDirection, reflectDirection), 0.0f), max(material.shininess, 1.0f));
+	vec3 specular = light.specularIntensity * light.focalStrength * specularComponent * light.specularColor * material.specularColor;
+
+	return(ambient + diffuse + specular);
+}
+
+void main()
+{
+	vec4 baseColor = objectColor;
+	if (bUseInstancing == true)
+	{
+		baseColor = fragmentInstanceColor;
+	}
+	if (bUseTexture == true)
+	{
+		baseColor = texture(objectTexture, vec3(fragmentTextureCoordinate * fragmentUVScale, fragmentTextureLayer));
+	}
+
+	if (bUseLighting == true)
+	{
+		vec3 lightNormal = normalize(fragmentVertexNormal);
+		vec3 viewDirection = normalize(viewPosition - fragmentPosition);
+		vec3 phongResult = vec3(0.0f);
+		Material material = GetMaterial();
+
+		int totalLights = min(lightCount.x, MAX_LIGHTS);
+		for (int i = 0; i < totalLights; i++)
+		{
+			phongResult += CalcLightSource(GetLightSource(i), material, lightNormal, fragmentPosition, viewDirection);
+		}
+
+		outFragmentColor = vec4(phongResult * baseColor.xyz, baseColor.w);
+	}
+	else
+	{
+		outFragmentColor = baseColor;
+	}
+}
@@ -0,0 +1,78 @@
+///////////////////////////////////////////////////////////////////////////////
+// vertexShader.glsl
+// ============
+// transform the scene vertices - the model matrix comes either from the
+// "model" uniform or, for instanced draws, from the per-instance attributes.
+// multi-draw indirect draws also read their UV scale, material and texture
+// layer from the per-instance attributes
+//
+// this shader replaces the course vertex shader that was loaded from
+// ../../Utilities/shaders, which is not part of this tree. it was written
+// again, not copied: the clip position, the world-space position and the
+// normal through the inverse transpose of the model matrix are the usual
+// ones, and the rest is the instancing and draw data switches
+///////////////////////////////////////////////////////////////////////////////
+
+#version 330 core
+
+layout (location = 0) in vec3 inVertexPosition;
+layout (location = 1) in vec3 inVertexNormal;
+layout (location = 2) in vec2 inTextureCoordinate;
+
+// per-instance attributes, only enabled on instanced mesh buffers
+layout (location = 3) in mat4 inInstanceModel;
+layout (location = 7) in vec4 inInstanceColor;
+// per-draw attributes, only enabled on the mesh arena buffers
+layout (location = 8) in vec2 inDrawUVScale;
+layout (location = 9) in int inDrawMaterialIndex;
+layout (location = 10) in int inDrawTextureLayer;
+
+out vec3 fragmentPosition;
+out vec3 fragmentVertexNormal;
+out vec2 fragmentTextureCoordinate;
+flat out vec4 fragmentInstanceColor;
+flat out vec2 fragmentUVScale;
+flat out int fragmentMaterialIndex;
+flat out int fragmentTextureLayer;
+
+// the depth pre-pass computes the position with the same
+// statements, so the depth of this pass can be tested for
+// equality against it - keep depthVertexShader.glsl the same
+invariant gl_Position;
+
+uniform mat4 model;
+uniform mat4 view;
+uniform mat4 projection;
+uniform bool bUseInstancing = false;
+uniform bool bUseDrawData = false;
+uniform vec2 UVscale = vec2(1.0f, 1.0f);
+uniform int materialIndex = 0;
+uniform int textureLayer = 0;
+
+void main()
+{
+	mat4 modelMatrix = model;
+	if (bUseInstancing == true)
+	{
+		modelMatrix = inInstanceModel;
+	}
+
+	// transform the vertex into clip coordinates
+	gl_Position = projection * view * modelMatrix * vec4(inVertexPosition, 1.0f);
+
+	// world space position and normal for the lighting calculations
+	fragmentPosition = vec3(modelMatrix * vec4(inVertexPosition, 1.0f));
+	fragmentVertexNormal = mat3(transpose(inverse(modelMatrix))) * inVertexNormal;
+	fragmentTextureCoordinate = inTextureCoordinate;
+	fragmentInstanceColor = inInstanceColor;
+
+	fragmentUVScale = UVscale;
+	fragmentMaterialIndex = materialIndex;
+	fragmentTextureLayer = textureLayer;
+	if (bUseDrawData == true)
+	{
+		fragmentUVScale = inDrawUVScale;
+		fragmentMaterialIndex = inDrawMaterialIndex;
+		fragmentTextureLayer = inDrawTextureLayer;
+	}
+}